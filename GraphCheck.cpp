@@ -0,0 +1,1238 @@
+/*
+ * File: GraphCheck.cpp
+ * --------------------
+ * This program checks the graph engines against brute-force references on small random graphs:
+ * breadth-first distances for the traversal indexes, all pairs of paths for betweenness and the
+ * diameter, peeling for the core numbers and removal tests for articulation points and bridges.
+ * The engines run on a shared pool of several threads, because their parallel paths can only go
+ * wrong under concurrency. Every check prints one line, and the program exits with status 1 if any
+ * graph fails.
+ *
+ * Usage: GraphCheck [--trials n] [--seed n] [--threads n] [--max-nodes n]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "biconnected.h"
+#include "centrality.h"
+#include "coloring.h"
+#include "communities.h"
+#include "components.h"
+#include "connectivity.h"
+#include "cores.h"
+#include "csrgraph.h"
+#include "diameter.h"
+#include "error.h"
+#include "hoplabels.h"
+#include "hyperanf.h"
+#include "neighborhood.h"
+#include "pagerank.h"
+#include "randomwalk.h"
+#include "reachability.h"
+#include "shortestpath.h"
+#include "threadpool.h"
+#include "triangles.h"
+
+typedef std::vector<std::vector<int> > HopMatrix;
+typedef std::vector<std::vector<double> > CostMatrix;
+typedef std::vector<std::vector<char> > Adjacency;
+
+/*
+ * Type: TestGraph
+ * ---------------
+ * One random graph together with the references that several checks share. graph may have loops and
+ * parallel arcs; undirected is the simple undirected graph underlying it, and adjacency the same
+ * graph as a matrix built without the library. hops and undirectedHops hold the distances between
+ * all pairs, or -1 for unreachable pairs, and costs the cheapest path costs, or -1.
+ */
+
+struct TestGraph
+{
+    CSRGraph graph;
+    CSRGraph undirected;
+    bool symmetric;                             /* Every arc of graph has a reverse arc */
+    Adjacency adjacency;
+    HopMatrix hops;
+    HopMatrix undirectedHops;
+    CostMatrix costs;
+};
+
+/*
+ * Type: Check
+ * -----------
+ * A named check. The function returns an empty string if the engine agrees with the reference on
+ * the graph, and a description of the first difference otherwise.
+ */
+
+struct Check
+{
+    const char * name;
+    std::function<std::string(const TestGraph &)> run;
+};
+
+/*
+ * Class: Failure
+ * Usage: return Failure()<<"node "<<v;
+ * ------------------------------------
+ * Starts a failure message; the stream converts to the string a check returns.
+ */
+
+class Failure
+{
+public:
+    template <typename T>
+    Failure & operator<<(const T & value)
+    {
+        out<<value;
+        return *this;
+    }
+
+    operator std::string() const
+    {
+        return out.str();
+    }
+
+private:
+    std::ostringstream out;
+};
+
+static bool near(double a,double b,double tolerance=1e-9)
+{
+    return std::fabs(a-b)<=tolerance*std::max(1.0,std::max(std::fabs(a),std::fabs(b)));
+}
+
+static bool hasArc(const CSRGraph & graph,uint32_t u,uint32_t v)
+{
+    for (size_t i=graph.offsets[u];i<graph.offsets[u+1];i++)
+    {
+        if (graph.targets[i]==v) return true;
+    }
+    return false;
+}
+
+/*
+ * Section: references
+ * -------------------
+ * The functions below compute the expected answers directly from the definitions, in quadratic or
+ * cubic time, without using any engine.
+ */
+
+static std::vector<int> bfsHops(const CSRGraph & graph,uint32_t source)
+{
+    std::vector<int> distance(graph.nodeCount,-1);
+    std::vector<uint32_t> queue(1,source);
+
+    distance[source]=0;
+    for (size_t head=0;head<queue.size();head++)
+    {
+        uint32_t v=queue[head];
+
+        for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+
+            if (distance[t]<0)
+            {
+                distance[t]=distance[v]+1;
+                queue.push_back(t);
+            }
+        }
+    }
+    return distance;
+}
+
+static CostMatrix floydWarshall(const CSRGraph & graph,bool weighted)
+{
+    size_t n=graph.nodeCount;
+    CostMatrix d(n,std::vector<double>(n,-1));
+
+    for (size_t v=0;v<n;v++)
+    {
+        d[v][v]=0;
+        for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+            double c=weighted ? graph.costs[i] : 1.0;
+
+            if (t!=v&&(d[v][t]<0||c<d[v][t])) d[v][t]=c;
+        }
+    }
+    for (size_t k=0;k<n;k++)
+    {
+        for (size_t i=0;i<n;i++)
+        {
+            if (d[i][k]<0) continue;
+            for (size_t j=0;j<n;j++)
+            {
+                if (d[k][j]>=0&&(d[i][j]<0||d[i][k]+d[k][j]<d[i][j])) d[i][j]=d[i][k]+d[k][j];
+            }
+        }
+    }
+    return d;
+}
+
+/*
+ * Function: componentLabels
+ * Usage: size_t count=componentLabels(adjacency,removed,label);
+ * -------------------------------------------------------------
+ * Labels the connected components of the undirected graph adjacency without the node removed (or
+ * without any node if removed is NO_NODE) by their smallest node. removed gets the label NO_NODE.
+ */
+
+static size_t componentLabels(const Adjacency & adjacency,uint32_t removed,
+                              std::vector<uint32_t> & label)
+{
+    size_t n=adjacency.size();
+    size_t count=0;
+
+    label.assign(n,NO_NODE);
+    for (uint32_t root=0;root<n;root++)
+    {
+        if (root==removed||label[root]!=NO_NODE) continue;
+
+        std::vector<uint32_t> stack(1,root);
+
+        label[root]=root;
+        count++;
+        while (!stack.empty())
+        {
+            uint32_t v=stack.back();
+
+            stack.pop_back();
+            for (uint32_t t=0;t<n;t++)
+            {
+                if (adjacency[v][t]&&t!=removed&&label[t]==NO_NODE)
+                {
+                    label[t]=root;
+                    stack.push_back(t);
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/*
+ * Function: pathCounts
+ * Usage: pathCounts(graph,distance,source,sigma);
+ * -----------------------------------------------
+ * Counts the shortest paths from source to every node, arc by arc, by visiting the nodes in order
+ * of their distance. Costs must be positive for this order to be valid.
+ */
+
+static void pathCounts(const CSRGraph & graph,const CostMatrix & distance,bool weighted,
+                       uint32_t source,std::vector<double> & sigma)
+{
+    size_t n=graph.nodeCount;
+    std::vector<uint32_t> order;
+
+    sigma.assign(n,0);
+    for (uint32_t v=0;v<n;v++)
+    {
+        if (distance[source][v]>=0) order.push_back(v);
+    }
+    std::sort(order.begin(),order.end(),[&](uint32_t a,uint32_t b)
+    {
+        return distance[source][a]<distance[source][b];
+    });
+    sigma[source]=1;
+    for (uint32_t u:order)
+    {
+        for (size_t i=graph.offsets[u];i<graph.offsets[u+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+            double c=weighted ? graph.costs[i] : 1.0;
+
+            if (t!=source&&distance[source][u]+c==distance[source][t]) sigma[t]+=sigma[u];
+        }
+    }
+}
+
+static std::vector<double> referenceBetweenness(const CSRGraph & graph,bool weighted)
+{
+    size_t n=graph.nodeCount;
+    CostMatrix d=floydWarshall(graph,weighted);
+    std::vector<std::vector<double> > sigma(n);
+    std::vector<double> centrality(n,0);
+
+    for (uint32_t s=0;s<n;s++) pathCounts(graph,d,weighted,s,sigma[s]);
+    for (size_t s=0;s<n;s++)
+    {
+        for (size_t t=0;t<n;t++)
+        {
+            if (s==t||d[s][t]<0) continue;
+            for (size_t v=0;v<n;v++)
+            {
+                if (v==s||v==t||d[s][v]<0||d[v][t]<0||d[s][v]+d[v][t]!=d[s][t]) continue;
+                centrality[v]+=sigma[s][v]*sigma[v][t]/sigma[s][t];
+            }
+        }
+    }
+    return centrality;
+}
+
+/*
+ * Function: powerIteration
+ * Usage: powerIteration(graph,damping,source,rank);
+ * -------------------------------------------------
+ * Iterates the PageRank equations until they stop changing. If source is NO_NODE the surfer jumps
+ * to every node alike and the rank of nodes without arcs is spread evenly; otherwise every jump,
+ * including the one from a node without arcs, returns to source.
+ */
+
+static void powerIteration(const CSRGraph & graph,double damping,uint32_t source,
+                           std::vector<double> & rank)
+{
+    size_t n=graph.nodeCount;
+    std::vector<double> next(n);
+
+    rank.assign(n,(source==NO_NODE) ? 1.0/n : 0.0);
+    if (source!=NO_NODE) rank[source]=1;
+    for (int iteration=0;iteration<5000;iteration++)
+    {
+        double dangling=0;
+        double change=0;
+
+        std::fill(next.begin(),next.end(),0.0);
+        for (size_t u=0;u<n;u++)
+        {
+            size_t degree=graph.degree(u);
+
+            if (degree==0) dangling+=rank[u];
+            for (size_t i=graph.offsets[u];i<graph.offsets[u+1];i++)
+            {
+                next[graph.targets[i]]+=damping*rank[u]/degree;
+            }
+        }
+        for (size_t v=0;v<n;v++)
+        {
+            if (source==NO_NODE) next[v]+=(1-damping)/n+damping*dangling/n;
+            else if (v==source) next[v]+=(1-damping)+damping*dangling;
+            change+=std::fabs(next[v]-rank[v]);
+        }
+        rank.swap(next);
+        if (change<1e-15) break;
+    }
+}
+
+/*
+ * Section: checks
+ * ---------------
+ * One function per engine. Each compares every answer it can with the references and returns the
+ * first mismatch.
+ */
+
+static std::string checkComponents(const TestGraph & t)
+{
+    std::vector<uint32_t> expected,component;
+    size_t count=componentLabels(t.adjacency,NO_NODE,expected);
+
+    for (int pass=0;pass<2;pass++)
+    {
+        const CSRGraph & g=(pass==0) ? t.graph : t.undirected;
+
+        if (connectedComponents(g,component,pass==1)!=count) return Failure()<<"count differs";
+        if (component!=expected) return Failure()<<"labels differ (symmetric="<<pass<<")";
+    }
+    return "";
+}
+
+static std::string checkConnectivity(const TestGraph & t)
+{
+    const CSRGraph & g=t.graph;
+    size_t n=g.nodeCount;
+    IncrementalConnectivity connectivity(n);
+    std::vector<uint32_t> expected,labels;
+    size_t count=componentLabels(t.adjacency,NO_NODE,expected);
+
+    for (size_t v=0;v<n;v++) connectivity.addNode();
+    parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t u=first;u<last;u++)
+        {
+            for (size_t i=g.offsets[u];i<g.offsets[u+1];i++)
+            {
+                connectivity.addArc((uint32_t) u,g.targets[i]);
+            }
+        }
+    },1);
+    if (connectivity.componentCount()!=count) return Failure()<<"count differs";
+    connectivity.snapshot(labels);
+    if (labels!=expected) return Failure()<<"snapshot differs";
+    for (uint32_t u=0;u<n;u++)
+    {
+        size_t size=std::count(expected.begin(),expected.end(),expected[u]);
+
+        if (connectivity.componentSize(u)!=size) return Failure()<<"size of "<<u<<" differs";
+        for (uint32_t v=0;v<n;v++)
+        {
+            if (connectivity.isConnected(u,v)!=(expected[u]==expected[v]))
+            {
+                return Failure()<<"isConnected("<<u<<","<<v<<") differs";
+            }
+        }
+    }
+    return "";
+}
+
+static std::string checkReachability(const TestGraph & t)
+{
+    const CSRGraph & g=t.graph;
+    size_t n=g.nodeCount;
+    std::vector<uint32_t> component;
+    size_t count=stronglyConnectedComponents(g,component);
+    ReachabilityIndex index(g,3,7);
+    std::vector<uint32_t> representative;
+
+    for (uint32_t u=0;u<n;u++)
+    {
+        bool first=true;
+
+        for (uint32_t v=0;v<u;v++)
+        {
+            if (t.hops[u][v]>=0&&t.hops[v][u]>=0) first=false;
+        }
+        if (first) representative.push_back(u);
+        if (component[u]>=count) return Failure()<<"component of "<<u<<" out of range";
+        for (uint32_t v=0;v<n;v++)
+        {
+            bool strong=(t.hops[u][v]>=0&&t.hops[v][u]>=0);
+
+            if ((component[u]==component[v])!=strong) return Failure()<<"SCC of "<<u<<","<<v;
+            if (index.canReach(u,v)!=(t.hops[u][v]>=0))
+            {
+                return Failure()<<"canReach("<<u<<","<<v<<") differs";
+            }
+        }
+        for (size_t i=g.offsets[u];i<g.offsets[u+1];i++)
+        {
+            uint32_t v=g.targets[i];
+
+            if (component[u]<component[v])
+            {
+                return Failure()<<"components not in reverse topological order";
+            }
+        }
+    }
+    if (representative.size()!=count) return Failure()<<"SCC count differs";
+    return "";
+}
+
+static std::string checkHopLabels(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    HopLabelIndex directed(t.graph,false);
+    HopLabelIndex symmetric(t.undirected,true);
+
+    for (uint32_t u=0;u<n;u++)
+    {
+        for (uint32_t v=0;v<n;v++)
+        {
+            if (directed.hops(u,v)!=t.hops[u][v]) return Failure()<<"hops("<<u<<","<<v<<")";
+            if (symmetric.hops(u,v)!=t.undirectedHops[u][v])
+            {
+                return Failure()<<"symmetric hops("<<u<<","<<v<<")";
+            }
+        }
+    }
+    return "";
+}
+
+static std::string checkShortestPaths(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    std::vector<uint32_t> starts,finishes,path;
+    std::vector<double> costs;
+
+    for (uint32_t u=0;u<n;u++)
+    {
+        for (uint32_t v=0;v<n;v++)
+        {
+            double cost=findShortestPath(t.graph,u,v,&path);
+
+            if (!near(cost,t.costs[u][v])) return Failure()<<"cost "<<u<<"->"<<v<<": "<<cost;
+            if (cost>=0)
+            {
+                double sum=0;
+
+                for (size_t k=1;k<path.size();k++)
+                {
+                    double best=-1;
+
+                    for (size_t i=t.graph.offsets[path[k-1]];i<t.graph.offsets[path[k-1]+1];i++)
+                    {
+                        if (t.graph.targets[i]==path[k]&&(best<0||t.graph.costs[i]<best))
+                        {
+                            best=t.graph.costs[i];
+                        }
+                    }
+                    if (best<0) return Failure()<<"path "<<u<<"->"<<v<<" leaves the graph";
+                    sum+=best;
+                }
+                if (path.front()!=u||path.back()!=v||!near(sum,cost))
+                {
+                    return Failure()<<"path "<<u<<"->"<<v<<" does not match its cost";
+                }
+            }
+            starts.push_back(u);
+            finishes.push_back(v);
+        }
+    }
+    findShortestPaths(t.graph,starts,finishes,costs);
+    for (size_t k=0;k<starts.size();k++)
+    {
+        if (!near(costs[k],t.costs[starts[k]][finishes[k]])) return Failure()<<"batch query "<<k;
+    }
+    return "";
+}
+
+static std::string checkBetweenness(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+
+    for (int weighted=0;weighted<2;weighted++)
+    {
+        BetweennessOptions options;
+        std::vector<double> centrality,normalized;
+        std::vector<double> expected=referenceBetweenness(t.graph,weighted==1);
+
+        options.weighted=(weighted==1);
+        betweennessCentrality(t.graph,centrality,options);
+        options.normalized=true;
+        betweennessCentrality(t.graph,normalized,options);
+        for (size_t v=0;v<n;v++)
+        {
+            if (!near(centrality[v],expected[v]))
+            {
+                return Failure()<<"node "<<v<<" (weighted="<<weighted<<"): "<<centrality[v]
+                                <<" instead of "<<expected[v];
+            }
+            if (n>2&&!near(normalized[v],expected[v]/((n-1)*(n-2))))
+            {
+                return Failure()<<"normalized value of node "<<v;
+            }
+        }
+    }
+
+    /*
+     * Arcs of cost 0 let Dijkstra's algorithm settle a node before a predecessor at the same
+     * distance, which used to lose shortest paths, so weighted betweenness must reject them.
+     */
+
+    if (t.graph.arcCount()>0)
+    {
+        CSRGraph zero=t.graph;
+        BetweennessOptions options;
+        std::vector<double> centrality;
+
+        for (size_t i=0;i<zero.costs.size();i++) zero.costs[i]=(double) (i%2);
+        options.weighted=true;
+        try
+        {
+            betweennessCentrality(zero,centrality,options);
+            return Failure()<<"arc of cost 0 accepted";
+        } catch (ErrorException &)
+        {
+        }
+    }
+    return "";
+}
+
+static std::string checkPageRank(const TestGraph & t)
+{
+    const CSRGraph & g=t.graph;
+    size_t n=g.nodeCount;
+    PageRankOptions options;
+    std::vector<double> rank,expected;
+
+    options.tolerance=1e-13;
+    options.maxIterations=2000;
+    pageRank(g,rank,options);
+    powerIteration(g,options.damping,NO_NODE,expected);
+    for (size_t v=0;v<n;v++)
+    {
+        if (std::fabs(rank[v]-expected[v])>1e-9) return Failure()<<"rank of "<<v<<" differs";
+    }
+
+    std::vector<std::pair<uint32_t,double> > scores;
+    PageRankOptions local;
+    uint32_t source=(uint32_t) (n/2);
+    double slack=0,found=0,total=0;
+
+    local.tolerance=1e-6;
+    personalizedPageRank(g,source,scores,local);
+    powerIteration(g,local.damping,source,expected);
+    for (size_t v=0;v<n;v++)
+    {
+        slack+=local.tolerance*std::max<size_t>(g.degree(v),1);
+        total+=expected[v];
+    }
+    for (size_t k=0;k<scores.size();k++)
+    {
+        if (k>0&&scores[k].second>scores[k-1].second) return Failure()<<"scores not sorted";
+        if (scores[k].second<=0) return Failure()<<"nonpositive score";
+        if (scores[k].second>expected[scores[k].first]+1e-12)
+        {
+            return Failure()<<"personalized score of "<<scores[k].first<<" too large";
+        }
+        found+=scores[k].second;
+    }
+    if (total-found>slack+1e-12) return Failure()<<"personalized scores miss too much";
+    return "";
+}
+
+static std::string checkTriangles(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    std::vector<uint64_t> perNode(n,0);
+    uint64_t total=0;
+    double wedges=0,average=0;
+    std::vector<double> local(n,0);
+
+    for (size_t v=0;v<n;v++)
+    {
+        size_t degree=std::count(t.adjacency[v].begin(),t.adjacency[v].end(),1);
+
+        for (size_t a=0;a<n;a++)
+        {
+            for (size_t b=a+1;b<n;b++)
+            {
+                if (t.adjacency[v][a]&&t.adjacency[v][b]&&t.adjacency[a][b]) perNode[v]++;
+            }
+        }
+        total+=perNode[v];
+        wedges+=degree*(degree-1)/2.0;
+        if (degree>=2) local[v]=perNode[v]/(degree*(degree-1)/2.0);
+        average+=local[v];
+    }
+    total/=3;
+    for (int pass=0;pass<2;pass++)
+    {
+        TriangleCounts counts;
+
+        countTriangles((pass==0) ? t.graph : t.undirected,counts,pass==1);
+        if (counts.total!=total) return Failure()<<counts.total<<" triangles instead of "<<total;
+        if (counts.perNode!=perNode) return Failure()<<"per-node counts differ";
+        for (size_t v=0;v<n;v++)
+        {
+            if (!near(counts.local[v],local[v])) return Failure()<<"local coefficient of "<<v;
+        }
+        if (!near(counts.global,(wedges>0) ? 3*total/wedges : 0)) return Failure()<<"global";
+        if (!near(counts.average,average/n)) return Failure()<<"average coefficient";
+    }
+    return "";
+}
+
+static std::string checkCores(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    std::vector<size_t> degree(n);
+    std::vector<char> removed(n,0);
+    std::vector<uint32_t> expected(n),core;
+    uint32_t k=0;
+
+    for (size_t v=0;v<n;v++) degree[v]=std::count(t.adjacency[v].begin(),t.adjacency[v].end(),1);
+    for (size_t step=0;step<n;step++)
+    {
+        size_t best=NO_NODE;
+
+        for (size_t v=0;v<n;v++)
+        {
+            if (!removed[v]&&(best==NO_NODE||degree[v]<degree[best])) best=v;
+        }
+        k=std::max<uint32_t>(k,(uint32_t) degree[best]);
+        expected[best]=k;
+        removed[best]=1;
+        for (size_t v=0;v<n;v++)
+        {
+            if (t.adjacency[best][v]&&!removed[v]) degree[v]--;
+        }
+    }
+    for (int pass=0;pass<4;pass++)
+    {
+        const CSRGraph & g=(pass<2) ? t.graph : t.undirected;
+        uint32_t degeneracy=(pass%2==0) ? coreNumbers(g,core,pass>=2)
+                                        : parallelCoreNumbers(g,core,pass>=2);
+
+        if (core!=expected) return Failure()<<"core numbers differ (pass "<<pass<<")";
+        if (degeneracy!=k) return Failure()<<"degeneracy differs (pass "<<pass<<")";
+    }
+    return "";
+}
+
+static std::string checkCommunities(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    std::vector<uint32_t> community,component;
+    LabelPropagationOptions options;
+
+    componentLabels(t.adjacency,NO_NODE,component);
+    options.symmetric=t.symmetric;
+    for (int weighted=0;weighted<2;weighted++)
+    {
+        uint32_t next=0;
+
+        options.weighted=(weighted==1);
+
+        size_t count=labelPropagation(t.graph,community,options);
+
+        for (size_t v=0;v<n;v++)
+        {
+            if (community[v]>next) return Failure()<<"communities not numbered in order";
+            if (community[v]==next) next++;
+            for (size_t u=0;u<v;u++)
+            {
+                if (community[u]==community[v]&&component[u]!=component[v])
+                {
+                    return Failure()<<"community "<<community[v]<<" spans two components";
+                }
+            }
+        }
+        if (count!=next) return Failure()<<"count differs";
+    }
+    return "";
+}
+
+static std::string checkRandomWalks(const TestGraph & t)
+{
+    const CSRGraph & g=t.graph;
+    size_t n=g.nodeCount;
+
+    for (int kind=0;kind<3;kind++)
+    {
+        WalkOptions options;
+
+        options.length=7;
+        options.walksPerNode=3;
+        options.weighted=(kind==1);
+        if (kind==2)
+        {
+            options.p=0.5;
+            options.q=2;
+        }
+
+        RandomWalker walker(g,options);
+        std::mutex lock;
+        std::string error;
+        size_t walks=0,counted=0;
+
+        auto validate=[&](const std::vector<uint32_t> & path) -> std::string
+        {
+            if (path.empty()||path.size()>options.length) return Failure()<<"bad walk length";
+            for (size_t k=1;k<path.size();k++)
+            {
+                if (!hasArc(g,path[k-1],path[k])) return Failure()<<"walk leaves the graph";
+            }
+            if (path.size()<options.length&&g.degree(path.back())>0)
+            {
+                return Failure()<<"walk ends early";
+            }
+            return "";
+        };
+        size_t steps=walker.generate([&](const std::vector<uint32_t> & path)
+        {
+            std::string problem=validate(path);
+            std::lock_guard<std::mutex> guard(lock);
+
+            walks++;
+            counted+=path.size()-1;
+            if (error.empty()) error=problem;
+        });
+
+        if (!error.empty()) return error;
+        if (walks!=n*options.walksPerNode||steps!=counted) return Failure()<<"walk count differs";
+        for (uint32_t v=0;v<n;v++)
+        {
+            std::vector<uint32_t> first,second;
+
+            walker.walk(v,v,first);
+            walker.walk(v,v,second);
+            if (first!=second||first[0]!=v) return Failure()<<"walk from "<<v<<" not repeatable";
+        }
+    }
+    return "";
+}
+
+static std::string checkBiconnected(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    Adjacency adjacency=t.adjacency;
+    std::vector<uint32_t> whole;
+    std::vector<std::vector<uint32_t> > without(n);
+    std::vector<uint32_t> points;
+    std::vector<std::pair<uint32_t,uint32_t> > edges,bridges;
+    size_t count=componentLabels(adjacency,NO_NODE,whole);
+    Biconnectivity result;
+
+    for (uint32_t v=0;v<n;v++)
+    {
+        if (componentLabels(adjacency,v,without[v])>count) points.push_back(v);
+    }
+    for (uint32_t u=0;u<n;u++)
+    {
+        for (uint32_t v=u+1;v<n;v++)
+        {
+            if (!adjacency[u][v]) continue;
+            edges.push_back(std::make_pair(u,v));
+
+            std::vector<uint32_t> labels;
+
+            adjacency[u][v]=adjacency[v][u]=0;
+            if (componentLabels(adjacency,NO_NODE,labels)>count) bridges.push_back(edges.back());
+            adjacency[u][v]=adjacency[v][u]=1;
+        }
+    }
+    findBiconnectedComponents(t.graph,result);
+    if (result.articulationPoints!=points) return Failure()<<"articulation points differ";
+    if (result.bridges!=bridges) return Failure()<<"bridges differ";
+
+    /*
+     * Two edges lie in the same biconnected component exactly when no node separates them: for
+     * every node x, the ends of both edges other than x stay connected in the graph without x.
+     */
+
+    std::vector<size_t> block(edges.size(),NO_NODE);
+    size_t blocks=0;
+
+    for (size_t e=0;e<edges.size();e++)
+    {
+        if (block[e]!=NO_NODE) continue;
+        block[e]=blocks;
+        for (size_t f=e+1;f<edges.size();f++)
+        {
+            bool same=(whole[edges[e].first]==whole[edges[f].first]);
+
+            for (uint32_t x=0;same&&x<n;x++)
+            {
+                uint32_t a=(edges[e].first!=x) ? edges[e].first : edges[e].second;
+                uint32_t b=(edges[f].first!=x) ? edges[f].first : edges[f].second;
+
+                same=(without[x][a]==without[x][b]);
+            }
+            if (same) block[f]=blocks;
+        }
+        blocks++;
+    }
+    if (result.componentCount!=blocks)
+    {
+        return Failure()<<result.componentCount<<" components instead of "<<blocks;
+    }
+
+    std::map<size_t,uint32_t> mapping;
+    std::map<uint32_t,size_t> inverse;
+
+    for (uint32_t u=0;u<n;u++)
+    {
+        for (size_t i=t.graph.offsets[u];i<t.graph.offsets[u+1];i++)
+        {
+            uint32_t v=t.graph.targets[i];
+            uint32_t label=result.arcComponent[i];
+
+            if (u==v)
+            {
+                if (label!=NO_NODE) return Failure()<<"self-loop has a component";
+                continue;
+            }
+
+            size_t e=std::lower_bound(edges.begin(),edges.end(),
+                                      std::make_pair(std::min(u,v),std::max(u,v)))-edges.begin();
+
+            if (!mapping.count(block[e])) mapping[block[e]]=label;
+            if (!inverse.count(label)) inverse[label]=block[e];
+            if (mapping[block[e]]!=label||inverse[label]!=block[e])
+            {
+                return Failure()<<"arc "<<u<<"->"<<v<<" in the wrong component";
+            }
+        }
+    }
+    return "";
+}
+
+static std::string checkNeighborhoods(const TestGraph & t)
+{
+    const CSRGraph & g=t.graph;
+    size_t n=g.nodeCount;
+
+    for (int hops=0;hops<=3;hops++)
+    {
+        NeighborhoodOptions options;
+        std::vector<uint32_t> seeds;
+        std::vector<Neighborhood> batch;
+
+        options.hops=hops;
+        options.induced=true;
+        for (uint32_t s=0;s<n;s++)
+        {
+            Neighborhood result;
+            size_t expected=0;
+
+            kHopNeighborhood(g,s,result,options);
+            for (uint32_t v=0;v<n;v++)
+            {
+                if (t.hops[s][v]>=0&&t.hops[s][v]<=hops) expected++;
+            }
+            if (result.seed!=s||result.truncated||result.nodes.size()!=expected
+                ||result.nodes[0]!=s||result.levels.back()!=result.nodes.size())
+            {
+                return Failure()<<hops<<"-hop neighborhood of "<<s<<" differs";
+            }
+            for (size_t d=0;d+1<result.levels.size();d++)
+            {
+                for (size_t k=result.levels[d];k<result.levels[d+1];k++)
+                {
+                    if (t.hops[s][result.nodes[k]]!=(int) d)
+                    {
+                        return Failure()<<"node "<<result.nodes[k]<<" on the wrong level";
+                    }
+                }
+            }
+
+            const CSRGraph & sub=result.subgraph;
+            size_t arcs=0;
+
+            for (uint32_t a:result.nodes)
+            {
+                for (uint32_t b:result.nodes)
+                {
+                    for (size_t i=g.offsets[a];i<g.offsets[a+1];i++) arcs+=(g.targets[i]==b);
+                }
+            }
+            if (sub.nodeCount!=expected||sub.arcCount()!=arcs) return Failure()<<"subgraph size";
+            for (uint32_t i=0;i<sub.nodeCount;i++)
+            {
+                for (size_t k=sub.offsets[i];k<sub.offsets[i+1];k++)
+                {
+                    if (!hasArc(g,result.nodes[i],result.nodes[sub.targets[k]]))
+                    {
+                        return Failure()<<"subgraph arc not in the graph";
+                    }
+                }
+            }
+
+            Neighborhood capped;
+            NeighborhoodOptions small=options;
+
+            small.maxNodes=3;
+            kHopNeighborhood(g,s,capped,small);
+            if (capped.nodes.size()!=std::min<size_t>(3,expected)
+                ||capped.truncated!=(expected>3&&capped.nodes.size()<expected))
+            {
+                return Failure()<<"capped neighborhood of "<<s<<" differs";
+            }
+            seeds.push_back(s);
+        }
+        kHopNeighborhoods(g,seeds,batch,options);
+        for (uint32_t s=0;s<n;s++)
+        {
+            Neighborhood single;
+
+            kHopNeighborhood(g,s,single,options);
+            if (batch[s].nodes!=single.nodes||batch[s].levels!=single.levels)
+            {
+                return Failure()<<"batch neighborhood of "<<s<<" differs";
+            }
+        }
+    }
+    return "";
+}
+
+static std::string checkDiameter(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    std::vector<uint32_t> component;
+    std::vector<size_t> size(n,0);
+    uint32_t largest=0;
+    uint32_t diameter=0,radius=UINT32_MAX;
+
+    componentLabels(t.adjacency,NO_NODE,component);
+    for (size_t v=0;v<n;v++)
+    {
+        if (++size[component[v]]>size[largest]) largest=component[v];
+    }
+    for (size_t v=0;v<n;v++)
+    {
+        if (component[v]!=largest) continue;
+
+        int eccentricity=*std::max_element(t.undirectedHops[v].begin(),t.undirectedHops[v].end());
+
+        diameter=std::max<uint32_t>(diameter,eccentricity);
+        radius=std::min<uint32_t>(radius,eccentricity);
+    }
+    for (int pass=0;pass<2;pass++)
+    {
+        DiameterResult result;
+
+        computeDiameter((pass==0) ? t.graph : t.undirected,result,pass==1);
+        if (result.diameter!=diameter||result.radius!=radius||result.componentSize!=size[largest])
+        {
+            return Failure()<<"diameter "<<result.diameter<<" radius "<<result.radius
+                            <<" instead of "<<diameter<<" and "<<radius;
+        }
+        if (component[result.from]!=largest
+            ||t.undirectedHops[result.from][result.to]!=(int) diameter)
+        {
+            return Failure()<<"ends of the longest path are wrong";
+        }
+
+        const std::vector<int> & row=t.undirectedHops[result.center];
+
+        if (component[result.center]!=largest
+            ||*std::max_element(row.begin(),row.end())!=(int) radius)
+        {
+            return Failure()<<"center is wrong";
+        }
+    }
+    return "";
+}
+
+static std::string checkHyperANF(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    HyperANFOptions options;
+    std::vector<double> neighborhood,reach;
+
+    options.log2Registers=12;
+    hyperANF(t.graph,neighborhood,reach,options);
+    for (size_t h=0;h<neighborhood.size();h++)
+    {
+        double pairs=0;
+
+        for (size_t u=0;u<n;u++)
+        {
+            for (size_t v=0;v<n;v++) pairs+=(t.hops[u][v]>=0&&t.hops[u][v]<=(int) h);
+        }
+        if (std::fabs(neighborhood[h]-pairs)>0.1*pairs+1) return Failure()<<"N("<<h<<") off";
+    }
+    for (size_t v=0;v<n;v++)
+    {
+        double reached=std::count_if(t.hops[v].begin(),t.hops[v].end(),[](int d) { return d>=0; });
+
+        if (std::fabs(reach[v]-reached)>0.1*reached+1) return Failure()<<"reach of "<<v<<" off";
+    }
+    return "";
+}
+
+static std::string checkColoring(const TestGraph & t)
+{
+    size_t n=t.graph.nodeCount;
+    GreedyOrder orders[]={
+        NATURAL_ORDER, RANDOM_ORDER, LARGEST_FIRST, SMALLEST_FIRST, SMALLEST_LAST
+    };
+
+    for (GreedyOrder order:orders)
+    {
+        ColoringOptions options;
+        IndependentSetOptions setOptions;
+        std::vector<uint32_t> color,independent;
+        std::vector<char> member(n,0);
+
+        options.order=order;
+        options.symmetric=t.symmetric;
+
+        uint32_t count=colorGraph(t.graph,color,options);
+
+        for (size_t v=0;v<n;v++)
+        {
+            size_t degree=std::count(t.adjacency[v].begin(),t.adjacency[v].end(),1);
+
+            if (color[v]>=count||color[v]>degree) return Failure()<<"color of "<<v<<" too large";
+            for (size_t u=0;u<n;u++)
+            {
+                if (t.adjacency[u][v]&&color[u]==color[v]) return Failure()<<"edge "<<u<<"-"<<v;
+            }
+        }
+        if (n>0&&*std::max_element(color.begin(),color.end())+1!=count) return Failure()<<"count";
+        setOptions.order=order;
+        setOptions.symmetric=t.symmetric;
+        if (maximalIndependentSet(t.graph,independent,setOptions)!=independent.size())
+        {
+            return Failure()<<"set size differs";
+        }
+        if (!std::is_sorted(independent.begin(),independent.end()))
+        {
+            return Failure()<<"set unsorted";
+        }
+        for (uint32_t v:independent) member[v]=1;
+        for (size_t v=0;v<n;v++)
+        {
+            bool blocked=false;
+
+            for (size_t u=0;u<n;u++)
+            {
+                if (!t.adjacency[u][v]||!member[u]) continue;
+                if (member[v]) return Failure()<<"set contains edge "<<u<<"-"<<v;
+                blocked=true;
+            }
+            if (!member[v]&&!blocked) return Failure()<<"set not maximal at "<<v;
+        }
+        if (order==NATURAL_ORDER)
+        {
+            std::vector<char> greedy(n,0);
+
+            for (size_t v=0;v<n;v++)
+            {
+                greedy[v]=1;
+                for (size_t u=0;u<v;u++)
+                {
+                    if (greedy[u]&&t.adjacency[u][v]) greedy[v]=0;
+                }
+            }
+            if (greedy!=member) return Failure()<<"set differs from the sequential greedy set";
+        }
+    }
+    return "";
+}
+
+/*
+ * Function: randomGraph
+ * Usage: randomGraph(rng,maxNodes,t);
+ * -----------------------------------
+ * Fills t with a random graph of up to maxNodes nodes and its references. Every third graph is
+ * symmetric, and the others are directed with self-loops and parallel arcs. Costs are small
+ * integers, so path costs compare exactly.
+ */
+
+static void randomGraph(std::mt19937_64 & rng,size_t maxNodes,TestGraph & t)
+{
+    size_t n=1+rng()%maxNodes;
+    size_t m=rng()%(3*n+1);
+    EdgeList edges;
+
+    t.symmetric=(rng()%3==0);
+    edges.nodeCount=n;
+    for (size_t k=0;k<m;k++)
+    {
+        uint32_t u=(uint32_t) (rng()%n);
+        uint32_t v=(uint32_t) (rng()%n);
+        double cost=(double) (1+rng()%3);
+
+        if (t.symmetric&&u==v) continue;
+        edges.sources.push_back(u);
+        edges.targets.push_back(v);
+        edges.costs.push_back(cost);
+        if (t.symmetric)
+        {
+            edges.sources.push_back(v);
+            edges.targets.push_back(u);
+            edges.costs.push_back(cost);
+        }
+    }
+    buildCSR(edges,t.graph);
+    symmetrizeCSR(t.graph,t.undirected);
+    t.adjacency.assign(n,std::vector<char>(n,0));
+    for (size_t k=0;k<edges.sources.size();k++)
+    {
+        uint32_t u=edges.sources[k];
+        uint32_t v=edges.targets[k];
+
+        if (u!=v) t.adjacency[u][v]=t.adjacency[v][u]=1;
+    }
+    t.hops.resize(n);
+    t.undirectedHops.resize(n);
+    for (uint32_t v=0;v<n;v++)
+    {
+        t.hops[v]=bfsHops(t.graph,v);
+        t.undirectedHops[v]=bfsHops(t.undirected,v);
+    }
+    t.costs=floydWarshall(t.graph,true);
+}
+
+int main(int argc,char * argv[])
+{
+    int trials=300;
+    int threads=4;
+    size_t maxNodes=24;
+    unsigned long long seed=1;
+
+    for (int i=1;i<argc;i++)
+    {
+        std::string arg=argv[i];
+
+        if (i+1>=argc) error("GraphCheck: missing value for " + arg);
+
+        std::string value=argv[++i];
+
+        if (arg=="--trials") trials=std::stoi(value);
+        else if (arg=="--seed") seed=std::stoull(value);
+        else if (arg=="--threads") threads=std::stoi(value);
+        else if (arg=="--max-nodes") maxNodes=std::max(1UL,std::stoul(value));
+        else error("GraphCheck: unknown option " + arg);
+    }
+    ThreadPool::setSharedThreads(threads);
+
+    Check checks[]={
+        { "components", checkComponents },
+        { "connectivity", checkConnectivity },
+        { "reachability", checkReachability },
+        { "hoplabels", checkHopLabels },
+        { "shortestpath", checkShortestPaths },
+        { "centrality", checkBetweenness },
+        { "pagerank", checkPageRank },
+        { "triangles", checkTriangles },
+        { "cores", checkCores },
+        { "communities", checkCommunities },
+        { "randomwalk", checkRandomWalks },
+        { "biconnected", checkBiconnected },
+        { "neighborhood", checkNeighborhoods },
+        { "diameter", checkDiameter },
+        { "hyperanf", checkHyperANF },
+        { "coloring", checkColoring }
+    };
+    std::vector<int> failures(sizeof checks/sizeof checks[0],0);
+    std::vector<std::string> first(failures.size());
+    std::mt19937_64 rng(seed);
+
+    for (int trial=0;trial<trials;trial++)
+    {
+        TestGraph t;
+
+        randomGraph(rng,maxNodes,t);
+        for (size_t c=0;c<failures.size();c++)
+        {
+            std::string problem;
+
+            try
+            {
+                problem=checks[c].run(t);
+            } catch (std::exception & ex)
+            {
+                problem=ex.what();
+            }
+            if (problem.empty()) continue;
+            if (failures[c]++==0)
+            {
+                std::ostringstream where;
+
+                where<<"graph "<<trial<<" ("<<t.graph.nodeCount<<" nodes, "
+                     <<t.graph.arcCount()<<" arcs): "<<problem;
+                first[c]=where.str();
+            }
+        }
+    }
+
+    int failed=0;
+
+    for (size_t c=0;c<failures.size();c++)
+    {
+        std::cout<<checks[c].name<<": ";
+        if (failures[c]==0)
+        {
+            std::cout<<"ok ("<<trials<<" graphs)"<<std::endl;
+        } else
+        {
+            std::cout<<"FAILED on "<<failures[c]<<" of "<<trials<<" graphs; first at "<<first[c]
+                     <<std::endl;
+            failed++;
+        }
+    }
+    return (failed==0) ? 0 : 1;
+}
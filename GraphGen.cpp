@@ -0,0 +1,83 @@
+/*
+ * File: GraphGen.cpp
+ * ------------------
+ * This program generates a synthetic graph with the functions in graphgen.h and writes it to a
+ * binary graph file that can be read back with loadBinaryGraph.
+ *
+ * Usage: GraphGen --output file [--generator rmat|er|ba|grid|regular|path] [--scale s]
+ *                 [--edgefactor k] [--seed n] [--threads n] [--directed]
+ *                 [--cost constant|uniform|integer|exponential] [--cost-min x] [--cost-max x]
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "csrgraph.h"
+#include "error.h"
+#include "graphgen.h"
+#include "threadpool.h"
+
+int main(int argc,char * argv[])
+{
+    GeneratorOptions options;
+    std::string generator="rmat";
+    std::string output;
+    int scale=16;
+    size_t edgefactor=16;
+
+    for (int i=1;i<argc;i++)
+    {
+        std::string arg=argv[i];
+
+        if (arg=="--directed")
+        {
+            options.undirected=false;
+            continue;
+        }
+        if (i+1>=argc) error("GraphGen: missing value for " + arg);
+
+        std::string value=argv[++i];
+
+        if (arg=="--output") output=value;
+        else if (arg=="--generator") generator=value;
+        else if (arg=="--scale") scale=std::stoi(value);
+        else if (arg=="--edgefactor") edgefactor=std::stoul(value);
+        else if (arg=="--seed") options.seed=std::stoull(value);
+        else if (arg=="--threads") options.threads=std::stoi(value);
+        else if (arg=="--cost-min") options.costMin=std::stod(value);
+        else if (arg=="--cost-max") options.costMax=std::stod(value);
+        else if (arg=="--cost")
+        {
+            if (value=="constant") options.costDistribution=CONSTANT_COST;
+            else if (value=="uniform") options.costDistribution=UNIFORM_COST;
+            else if (value=="integer") options.costDistribution=INTEGER_COST;
+            else if (value=="exponential") options.costDistribution=EXPONENTIAL_COST;
+            else error("GraphGen: unknown cost distribution " + value);
+        }
+        else error("GraphGen: unknown option " + arg);
+    }
+    if (output.empty()) error("GraphGen: --output is required");
+    if (scale<1||scale>31) error("GraphGen: scale must be between 1 and 31");
+
+    ThreadPool::setSharedThreads(options.threads);
+
+    CSRGraph csr;
+    size_t n=(size_t) 1<<scale;
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+
+    if (generator=="rmat") generateRMAT(scale,edgefactor,options,csr);
+    else if (generator=="er") generateErdosRenyi(n,n*edgefactor,options,csr);
+    else if (generator=="ba") generateBarabasiAlbert(n,edgefactor,options,csr);
+    else if (generator=="grid") generateGrid((size_t) 1<<(scale/2),n>>(scale/2),options,csr);
+    else if (generator=="regular") generateRandomRegular(n,edgefactor,options,csr);
+    else if (generator=="path") generatePath(n,options,csr);
+    else error("GraphGen: unknown generator " + generator);
+
+    double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    saveBinaryGraph(csr,output);
+    std::cout<<"{\"generator\":\""<<generator<<"\",\"nodes\":"<<csr.nodeCount
+             <<",\"arcs\":"<<csr.arcCount()<<",\"seconds\":"<<seconds
+             <<",\"output\":\""<<output<<"\"}"<<std::endl;
+    return 0;
+}
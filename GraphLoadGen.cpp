@@ -0,0 +1,222 @@
+/*
+ * File: GraphLoadGen.cpp
+ * ----------------------
+ * This program measures a running GraphServer. Each client thread opens its own connection and keeps
+ * a fixed number of random queries in flight until it has sent its share; the program then prints
+ * the overall throughput and the latency percentiles of every query type as JSON.
+ *
+ * Usage: GraphLoadGen [--socket path] [--clients n] [--depth n] [--queries n] [--seed n]
+ *                     [--mix hops,reach,path]
+ *
+ * The mix gives the relative weights of hop, reachability and shortest-path queries.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "error.h"
+#include "graphclient.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct Config
+{
+    std::string socketPath;
+    int clients;
+    size_t depth;                               /* Queries each client keeps in flight */
+    size_t queries;                             /* Total queries over all clients */
+    unsigned long long seed;
+    std::vector<double> mix;                    /* Weights of QUERY_HOPS .. QUERY_SHORTEST_PATH */
+};
+
+/*
+ * Type: ClientResult
+ * ------------------
+ * The latencies in microseconds that one client thread observed, indexed by query type.
+ */
+
+struct ClientResult
+{
+    std::vector<double> latencies[QUERY_SHORTEST_PATH+1];
+    size_t errors;
+    size_t aborted;
+};
+
+static std::vector<double> splitWeights(const std::string & str)
+{
+    std::vector<double> result;
+    size_t start=0;
+
+    while (start<=str.size())
+    {
+        size_t comma=str.find(',',start);
+
+        if (comma==std::string::npos) comma=str.size();
+        if (comma>start) result.push_back(std::stod(str.substr(start,comma-start)));
+        start=comma+1;
+    }
+    return result;
+}
+
+/*
+ * Function: runClient
+ * Usage: runClient(config,nodes,count,stream,result);
+ * ---------------------------------------------------
+ * Sends count random queries over a new connection, keeping config.depth of them outstanding, and
+ * records the round-trip time of each.
+ */
+
+static void runClient(const Config & config,size_t nodes,size_t count,int stream,
+                      ClientResult & result)
+{
+    GraphClient client(config.socketPath);
+    std::mt19937_64 rng(config.seed+stream);
+    std::uniform_int_distribution<uint32_t> pick(0,(uint32_t) (nodes-1));
+    std::discrete_distribution<int> kind(config.mix.begin(),config.mix.end());
+    std::map<uint32_t,std::pair<int,Clock::time_point> > inflight;
+    size_t sent=0;
+
+    result.errors=0;
+    result.aborted=0;
+    while (sent<count||!inflight.empty())
+    {
+        while (sent<count&&inflight.size()<config.depth)
+        {
+            QueryType type=(QueryType) (QUERY_HOPS+kind(rng));
+            uint32_t source=pick(rng);
+            uint32_t target=pick(rng);
+            Clock::time_point start=Clock::now();
+
+            inflight[client.send(type,source,target)]=std::make_pair((int) type,start);
+            sent++;
+        }
+
+        QueryResponse response=client.receive();
+        std::map<uint32_t,std::pair<int,Clock::time_point> >::iterator it=inflight.find(response.id);
+
+        if (it==inflight.end()) error("GraphLoadGen: response to unknown query");
+        if (response.status==STATUS_ABORTED) result.aborted++;
+        else if (response.status!=STATUS_OK) result.errors++;
+        result.latencies[it->second.first].push_back(
+            std::chrono::duration<double,std::micro>(Clock::now()-it->second.second).count());
+        inflight.erase(it);
+    }
+}
+
+/*
+ * Function: writePercentiles
+ * Usage: writePercentiles(os,samples);
+ * ------------------------------------
+ * Writes the count, mean and the 50th, 90th, 99th and 99.9th percentiles of a latency sample.
+ */
+
+static void writePercentiles(std::ostream & os,std::vector<double> samples)
+{
+    static const double LEVELS[]={50,90,99,99.9};
+    static const char * const NAMES[]={"p50","p90","p99","p999"};
+    double sum=0;
+
+    os<<"{\"count\":"<<samples.size();
+    if (samples.empty())
+    {
+        os<<"}";
+        return;
+    }
+    std::sort(samples.begin(),samples.end());
+    for (double x:samples) sum+=x;
+    os<<",\"mean_us\":"<<sum/samples.size();
+    for (int i=0;i<4;i++)
+    {
+        size_t rank=(size_t) (LEVELS[i]/100*(samples.size()-1)+0.5);
+
+        os<<",\""<<NAMES[i]<<"_us\":"<<samples[rank];
+    }
+    os<<",\"max_us\":"<<samples.back()<<"}";
+}
+
+static Config parseArguments(int argc,char * argv[])
+{
+    Config config;
+
+    config.socketPath="/tmp/graphserver.sock";
+    config.clients=4;
+    config.depth=16;
+    config.queries=100000;
+    config.seed=1;
+    config.mix=splitWeights("1,1,1");
+    for (int i=1;i<argc;i++)
+    {
+        std::string arg=argv[i];
+
+        if (i+1>=argc) error("GraphLoadGen: missing value for " + arg);
+
+        std::string value=argv[++i];
+
+        if (arg=="--socket") config.socketPath=value;
+        else if (arg=="--clients") config.clients=std::max(1,std::stoi(value));
+        else if (arg=="--depth") config.depth=std::max(1,std::stoi(value));
+        else if (arg=="--queries") config.queries=std::stoul(value);
+        else if (arg=="--seed") config.seed=std::stoull(value);
+        else if (arg=="--mix") config.mix=splitWeights(value);
+        else error("GraphLoadGen: unknown option " + arg);
+    }
+    if (config.mix.size()!=3) error("GraphLoadGen: --mix needs three weights");
+    return config;
+}
+
+int main(int argc,char * argv[])
+{
+    static const char * const TYPE_NAMES[]={"info","hops","reach","path"};
+    Config config=parseArguments(argc,argv);
+    size_t nodes=GraphClient(config.socketPath).nodeCount();
+    std::vector<ClientResult> results(config.clients);
+    std::vector<std::thread> threads;
+    std::ostream & os=std::cout;
+
+    if (nodes==0) error("GraphLoadGen: server graph is empty");
+
+    Clock::time_point start=Clock::now();
+
+    for (int i=0;i<config.clients;i++)
+    {
+        size_t count=config.queries/config.clients+((size_t) i<config.queries%config.clients ? 1 : 0);
+
+        threads.push_back(std::thread(runClient,std::cref(config),nodes,count,i,
+                                      std::ref(results[i])));
+    }
+    for (std::thread & thread:threads) thread.join();
+
+    double seconds=std::chrono::duration<double>(Clock::now()-start).count();
+    size_t errors=0,aborted=0;
+
+    os.precision(9);
+    os<<"{\"benchmark\":\"graphserver\",\"config\":{\"socket\":\""<<config.socketPath
+      <<"\",\"clients\":"<<config.clients<<",\"depth\":"<<config.depth
+      <<",\"queries\":"<<config.queries<<",\"seed\":"<<config.seed<<"}"
+      <<",\"nodes\":"<<nodes<<",\"seconds\":"<<seconds
+      <<",\"queries_per_second\":"<<config.queries/std::max(seconds,1e-12)<<",\"latency\":{";
+    for (int type=QUERY_HOPS;type<=QUERY_SHORTEST_PATH;type++)
+    {
+        std::vector<double> samples;
+
+        for (const ClientResult & result:results)
+        {
+            samples.insert(samples.end(),result.latencies[type].begin(),result.latencies[type].end());
+        }
+        if (type>QUERY_HOPS) os<<",";
+        os<<"\n\""<<TYPE_NAMES[type]<<"\":";
+        writePercentiles(os,samples);
+    }
+    for (const ClientResult & result:results)
+    {
+        errors+=result.errors;
+        aborted+=result.aborted;
+    }
+    os<<"},\"aborted\":"<<aborted<<",\"errors\":"<<errors<<"}"<<std::endl;
+    return 0;
+}
@@ -0,0 +1,454 @@
+/*
+ * File: GraphServer.cpp
+ * ---------------------
+ * This program loads a graph once and answers hop-distance, reachability and shortest-path queries
+ * from local clients over a Unix-domain socket, using the protocol in graphprotocol.h. Requests that
+ * arrive from all clients within a short batching window are answered together: hop and
+ * reachability queries share multi-source breadth-first searches, so concurrent load costs far less
+ * than one traversal per query. With --max-work or --query-timeout-ms, queries that explore too much
+ * of the graph are abandoned and answered with STATUS_ABORTED instead of delaying everyone else.
+ *
+ * Usage: GraphServer [--socket path] [--graph file | --generator rmat --scale s --edgefactor k]
+ *                    [--seed n] [--threads n] [--batch-max n] [--batch-window-us n]
+ *                    [--max-work n] [--query-timeout-ms n] [--trace file]
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "csrgraph.h"
+#include "error.h"
+#include "graphgen.h"
+#include "graphprotocol.h"
+#include "searchbudget.h"
+#include "shortestpath.h"
+#include "threadpool.h"
+#include "tracing.h"
+#include "traversal.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+ * Type: Client
+ * ------------
+ * This type holds the state of one connection: bytes received but not yet parsed, and encoded
+ * responses not yet written. A client that has shut down its side of the connection is kept until
+ * its queued queries are answered and the answers are sent.
+ */
+
+struct Client
+{
+    int fd;
+    std::vector<unsigned char> input;
+    std::vector<unsigned char> output;
+    size_t written;                             /* Bytes of output already sent */
+    size_t queued;                              /* Queries waiting for the next batch */
+    bool finished;                              /* The client will send no more requests */
+    bool closed;                                /* The connection failed and is dropped */
+};
+
+/*
+ * Constant: MAX_BACKLOG
+ * ---------------------
+ * The number of bytes of unsent and promised responses at which the server stops reading from a
+ * client, so a client that sends faster than it reads cannot make its output grow without bound.
+ */
+
+const size_t MAX_BACKLOG=1<<20;
+
+static size_t backlog(const Client & client)
+{
+    return client.output.size()-client.written+client.queued*FRAME_SIZE;
+}
+
+/*
+ * Type: PendingQuery
+ * ------------------
+ * A parsed request waiting for the next batch, together with the connection it came from.
+ */
+
+struct PendingQuery
+{
+    int client;
+    QueryRequest request;
+};
+
+struct Config
+{
+    std::string socketPath;
+    std::string graphFile;
+    std::string generator;
+    std::string trace;
+    int threads;                                /* Threads for shortest paths, 0 for all */
+    int scale;
+    size_t edgefactor;
+    unsigned long long seed;
+    size_t batchMax;                            /* Queries that trigger a batch immediately */
+    long batchWindow;                           /* Microseconds the first query may wait */
+    size_t maxWork;                             /* Nodes plus arcs per query, 0 for no limit */
+    long queryTimeout;                          /* Milliseconds per batch, 0 for no limit */
+};
+
+static volatile sig_atomic_t running=1;
+
+static void stopServer(int)
+{
+    running=0;
+}
+
+static void setNonBlocking(int fd)
+{
+    fcntl(fd,F_SETFL,fcntl(fd,F_GETFL,0)|O_NONBLOCK);
+}
+
+/*
+ * Function: flushClient
+ * Usage: flushClient(client);
+ * ---------------------------
+ * Writes as much pending output as the socket accepts without blocking.
+ */
+
+static void flushClient(Client & client)
+{
+    while (client.written<client.output.size())
+    {
+        ssize_t n=send(client.fd,client.output.data()+client.written,
+                       client.output.size()-client.written,MSG_NOSIGNAL);
+
+        if (n<0)
+        {
+            if (errno!=EAGAIN&&errno!=EWOULDBLOCK&&errno!=EINTR) client.closed=true;
+            break;
+        }
+        client.written+=n;
+    }
+    if (client.written==client.output.size())
+    {
+        client.output.clear();
+        client.written=0;
+    }
+}
+
+/*
+ * Function: readClient
+ * Usage: readClient(id,client,pending);
+ * -------------------------------------
+ * Reads what is available on the connection, up to the backlog limit, and moves every complete
+ * frame to pending.
+ */
+
+static void readClient(int id,Client & client,std::vector<PendingQuery> & pending)
+{
+    unsigned char buffer[64*FRAME_SIZE];
+
+    while (backlog(client)<MAX_BACKLOG)
+    {
+        ssize_t n=recv(client.fd,buffer,sizeof buffer,0);
+
+        if (n==0)
+        {
+            client.finished=true;
+            break;
+        }
+        if (n<0)
+        {
+            if (errno!=EAGAIN&&errno!=EWOULDBLOCK&&errno!=EINTR) client.closed=true;
+            break;
+        }
+        client.input.insert(client.input.end(),buffer,buffer+n);
+    }
+
+    size_t pos=0;
+
+    for (;pos+FRAME_SIZE<=client.input.size();pos+=FRAME_SIZE)
+    {
+        PendingQuery query;
+
+        query.client=id;
+        query.request=decodeRequest(client.input.data()+pos);
+        pending.push_back(query);
+        client.queued++;
+    }
+    client.input.erase(client.input.begin(),client.input.begin()+pos);
+}
+
+/*
+ * Implementation notes: executeBatch
+ * ----------------------------------
+ * Hop and reachability queries are collected into one call of multiSourceBFS, which runs up to 64
+ * searches per pass over the graph. Shortest-path queries run Dijkstra's algorithm in parallel on
+ * the shared thread pool. The hop searches share one budget of maxWork per query, while every
+ * shortest-path query has its own; a query still unanswered when its budget runs out is aborted.
+ * Responses to clients whose connection has failed are dropped.
+ */
+
+static void executeBatch(const CSRGraph & graph,const Config & config,
+                         std::vector<PendingQuery> & pending,std::map<int,Client> & clients)
+{
+    TRACE_SCOPE_VALUE("server.batch",pending.size());
+    std::vector<QueryResponse> responses(pending.size());
+    std::vector<size_t> traversal,weighted;
+    std::vector<uint32_t> sources,targets,starts,finishes;
+    std::vector<int> hops;
+    std::vector<double> costs;
+    std::vector<SearchStatus> statuses;
+    SearchBudget limits;
+
+    if (config.queryTimeout>0) limits.setTimeLimit(std::chrono::milliseconds(config.queryTimeout));
+
+    for (size_t i=0;i<pending.size();i++)
+    {
+        const QueryRequest & request=pending[i].request;
+        QueryResponse & response=responses[i];
+
+        response.id=request.id;
+        response.status=STATUS_OK;
+        response.value=0;
+        if (request.type==QUERY_INFO)
+        {
+            response.value=(double) graph.nodeCount;
+        } else if (request.type>QUERY_SHORTEST_PATH||request.source>=graph.nodeCount
+                   ||request.target>=graph.nodeCount)
+        {
+            response.status=STATUS_BAD_REQUEST;
+        } else if (request.type==QUERY_SHORTEST_PATH)
+        {
+            weighted.push_back(i);
+            starts.push_back(request.source);
+            finishes.push_back(request.target);
+        } else
+        {
+            traversal.push_back(i);
+            sources.push_back(request.source);
+            targets.push_back(request.target);
+        }
+    }
+    if (!traversal.empty())
+    {
+        SearchBudget budget(limits);
+
+        budget.setWorkLimit(config.maxWork*traversal.size());
+        multiSourceBFS(graph,sources,targets,hops,&budget,&statuses);
+        for (size_t k=0;k<traversal.size();k++)
+        {
+            QueryResponse & response=responses[traversal[k]];
+
+            if (statuses[k]!=SEARCH_COMPLETE) response.status=STATUS_ABORTED;
+            else if (pending[traversal[k]].request.type==QUERY_HOPS) response.value=hops[k];
+            else response.value=(hops[k]>=0) ? 1 : 0;
+        }
+    }
+    if (!weighted.empty())
+    {
+        limits.setWorkLimit(config.maxWork);
+        findShortestPaths(graph,starts,finishes,costs,&limits,&statuses);
+        for (size_t k=0;k<weighted.size();k++)
+        {
+            if (statuses[k]!=SEARCH_COMPLETE) responses[weighted[k]].status=STATUS_ABORTED;
+            else responses[weighted[k]].value=costs[k];
+        }
+    }
+    for (size_t i=0;i<pending.size();i++)
+    {
+        std::map<int,Client>::iterator it=clients.find(pending[i].client);
+        unsigned char frame[FRAME_SIZE];
+
+        if (it==clients.end()) continue;
+        it->second.queued--;
+        encodeResponse(responses[i],frame);
+        it->second.output.insert(it->second.output.end(),frame,frame+FRAME_SIZE);
+    }
+    pending.clear();
+    for (std::map<int,Client>::iterator it=clients.begin();it!=clients.end();++it)
+    {
+        if (!it->second.output.empty()) flushClient(it->second);
+    }
+}
+
+static Config parseArguments(int argc,char * argv[])
+{
+    Config config;
+
+    config.socketPath="/tmp/graphserver.sock";
+    config.generator="rmat";
+    config.scale=16;
+    config.edgefactor=16;
+    config.seed=1;
+    config.threads=0;
+    config.batchMax=256;
+    config.batchWindow=200;
+    config.maxWork=0;
+    config.queryTimeout=0;
+    for (int i=1;i<argc;i++)
+    {
+        std::string arg=argv[i];
+
+        if (i+1>=argc) error("GraphServer: missing value for " + arg);
+
+        std::string value=argv[++i];
+
+        if (arg=="--socket") config.socketPath=value;
+        else if (arg=="--graph") config.graphFile=value;
+        else if (arg=="--generator") config.generator=value;
+        else if (arg=="--scale") config.scale=std::stoi(value);
+        else if (arg=="--edgefactor") config.edgefactor=std::stoul(value);
+        else if (arg=="--seed") config.seed=std::stoull(value);
+        else if (arg=="--batch-max") config.batchMax=std::max(1UL,std::stoul(value));
+        else if (arg=="--batch-window-us") config.batchWindow=std::stol(value);
+        else if (arg=="--threads") config.threads=std::stoi(value);
+        else if (arg=="--max-work") config.maxWork=std::stoul(value);
+        else if (arg=="--query-timeout-ms") config.queryTimeout=std::stol(value);
+        else if (arg=="--trace") config.trace=value;
+        else error("GraphServer: unknown option " + arg);
+    }
+    return config;
+}
+
+static int openListener(const std::string & path)
+{
+    struct sockaddr_un address;
+    int fd=socket(AF_UNIX,SOCK_STREAM,0);
+
+    if (fd<0) error("GraphServer: can't create socket");
+    if (path.size()>=sizeof address.sun_path) error("GraphServer: socket path too long");
+    std::memset(&address,0,sizeof address);
+    address.sun_family=AF_UNIX;
+    std::strcpy(address.sun_path,path.c_str());
+    unlink(path.c_str());
+    if (bind(fd,(struct sockaddr *) &address,sizeof address)<0||listen(fd,128)<0)
+    {
+        error("GraphServer: can't listen on " + path);
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+int main(int argc,char * argv[])
+{
+    Config config=parseArguments(argc,argv);
+    CSRGraph graph;
+
+    ThreadPool::setSharedThreads(config.threads);
+    if (!config.trace.empty()) setTracingEnabled(true);
+    if (!config.graphFile.empty())
+    {
+        loadBinaryGraph(config.graphFile,graph);
+    } else
+    {
+        GeneratorOptions options;
+
+        options.seed=config.seed;
+        if (config.generator!="rmat") error("GraphServer: only rmat can be generated at startup");
+        generateRMAT(config.scale,config.edgefactor,options,graph);
+    }
+
+    int listener=openListener(config.socketPath);
+    std::map<int,Client> clients;
+    std::vector<PendingQuery> pending;
+    Clock::time_point batchStart;
+    int nextId=0;
+
+    signal(SIGINT,stopServer);
+    signal(SIGTERM,stopServer);
+    std::cerr<<"GraphServer: "<<graph.nodeCount<<" nodes, "<<graph.arcCount()<<" arcs, listening on "
+             <<config.socketPath<<std::endl;
+    while (running)
+    {
+        std::vector<struct pollfd> fds;
+        std::vector<int> ids;
+        struct pollfd entry;
+        struct timespec timeout;
+        struct timespec * wait=NULL;
+
+        entry.fd=listener;
+        entry.events=POLLIN;
+        fds.push_back(entry);
+        ids.push_back(-1);
+        for (std::map<int,Client>::iterator it=clients.begin();it!=clients.end();++it)
+        {
+            bool readable=!it->second.finished&&backlog(it->second)<MAX_BACKLOG;
+
+            entry.fd=it->second.fd;
+            entry.events=(readable ? POLLIN : 0)|(it->second.output.empty() ? 0 : POLLOUT);
+            fds.push_back(entry);
+            ids.push_back(it->first);
+        }
+        if (!pending.empty())
+        {
+            long elapsed=std::chrono::duration_cast<std::chrono::microseconds>(
+                             Clock::now()-batchStart).count();
+            long remaining=std::max(0L,config.batchWindow-elapsed);
+
+            timeout.tv_sec=remaining/1000000;
+            timeout.tv_nsec=remaining%1000000*1000;
+            wait=&timeout;
+        }
+        if (ppoll(fds.data(),fds.size(),wait,NULL)<0&&errno!=EINTR) break;
+        if (fds[0].revents&POLLIN)
+        {
+            int fd;
+
+            while ((fd=accept(listener,NULL,NULL))>=0)
+            {
+                Client & client=clients[nextId++];
+
+                setNonBlocking(fd);
+                client.fd=fd;
+                client.written=0;
+                client.queued=0;
+                client.finished=false;
+                client.closed=false;
+            }
+        }
+        for (size_t i=1;i<fds.size();i++)
+        {
+            Client & client=clients[ids[i]];
+            bool wasIdle=pending.empty();
+
+            if (fds[i].revents&(POLLIN|POLLHUP|POLLERR))
+            {
+                if (!client.finished) readClient(ids[i],client,pending);
+                else if (fds[i].revents&(POLLHUP|POLLERR)) client.closed=true;
+            }
+            if (fds[i].revents&POLLOUT) flushClient(client);
+            if (wasIdle&&!pending.empty()) batchStart=Clock::now();
+        }
+        if (!pending.empty()&&(pending.size()>=config.batchMax
+                ||Clock::now()-batchStart>=std::chrono::microseconds(config.batchWindow)))
+        {
+            executeBatch(graph,config,pending,clients);
+        }
+        for (std::map<int,Client>::iterator it=clients.begin();it!=clients.end();)
+        {
+            const Client & client=it->second;
+
+            if (client.closed||(client.finished&&client.queued==0&&client.output.empty()))
+            {
+                close(it->second.fd);
+                it=clients.erase(it);
+            } else
+            {
+                ++it;
+            }
+        }
+    }
+    for (std::map<int,Client>::iterator it=clients.begin();it!=clients.end();++it)
+    {
+        close(it->second.fd);
+    }
+    close(listener);
+    unlink(config.socketPath.c_str());
+    if (!config.trace.empty()) saveChromeTrace(config.trace);
+    return 0;
+}
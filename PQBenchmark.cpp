@@ -0,0 +1,560 @@
+/*
+ * File: PQBenchmark.cpp
+ * ---------------------
+ * This program benchmarks the list-based PriorityQueue (Q1), the heap-based PriorityQueue (Q2) and
+ * std::priority_queue under several workload profiles. Every backend replays exactly the same
+ * operation trace, and the results are written to standard output as JSON.
+ *
+ * Usage: PQBenchmark [--size n] [--operations n] [--levels n] [--repetitions n] [--seed n]
+ *                    [--backends list,heap,std] [--profiles random,monotone,discrete,hold,dijkstra]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "error.h"
+#include "perfstats.h"
+#include "vector.h"
+
+/*
+ * Both assignment headers export a class named PriorityQueue. Their dependencies are included
+ * above, so the include guards keep them out of the namespaces below and only the queue itself is
+ * wrapped, which allows the two implementations to live in the same program.
+ */
+
+namespace listpq
+{
+#include "Q1_pqueue_list.h"
+}
+
+namespace heappq
+{
+#include "Q2_pqueue_heap.h"
+}
+
+/*
+ * Section: Allocation tracking
+ * ----------------------------
+ * The global allocation functions are replaced so that the benchmark can report the number of
+ * allocations and the peak number of live heap bytes of each run. Every block carries a small header
+ * that records its size.
+ */
+
+static size_t allocationCount=0;                /* Number of calls to operator new */
+static size_t allocatedBytes=0;                 /* Total number of bytes requested */
+static size_t liveBytes=0;                      /* Bytes currently allocated */
+static size_t peakBytes=0;                      /* High-water mark of liveBytes */
+
+static const size_t HEADER_SIZE=alignof(std::max_align_t);
+
+void * operator new(size_t size)
+{
+    char * block=(char *) std::malloc(size+HEADER_SIZE);
+
+    if (block==NULL) throw std::bad_alloc();
+    *(size_t *) block=size;
+    allocationCount++;
+    allocatedBytes+=size;
+    liveBytes+=size;
+    if (liveBytes>peakBytes) peakBytes=liveBytes;
+    return block+HEADER_SIZE;
+}
+
+void operator delete(void * ptr) noexcept
+{
+    if (ptr==NULL) return;
+
+    void * block=(void *) ((uintptr_t) ptr-HEADER_SIZE);
+
+    liveBytes-=*(size_t *) block;
+    std::free(block);
+}
+
+void operator delete(void * ptr,size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+/*
+ * Type: Operation
+ * ---------------
+ * This type represents one step of a workload trace. An ENQUEUE_RELATIVE operation adds its value to
+ * the priority of the most recently dequeued element, which is how the hold model and event-driven
+ * simulations schedule new work.
+ */
+
+enum OperationType { ENQUEUE, ENQUEUE_RELATIVE, DEQUEUE };
+
+struct Operation
+{
+    OperationType type;
+    double value;
+};
+
+/*
+ * Type: Config
+ * ------------
+ * This type holds the command-line settings of a benchmark run.
+ */
+
+struct Config
+{
+    size_t size;                                /* Number of elements held by the queue */
+    size_t operations;                          /* Steady-state operations for hold and dijkstra */
+    size_t levels;                              /* Distinct priorities in the discrete profile */
+    size_t repetitions;                         /* Throughput runs per backend and profile */
+    unsigned long seed;                         /* Seed shared by all trace generators */
+    std::vector<std::string> backends;
+    std::vector<std::string> profiles;
+};
+
+/*
+ * Type: RunResult
+ * ---------------
+ * This type records the measurements of one backend on one trace.
+ */
+
+struct RunResult
+{
+    double seconds;                             /* Best wall time over all repetitions */
+    double checksum;                            /* Sum of dequeued values */
+    size_t allocations;
+    size_t bytes;
+    size_t peak;
+    std::vector<double> enqueueLatency;         /* Nanoseconds per enqueue */
+    std::vector<double> dequeueLatency;         /* Nanoseconds per dequeue */
+};
+
+/*
+ * Class: StdPriorityQueue<valuetype>
+ * ----------------------------------
+ * This adapter gives std::priority_queue the interface of the assignment queues. Elements with equal
+ * priority leave in insertion order, which matches the behavior of the list-based queue.
+ */
+
+template <typename valuetype>
+class StdPriorityQueue
+{
+public:
+    size_t size() const
+    {
+        return pqueue.size();
+    }
+
+    bool isEmpty() const
+    {
+        return pqueue.empty();
+    }
+
+    void enqueue(const valuetype value,const double priority)
+    {
+        entry e;
+
+        e.data=value;
+        e.priority=priority;
+        e.sequence=sequence++;
+        pqueue.push(e);
+    }
+
+    valuetype dequeue()
+    {
+        if (pqueue.empty()) error("dequeue: empty priority queue");
+
+        valuetype result=pqueue.top().data;
+
+        pqueue.pop();
+        return result;
+    }
+
+private:
+    struct entry
+    {
+        valuetype data;
+        double priority;
+        unsigned long long sequence;
+
+        bool operator<(const entry & other) const
+        {
+            if (priority!=other.priority) return priority>other.priority;
+            return sequence>other.sequence;
+        }
+    };
+
+    std::priority_queue<entry> pqueue;
+    unsigned long long sequence=0;
+};
+
+/*
+ * Section: Trace generators
+ * -------------------------
+ * Each function below produces the operation trace of one workload profile. Priorities double as the
+ * element values so that relative enqueues can be replayed by every backend.
+ */
+
+static void addFillAndDrain(std::vector<Operation> & trace,const std::vector<double> & priorities)
+{
+    for (double p:priorities)
+    {
+        trace.push_back({ENQUEUE,p});
+    }
+    for (size_t i=0;i<priorities.size();i++)
+    {
+        trace.push_back({DEQUEUE,0});
+    }
+}
+
+static std::vector<Operation> randomTrace(const Config & config,std::mt19937_64 & rng)
+{
+    std::uniform_real_distribution<double> dist(0.0,1.0);
+    std::vector<double> priorities(config.size);
+    std::vector<Operation> trace;
+
+    for (double & p:priorities) p=dist(rng);
+    addFillAndDrain(trace,priorities);
+    return trace;
+}
+
+static std::vector<Operation> monotoneTrace(const Config & config,std::mt19937_64 &)
+{
+    std::vector<double> priorities(config.size);
+    std::vector<Operation> trace;
+
+    for (size_t i=0;i<config.size;i++) priorities[i]=(double) i;
+    addFillAndDrain(trace,priorities);
+    return trace;
+}
+
+static std::vector<Operation> discreteTrace(const Config & config,std::mt19937_64 & rng)
+{
+    std::uniform_int_distribution<size_t> dist(1,config.levels);
+    std::vector<double> priorities(config.size);
+    std::vector<Operation> trace;
+
+    for (double & p:priorities) p=(double) dist(rng);
+    addFillAndDrain(trace,priorities);
+    return trace;
+}
+
+/*
+ * Implementation notes: holdTrace
+ * -------------------------------
+ * The classic hold model keeps the queue at a constant size: every step removes the first element
+ * and reinserts it with an exponentially distributed increment.
+ */
+
+static std::vector<Operation> holdTrace(const Config & config,std::mt19937_64 & rng)
+{
+    std::uniform_real_distribution<double> uniform(0.0,1.0);
+    std::exponential_distribution<double> increment(1.0);
+    std::vector<Operation> trace;
+
+    for (size_t i=0;i<config.size;i++)
+    {
+        trace.push_back({ENQUEUE,uniform(rng)});
+    }
+    for (size_t i=0;i<config.operations;i++)
+    {
+        trace.push_back({DEQUEUE,0});
+        trace.push_back({ENQUEUE_RELATIVE,increment(rng)});
+    }
+    for (size_t i=0;i<config.size;i++)
+    {
+        trace.push_back({DEQUEUE,0});
+    }
+    return trace;
+}
+
+/*
+ * Implementation notes: dijkstraTrace
+ * -----------------------------------
+ * This generator runs Dijkstra's algorithm with lazy deletion on a random graph of config.size
+ * nodes and records the queue operations it performs. Every node has between 2 and 8 outgoing arcs
+ * with uniformly distributed costs, and the search is restarted from an unreached node until at
+ * least config.operations dequeues have been recorded.
+ */
+
+static std::vector<Operation> dijkstraTrace(const Config & config,std::mt19937_64 & rng)
+{
+    size_t n=std::max<size_t>(config.size,2);
+    std::uniform_int_distribution<size_t> degree(2,8);
+    std::uniform_int_distribution<size_t> node(0,n-1);
+    std::uniform_real_distribution<double> cost(1.0,100.0);
+    std::vector<size_t> offsets(n+1,0);
+    std::vector<size_t> targets;
+    std::vector<double> costs;
+    std::vector<Operation> trace;
+    size_t dequeues=0;
+
+    for (size_t v=0;v<n;v++)
+    {
+        size_t d=degree(rng);
+
+        for (size_t i=0;i<d;i++)
+        {
+            targets.push_back(node(rng));
+            costs.push_back(cost(rng));
+        }
+        offsets[v+1]=targets.size();
+    }
+    while (dequeues<config.operations)
+    {
+        std::vector<double> distance(n,-1.0);
+        std::priority_queue<std::pair<double,size_t>,std::vector<std::pair<double,size_t>>,
+                std::greater<std::pair<double,size_t>>> frontier;
+        size_t source=node(rng);
+
+        distance[source]=0.0;
+        frontier.push({0.0,source});
+        trace.push_back({ENQUEUE,0.0});
+        while (!frontier.empty())
+        {
+            std::pair<double,size_t> top=frontier.top();
+
+            frontier.pop();
+            trace.push_back({DEQUEUE,0});
+            dequeues++;
+            if (top.first>distance[top.second]) continue;
+            for (size_t i=offsets[top.second];i<offsets[top.second+1];i++)
+            {
+                double d=top.first+costs[i];
+
+                if (distance[targets[i]]<0||d<distance[targets[i]])
+                {
+                    distance[targets[i]]=d;
+                    frontier.push({d,targets[i]});
+                    trace.push_back({ENQUEUE,d});
+                }
+            }
+        }
+    }
+    return trace;
+}
+
+static std::vector<Operation> makeTrace(const std::string & profile,const Config & config)
+{
+    std::mt19937_64 rng(config.seed);
+
+    if (profile=="random") return randomTrace(config,rng);
+    if (profile=="monotone") return monotoneTrace(config,rng);
+    if (profile=="discrete") return discreteTrace(config,rng);
+    if (profile=="hold") return holdTrace(config,rng);
+    if (profile=="dijkstra") return dijkstraTrace(config,rng);
+    error("PQBenchmark: unknown profile " + profile);
+}
+
+/*
+ * Function: replay
+ * Usage: double checksum=replay(pqueue,trace,result,timed);
+ * ---------------------------------------------------------
+ * Applies the trace to an empty queue and returns the sum of the dequeued values. If timed is true,
+ * every operation is timed individually and the latencies are appended to result.
+ */
+
+template <typename queuetype>
+double replay(queuetype & pqueue,const std::vector<Operation> & trace,RunResult & result,bool timed)
+{
+    typedef std::chrono::steady_clock clock;
+    double checksum=0;
+    double last=0;
+
+    for (const Operation & op:trace)
+    {
+        clock::time_point start;
+
+        if (timed) start=clock::now();
+        if (op.type==DEQUEUE)
+        {
+            last=pqueue.dequeue();
+            checksum+=last;
+        } else
+        {
+            double priority=(op.type==ENQUEUE) ? op.value : last+op.value;
+
+            pqueue.enqueue(priority,priority);
+        }
+        if (timed)
+        {
+            double ns=std::chrono::duration<double,std::nano>(clock::now()-start).count();
+
+            if (op.type==DEQUEUE) result.dequeueLatency.push_back(ns);
+            else result.enqueueLatency.push_back(ns);
+        }
+    }
+    return checksum;
+}
+
+/*
+ * Function: measure
+ * Usage: RunResult result=measure<queuetype>(trace,config);
+ * ---------------------------------------------------------
+ * Runs the trace config.repetitions times for throughput and memory, then once more with per
+ * operation timing for the latency distribution.
+ */
+
+template <typename queuetype>
+RunResult measure(const std::vector<Operation> & trace,const Config & config)
+{
+    typedef std::chrono::steady_clock clock;
+    RunResult result;
+    size_t enqueues=0;
+
+    for (const Operation & op:trace)
+    {
+        if (op.type!=DEQUEUE) enqueues++;
+    }
+    result.seconds=-1;
+    for (size_t rep=0;rep<config.repetitions;rep++)
+    {
+        size_t allocations=allocationCount;
+        size_t bytes=allocatedBytes;
+        size_t baseline=liveBytes;
+
+        peakBytes=liveBytes;
+
+        clock::time_point start=clock::now();
+
+        {
+            queuetype pqueue;
+
+            result.checksum=replay(pqueue,trace,result,false);
+        }
+
+        double seconds=std::chrono::duration<double>(clock::now()-start).count();
+
+        if (result.seconds<0||seconds<result.seconds) result.seconds=seconds;
+        result.allocations=allocationCount-allocations;
+        result.bytes=allocatedBytes-bytes;
+        result.peak=peakBytes-baseline;
+    }
+    result.enqueueLatency.reserve(enqueues);
+    result.dequeueLatency.reserve(trace.size()-enqueues);
+    {
+        queuetype pqueue;
+
+        replay(pqueue,trace,result,true);
+    }
+    return result;
+}
+
+/*
+ * Function: writeLatency
+ * Usage: writeLatency(os,samples);
+ * --------------------------------
+ * Writes the percentiles of a latency sample as a JSON object. The samples are sorted in place.
+ */
+
+static void writeLatency(std::ostream & os,std::vector<double> & samples)
+{
+    static const double PERCENTILES[]={50,90,99,99.9};
+    static const char * const NAMES[]={"p50","p90","p99","p999"};
+
+    os<<"{\"count\":"<<samples.size();
+    if (!samples.empty())
+    {
+        std::sort(samples.begin(),samples.end());
+        for (size_t i=0;i<4;i++)
+        {
+            size_t k=(size_t) (PERCENTILES[i]/100.0*(samples.size()-1));
+
+            os<<",\""<<NAMES[i]<<"\":"<<samples[k];
+        }
+        os<<",\"max\":"<<samples.back();
+    }
+    os<<"}";
+}
+
+static std::vector<std::string> splitList(const std::string & str)
+{
+    std::vector<std::string> result;
+    size_t start=0;
+
+    while (start<=str.size())
+    {
+        size_t comma=str.find(',',start);
+
+        if (comma==std::string::npos) comma=str.size();
+        if (comma>start) result.push_back(str.substr(start,comma-start));
+        start=comma+1;
+    }
+    return result;
+}
+
+static Config parseArguments(int argc,char * argv[])
+{
+    Config config;
+
+    config.size=10000;
+    config.operations=100000;
+    config.levels=8;
+    config.repetitions=3;
+    config.seed=12345;
+    config.backends=splitList("list,heap,std");
+    config.profiles=splitList("random,monotone,discrete,hold,dijkstra");
+    for (int i=1;i<argc;i++)
+    {
+        std::string arg=argv[i];
+
+        if (i+1>=argc) error("PQBenchmark: missing value for " + arg);
+
+        std::string value=argv[++i];
+
+        if (arg=="--size") config.size=std::stoul(value);
+        else if (arg=="--operations") config.operations=std::stoul(value);
+        else if (arg=="--levels") config.levels=std::max<size_t>(1,std::stoul(value));
+        else if (arg=="--repetitions") config.repetitions=std::max<size_t>(1,std::stoul(value));
+        else if (arg=="--seed") config.seed=std::stoul(value);
+        else if (arg=="--backends") config.backends=splitList(value);
+        else if (arg=="--profiles") config.profiles=splitList(value);
+        else error("PQBenchmark: unknown option " + arg);
+    }
+    return config;
+}
+
+int main(int argc,char * argv[])
+{
+    Config config=parseArguments(argc,argv);
+    std::ostream & os=std::cout;
+    bool first=true;
+
+    os.precision(9);
+    os<<"{\"benchmark\":\"pqueue\",\"config\":{\"size\":"<<config.size
+      <<",\"operations\":"<<config.operations<<",\"levels\":"<<config.levels
+      <<",\"repetitions\":"<<config.repetitions<<",\"seed\":"<<config.seed<<"},\"results\":[";
+    for (const std::string & profile:config.profiles)
+    {
+        std::vector<Operation> trace=makeTrace(profile,config);
+
+        for (const std::string & backend:config.backends)
+        {
+            RunResult result;
+
+            if (backend=="list") result=measure<listpq::PriorityQueue<double>>(trace,config);
+            else if (backend=="heap") result=measure<heappq::PriorityQueue<double>>(trace,config);
+            else if (backend=="std") result=measure<StdPriorityQueue<double>>(trace,config);
+            else error("PQBenchmark: unknown backend " + backend);
+            if (!first) os<<",";
+            first=false;
+            os<<"\n{\"backend\":\""<<backend<<"\",\"profile\":\""<<profile<<"\""
+              <<",\"operations\":"<<trace.size()<<",\"seconds\":"<<result.seconds
+              <<",\"ops_per_second\":"<<trace.size()/std::max(result.seconds,1e-12)
+              <<",\"checksum\":"<<result.checksum
+              <<",\"allocations\":"<<result.allocations<<",\"allocated_bytes\":"<<result.bytes
+              <<",\"peak_bytes\":"<<result.peak<<",\"latency_ns\":{\"enqueue\":";
+            writeLatency(os,result.enqueueLatency);
+            os<<",\"dequeue\":";
+            writeLatency(os,result.dequeueLatency);
+            os<<"}}";
+        }
+    }
+    os<<"\n]}"<<std::endl;
+    return 0;
+}
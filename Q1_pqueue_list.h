@@ -10,6 +10,7 @@
 #define _q1_pqueue_list_h
 
 #include "error.h"
+#include "perfstats.h"
 
 /*
  * Class: PriorityQueue<pqueuetype>
@@ -73,20 +74,21 @@ public:
  * Method: enqueue
  * Usage: pqueue.enqueue(value,priority);
  * --------------------------------------
- * Adds value to the end of a hierarchy in the priority queue according to the priority.
+ * Adds value to the end of a hierarchy in the priority queue according to the priority. If stats is
+ * not NULL and the program is compiled with GRAPH_INSTRUMENT, the counters of the call are added to it.
  */
 
-    void enqueue(const pqueuetype value,const double priority);
+    void enqueue(const pqueuetype value,const double priority,PerfStats * stats=NULL);
 
 /*
  * Method: dequeue
  * Usage: pqueuetype first=pqueue.dequeue();
  * -----------------------------------------
  * Removes and return the first item in the priority queue. This method signals an error if called on
- * an empty priority queue.
+ * an empty priority queue. The optional stats argument works as for enqueue.
  */
 
-    pqueuetype dequeue();
+    pqueuetype dequeue(PerfStats * stats=NULL);
 
 /*
  * Method: peek
@@ -221,8 +223,9 @@ void PriorityQueue<pqueuetype>::clear()
  */
 
 template <typename pqueuetype>
-void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double priority)
+void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double priority,PerfStats * stats)
 {
+    PERF_SCOPE(stats);
     cell * cp=new cell;
 
     cp->data=value;
@@ -246,6 +249,7 @@ void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double prio
         while (priority>=rank->link->priority)
         {
             rank=rank->link;
+            PERF_COUNT(stats,siftSteps,1);
         }
         cp->link=rank->link;
         rank->link=cp;
@@ -263,8 +267,9 @@ void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double prio
  */
 
 template <typename pqueuetype>
-pqueuetype PriorityQueue<pqueuetype>::dequeue()
+pqueuetype PriorityQueue<pqueuetype>::dequeue(PerfStats * stats)
 {
+    PERF_SCOPE(stats);
     if (isEmpty()) error("dequeue: empty priority queue");
 
     cell * cp=head;
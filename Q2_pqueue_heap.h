@@ -11,6 +11,7 @@
 
 #include "vector.h"
 #include "error.h"
+#include "perfstats.h"
 
 /* Function prototypes */
 
@@ -103,20 +104,21 @@ public:
  * Method: enqueue
  * Usage: pqueue.enqueue(value,priority);
  * --------------------------------------
- * Adds value to the end of a hierarchy in the priority queue according to the priority.
+ * Adds value to the end of a hierarchy in the priority queue according to the priority. If stats is
+ * not NULL and the program is compiled with GRAPH_INSTRUMENT, the counters of the call are added to it.
  */
 
-    void enqueue(const pqueuetype value,const double priority);
+    void enqueue(const pqueuetype value,const double priority,PerfStats * stats=NULL);
 
 /*
  * Method: dequeue
  * Usage: pqueuetype first=pqueue.dequeue();
  * -----------------------------------------
  * Removes and return the first item in the priority queue. This method signals an error if called on
- * an empty priority queue.
+ * an empty priority queue. The optional stats argument works as for enqueue.
  */
 
-    pqueuetype dequeue();
+    pqueuetype dequeue(PerfStats * stats=NULL);
 
 /*
  * Method: peek
@@ -262,8 +264,9 @@ bool PriorityQueue<pqueuetype>::isEmpty() const
  */
 
 template <typename pqueuetype>
-void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double priority)
+void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double priority,PerfStats * stats)
 {
+    PERF_SCOPE(stats);
     cell c;
     size_t anchor=count;
 
@@ -278,6 +281,7 @@ void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double prio
         pqueue[anchor]=pqueue[parent(anchor)];
         pqueue[parent(anchor)]=tmp;
         anchor=parent(anchor);
+        PERF_COUNT(stats,siftSteps,1);
     }
     count++;
 }
@@ -291,15 +295,17 @@ void PriorityQueue<pqueuetype>::enqueue(const pqueuetype value,const double prio
  * Vector if the remaining count is an even number to ensure no cell has only one child. After moving,
  * the moved cell will be exchanged with the child cell with a smaller priority if its priority is not
  * the smallest among its children and itself. Else, if it encounters children with the same priority,
- * the exchange will still happen if its rank is higher than its child's. If the moved cell has
- * children with the same priority, the child with lower rank will be exchanged. This procedure will
+ * the exchange will still happen if its rank is higher than its child's. In that case only a child
+ * with the same priority may be exchanged, the one with lower rank if both qualify, since moving up
+ * a child with a larger priority would break the heap order. This procedure will
  * continue until the moved cell's priority is no smaller than both of its children's and the rank is
  * smaller than children with the same priority. The duplicated cell will be removed at last.
  */
 
 template <typename pqueuetype>
-pqueuetype PriorityQueue<pqueuetype>::dequeue()
+pqueuetype PriorityQueue<pqueuetype>::dequeue(PerfStats * stats)
 {
+    PERF_SCOPE(stats);
     if (isEmpty()) error("dequeue: empty priority queue");
 
     pqueuetype result=pqueue[0].data;
@@ -322,6 +328,7 @@ pqueuetype PriorityQueue<pqueuetype>::dequeue()
         }
         while (count>=2*anchor+2)
         {
+            PERF_COUNT(stats,comparisons,2);
             if ((pqueue[anchor].priority<pqueue[leftchild(anchor)].priority)
                     &&(pqueue[anchor].priority<pqueue[rightchild(anchor)].priority)) break;
             if ((pqueue[anchor].priority==pqueue[leftchild(anchor)].priority)
@@ -371,7 +378,9 @@ pqueuetype PriorityQueue<pqueuetype>::dequeue()
                 }
             } else
             {
-                if (pqueue[leftchild(anchor)].rank<pqueue[rightchild(anchor)].rank)
+                if ((pqueue[leftchild(anchor)].priority==pqueue[anchor].priority)
+                        &&((pqueue[rightchild(anchor)].priority!=pqueue[anchor].priority)
+                        ||(pqueue[leftchild(anchor)].rank<pqueue[rightchild(anchor)].rank)))
                 {
                     cell tmp=pqueue[anchor];
 
@@ -387,6 +396,7 @@ pqueuetype PriorityQueue<pqueuetype>::dequeue()
                     anchor=rightchild(anchor);
                 }
             }
+            PERF_COUNT(stats,siftSteps,1);
         }
         if (completed)
         {
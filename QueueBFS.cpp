@@ -4,8 +4,18 @@
  * This program implements the breadth-first search algorithm using an explicit queue.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "error.h"
 #include "graphtypes.h"
+#include "mpmcqueue.h"
 #include "queue.h"
+#include "searchbudget.h"
+#include "threadpool.h"
+#include "tracing.h"
+#include "traversal.h"
 
 /*
  * Function: breadthFirstSearch
@@ -14,8 +24,11 @@
  * Implements the breadth-first search algorithm using an explict queue.
  */
 
-void breadthFirstSearch(Node * start)
+void breadthFirstSearch(Node * start,PerfStats * stats,SearchBudget * budget)
 {
+    TRACE_SCOPE("breadthFirstSearch");
+    PERF_SCOPE(stats);
+    BudgetMeter meter(budget);
     Queue<Node *> cities;
     Set<Node *> visited;
 
@@ -25,6 +38,9 @@ void breadthFirstSearch(Node * start)
         Node * city=cities.dequeue();
 
         visited.add(city);
+        PERF_COUNT(stats,nodesVisited,1);
+        PERF_COUNT(stats,arcsScanned,city->arcs.size());
+        PERF_COUNT(stats,visitedProbes,city->arcs.size()+1);
         for (Arc * link:city->arcs)
         {
             if (!visited.contains(link->finish))
@@ -34,5 +50,420 @@ void breadthFirstSearch(Node * start)
             }
         }
         std::cout<<city->name<<std::endl;
+        if (!meter.tick(1+city->arcs.size())) break;
+    }
+}
+
+/*
+ * Implementation notes: breadthFirstSearch on a CSRGraph
+ * ------------------------------------------------------
+ * The CSR version processes the search one level at a time. The parent array doubles as the
+ * visited set, so each node costs a single array access rather than a set lookup. If the budget runs
+ * out, the search stops after the current node; parent then holds every node discovered so far.
+ */
+
+size_t breadthFirstSearch(const CSRGraph & graph,uint32_t start,std::vector<uint32_t> & parent,
+                          PerfStats * stats,SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("breadthFirstSearch: start node out of range");
+    TRACE_SCOPE("breadthFirstSearch");
+    PERF_SCOPE(stats);
+    BudgetMeter meter(budget);
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> next;
+    size_t scanned=0;
+    bool running=true;
+
+    parent.assign(graph.nodeCount,NO_NODE);
+    parent[start]=start;
+    frontier.push_back(start);
+    while (running&&!frontier.empty())
+    {
+        TRACE_SCOPE_VALUE("bfs.level",frontier.size());
+
+        next.clear();
+        for (uint32_t city:frontier)
+        {
+            for (size_t i=graph.offsets[city];i<graph.offsets[city+1];i++)
+            {
+                uint32_t link=graph.targets[i];
+
+                if (parent[link]==NO_NODE)
+                {
+                    parent[link]=city;
+                    next.push_back(link);
+                }
+            }
+            scanned+=graph.degree(city);
+            if (!meter.tick(1+graph.degree(city)))
+            {
+                running=false;
+                break;
+            }
+        }
+        PERF_COUNT(stats,nodesVisited,frontier.size());
+        frontier.swap(next);
+    }
+    PERF_COUNT(stats,arcsScanned,scanned);
+    PERF_COUNT(stats,visitedProbes,scanned);
+    return scanned;
+}
+
+/*
+ * Implementation notes: parallelBreadthFirstSearch
+ * ------------------------------------------------
+ * Each level is divided among the threads of the current pool with parallelFor. A node is claimed
+ * by the first thread whose compare-and-swap on its parent entry succeeds, so every node enters the
+ * next frontier exactly once. Threads collect the nodes they claim in a local buffer and copy it into
+ * the shared frontier with a single atomic reservation per piece. Which of several parents wins a
+ * node depends on timing, so the tree may differ from run to run, but every tree is a valid
+ * breadth-first tree. Every piece of a level keeps its own budget meter and charges it when done;
+ * once the budget is exhausted each piece stops at its next check and no further level is started.
+ */
+
+const size_t PARALLEL_BFS_GRAIN=256;
+
+size_t parallelBreadthFirstSearch(const CSRGraph & graph,uint32_t start,
+                                  std::vector<uint32_t> & parent,PerfStats * stats,
+                                  SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("parallelBreadthFirstSearch: start node out of range");
+    TRACE_SCOPE("parallelBreadthFirstSearch");
+    PERF_SCOPE(stats);
+    ThreadPool & pool=ThreadPool::current();
+    std::unique_ptr<std::atomic<uint32_t>[]> claimed(new std::atomic<uint32_t>[graph.nodeCount]);
+    std::vector<uint32_t> frontier(graph.nodeCount);
+    std::vector<uint32_t> next(graph.nodeCount);
+    size_t frontierSize=1;
+    std::atomic<size_t> nextSize(0);
+    std::atomic<size_t> scanned(0);
+
+    pool.parallelFor(0,graph.nodeCount,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++) claimed[v].store(NO_NODE,std::memory_order_relaxed);
+    },4096);
+    claimed[start].store(start,std::memory_order_relaxed);
+    frontier[0]=start;
+    while (frontierSize>0&&(budget==NULL||!budget->isExhausted()))
+    {
+        TRACE_SCOPE_VALUE("pbfs.level",frontierSize);
+
+        nextSize.store(0,std::memory_order_relaxed);
+        pool.parallelFor(0,frontierSize,[&](size_t first,size_t last)
+        {
+            BudgetMeter meter(budget);
+            std::vector<uint32_t> local;
+            size_t arcs=0;
+
+            for (size_t k=first;k<last;k++)
+            {
+                uint32_t city=frontier[k];
+
+                for (size_t i=graph.offsets[city];i<graph.offsets[city+1];i++)
+                {
+                    uint32_t link=graph.targets[i];
+                    uint32_t expected=NO_NODE;
+
+                    if (claimed[link].load(std::memory_order_relaxed)==NO_NODE
+                        &&claimed[link].compare_exchange_strong(expected,city,
+                                                                std::memory_order_relaxed))
+                    {
+                        local.push_back(link);
+                    }
+                }
+                arcs+=graph.degree(city);
+                if (!meter.tick(1+graph.degree(city))) break;
+            }
+            meter.flush();
+
+            size_t pos=nextSize.fetch_add(local.size(),std::memory_order_relaxed);
+
+            std::copy(local.begin(),local.end(),next.begin()+pos);
+            scanned.fetch_add(arcs,std::memory_order_relaxed);
+        },PARALLEL_BFS_GRAIN);
+        PERF_COUNT(stats,nodesVisited,frontierSize);
+        frontier.swap(next);
+        frontierSize=nextSize.load(std::memory_order_relaxed);
+    }
+    parent.resize(graph.nodeCount);
+    pool.parallelFor(0,graph.nodeCount,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++) parent[v]=claimed[v].load(std::memory_order_relaxed);
+    },4096);
+    PERF_COUNT(stats,arcsScanned,scanned.load());
+    PERF_COUNT(stats,visitedProbes,scanned.load());
+    return scanned.load();
+}
+
+/*
+ * Implementation notes: pipelinedBreadthFirstSearch
+ * -------------------------------------------------
+ * This version keeps each frontier in an MPMCQueue instead of an array. One task per pool thread
+ * repeatedly takes a batch of nodes from the current level's queue, claims their unvisited
+ * neighbors with compare-and-swap and passes them to the next level's queue in batches, so the
+ * threads act as consumers of one level and producers of the next at the same time. A queue as large
+ * as the graph can never fill, because every node enters a frontier at most once.
+ */
+
+const size_t PIPELINE_BATCH=64;
+
+static void flushBatch(MPMCQueue<uint32_t> & queue,const uint32_t * values,size_t count)
+{
+    size_t done=0;
+
+    while (done<count)
+    {
+        size_t n=queue.enqueueBatch(values+done,count-done);
+
+        if (n==0) std::this_thread::yield();
+        done+=n;
+    }
+}
+
+size_t pipelinedBreadthFirstSearch(const CSRGraph & graph,uint32_t start,
+                                   std::vector<uint32_t> & parent,PerfStats * stats,
+                                   SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("pipelinedBreadthFirstSearch: start node out of range");
+    TRACE_SCOPE("pipelinedBreadthFirstSearch");
+    PERF_SCOPE(stats);
+    ThreadPool & pool=ThreadPool::current();
+    std::unique_ptr<std::atomic<uint32_t>[]> claimed(new std::atomic<uint32_t>[graph.nodeCount]);
+    MPMCQueue<uint32_t> front(graph.nodeCount);
+    MPMCQueue<uint32_t> back(graph.nodeCount);
+    MPMCQueue<uint32_t> * current=&front;
+    MPMCQueue<uint32_t> * next=&back;
+    std::atomic<size_t> scanned(0);
+    std::atomic<size_t> visited(0);
+
+    pool.parallelFor(0,graph.nodeCount,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++) claimed[v].store(NO_NODE,std::memory_order_relaxed);
+    },4096);
+    claimed[start].store(start,std::memory_order_relaxed);
+    current->enqueue(start);
+    while (!current->isEmpty()&&(budget==NULL||!budget->isExhausted()))
+    {
+        TRACE_SCOPE_VALUE("pipeline.level",current->size());
+        TaskGroup group(pool);
+
+        for (int t=0;t<pool.size();t++)
+        {
+            group.run([&]()
+            {
+                BudgetMeter meter(budget);
+                uint32_t input[PIPELINE_BATCH];
+                uint32_t output[PIPELINE_BATCH];
+                size_t produced=0,arcs=0,nodes=0;
+                size_t count;
+                bool running=true;
+
+                while (running&&(count=current->dequeueBatch(input,PIPELINE_BATCH))>0)
+                {
+                    for (size_t k=0;k<count;k++)
+                    {
+                        uint32_t city=input[k];
+
+                        for (size_t i=graph.offsets[city];i<graph.offsets[city+1];i++)
+                        {
+                            uint32_t link=graph.targets[i];
+                            uint32_t expected=NO_NODE;
+
+                            if (claimed[link].load(std::memory_order_relaxed)==NO_NODE
+                                &&claimed[link].compare_exchange_strong(expected,city,
+                                                                        std::memory_order_relaxed))
+                            {
+                                output[produced++]=link;
+                                if (produced==PIPELINE_BATCH)
+                                {
+                                    flushBatch(*next,output,produced);
+                                    produced=0;
+                                }
+                            }
+                        }
+                        arcs+=graph.degree(city);
+                        if (!meter.tick(1+graph.degree(city))) running=false;
+                    }
+                    nodes+=count;
+                }
+                flushBatch(*next,output,produced);
+                meter.flush();
+                scanned.fetch_add(arcs,std::memory_order_relaxed);
+                visited.fetch_add(nodes,std::memory_order_relaxed);
+            });
+        }
+        group.wait();
+        std::swap(current,next);
+    }
+    parent.resize(graph.nodeCount);
+    pool.parallelFor(0,graph.nodeCount,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++) parent[v]=claimed[v].load(std::memory_order_relaxed);
+    },4096);
+    PERF_COUNT(stats,nodesVisited,visited.load());
+    PERF_COUNT(stats,arcsScanned,scanned.load());
+    PERF_COUNT(stats,visitedProbes,scanned.load());
+    return scanned.load();
+}
+
+/*
+ * Implementation notes: multiSourceBFS
+ * ------------------------------------
+ * This function follows the MS-BFS technique of Then et al. Up to 64 searches run at once, one per
+ * bit of a 64-bit word: seen[v] records which searches have reached v, and visit[v] which of them
+ * reached v in the current level. Scanning the arcs of v once advances every search in visit[v],
+ * so searches that overlap share their memory traffic. Each batch stops as soon as every query in it
+ * has found its target or all of its searches are exhausted. The budget covers all batches together.
+ * A query is aborted only if its own batch was cut short before answering it, or never ran, so a
+ * query found unreachable in an earlier batch stays complete when a later batch runs out.
+ */
+
+void multiSourceBFS(const CSRGraph & graph,const std::vector<uint32_t> & sources,
+                    const std::vector<uint32_t> & targets,std::vector<int> & hops,
+                    SearchBudget * budget,std::vector<SearchStatus> * statuses)
+{
+    TRACE_SCOPE_VALUE("multiSourceBFS",sources.size());
+    BudgetMeter meter(budget);
+    bool running=true;
+
+    if (sources.size()!=targets.size()) error("multiSourceBFS: sources and targets differ in length");
+
+    std::vector<uint64_t> seen(graph.nodeCount);
+    std::vector<uint64_t> visit(graph.nodeCount);
+    std::vector<uint64_t> visitNext(graph.nodeCount);
+
+    hops.assign(sources.size(),-1);
+    if (statuses!=NULL) statuses->assign(sources.size(),SEARCH_COMPLETE);
+    for (size_t base=0;base<sources.size();base+=64)
+    {
+        size_t batch=std::min<size_t>(64,sources.size()-base);
+        uint64_t pending=0;
+        bool active=true;
+
+        if (!running)
+        {
+            if (statuses!=NULL)
+            {
+                std::fill(statuses->begin()+base,statuses->begin()+base+batch,budget->status());
+            }
+            continue;
+        }
+
+        std::fill(seen.begin(),seen.end(),0);
+        std::fill(visit.begin(),visit.end(),0);
+        for (size_t i=0;i<batch;i++)
+        {
+            uint32_t s=sources[base+i];
+
+            if (s>=graph.nodeCount||targets[base+i]>=graph.nodeCount)
+            {
+                error("multiSourceBFS: node out of range");
+            }
+            seen[s]|=1ULL<<i;
+            visit[s]|=1ULL<<i;
+            if (s==targets[base+i]) hops[base+i]=0;
+            else pending|=1ULL<<i;
+        }
+        for (int level=1;running&&pending!=0&&active;level++)
+        {
+            TRACE_SCOPE_VALUE("msbfs.level",level);
+
+            active=false;
+            std::fill(visitNext.begin(),visitNext.end(),0);
+            for (size_t v=0;v<graph.nodeCount;v++)
+            {
+                if (visit[v]==0) continue;
+                for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+                {
+                    uint32_t link=graph.targets[i];
+                    uint64_t reached=visit[v]&~seen[link];
+
+                    if (reached!=0)
+                    {
+                        visitNext[link]|=reached;
+                        seen[link]|=reached;
+                        active=true;
+                    }
+                }
+                if (!meter.tick(1+graph.degree(v)))
+                {
+                    running=false;
+                    break;
+                }
+            }
+            visit.swap(visitNext);
+            for (size_t i=0;i<batch;i++)
+            {
+                uint64_t bit=1ULL<<i;
+
+                if ((pending&bit)!=0&&(seen[targets[base+i]]&bit)!=0)
+                {
+                    hops[base+i]=level;
+                    pending&=~bit;
+                }
+            }
+        }
+        for (size_t i=0;!running&&statuses!=NULL&&i<batch;i++)
+        {
+            if ((pending&(1ULL<<i))!=0) (*statuses)[base+i]=budget->status();
+        }
+    }
+}
+
+/*
+ * Implementation notes: breadthFirstLevels
+ * ----------------------------------------
+ * The search appends each level to order and scans it as a whole, so the level boundaries come for
+ * free and order doubles as the queue. distance is the visited set. A search stopped by its budget
+ * closes the partial level it was building, so levels still delimits every level in order.
+ */
+
+uint32_t breadthFirstLevels(const CSRGraph & graph,uint32_t start,std::vector<uint32_t> & distance,
+                            std::vector<uint32_t> & order,std::vector<size_t> & levels,
+                            PerfStats * stats,SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("breadthFirstLevels: start node out of range");
+    PERF_SCOPE(stats);
+    BudgetMeter meter(budget);
+    size_t scanned=0;
+    bool running=true;
+
+    distance.assign(graph.nodeCount,NO_NODE);
+    order.clear();
+    levels.clear();
+    distance[start]=0;
+    order.push_back(start);
+    levels.push_back(0);
+    for (uint32_t level=0;;level++)
+    {
+        size_t first=levels.back();
+        size_t last=order.size();
+
+        levels.push_back(last);
+        for (size_t k=first;running&&k<last;k++)
+        {
+            uint32_t city=order[k];
+
+            for (size_t i=graph.offsets[city];i<graph.offsets[city+1];i++)
+            {
+                uint32_t link=graph.targets[i];
+
+                if (distance[link]==NO_NODE)
+                {
+                    distance[link]=level+1;
+                    order.push_back(link);
+                }
+            }
+            scanned+=graph.degree(city);
+            if (!meter.tick(1+graph.degree(city))) running=false;
+        }
+        if (order.size()>last&&!running) levels.push_back(order.size());
+        if (order.size()==last||!running)
+        {
+            PERF_COUNT(stats,nodesVisited,order.size());
+            PERF_COUNT(stats,arcsScanned,scanned);
+            PERF_COUNT(stats,visitedProbes,scanned);
+            return (uint32_t) levels.size()-2;
+        }
     }
 }
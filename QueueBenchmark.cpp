@@ -0,0 +1,373 @@
+/*
+ * File: QueueBenchmark.cpp
+ * ------------------------
+ * This program compares the Stanford Queue, std::queue and the lock-free MPMCQueue. The first part
+ * runs every backend on one thread, filling and draining the queue in rounds, with the MPMCQueue
+ * also moving values in batches of several sizes. The second part measures throughput with several
+ * producer and consumer threads, where the MPMCQueue competes with a std::queue guarded by a mutex.
+ * The results are written to standard output as JSON.
+ *
+ * Usage: QueueBenchmark [--operations n] [--capacity n] [--repetitions n]
+ *                       [--backends stanford,std,mpmc] [--batches 1,8,64] [--threads 1x1,2x2,4x4]
+ *
+ * Each entry of --threads gives the number of producers and consumers.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "error.h"
+#include "mpmcqueue.h"
+#include "queue.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+ * Type: Config
+ * ------------
+ * This type holds the command-line settings of a benchmark run.
+ */
+
+struct Config
+{
+    size_t operations;                          /* Values passed through the queue per run */
+    size_t capacity;                            /* Values held at most; the fill/drain round size */
+    size_t repetitions;                         /* Runs per measurement; the best one is reported */
+    std::vector<std::string> backends;
+    std::vector<size_t> batches;
+    std::vector<std::pair<int,int> > threads;   /* Producer and consumer counts */
+};
+
+/*
+ * Class: LockedQueue<valuetype>
+ * -----------------------------
+ * This class is the conventional way of sharing a queue between threads: a std::queue whose
+ * operations are serialized by a mutex. It has the try interface of MPMCQueue.
+ */
+
+template <typename valuetype>
+class LockedQueue
+{
+public:
+    explicit LockedQueue(size_t capacity) : limit(capacity) {}
+
+    bool tryEnqueue(const valuetype & value)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (queue.size()>=limit) return false;
+        queue.push(value);
+        return true;
+    }
+
+    bool tryDequeue(valuetype & value)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (queue.empty()) return false;
+        value=queue.front();
+        queue.pop();
+        return true;
+    }
+
+private:
+    std::mutex lock;
+    std::queue<valuetype> queue;
+    size_t limit;
+};
+
+/*
+ * Section: Single-threaded rounds
+ * -------------------------------
+ * Each function below passes config.operations values through its queue in rounds of at most
+ * config.capacity enqueues followed by as many dequeues, and returns the sum of the values it
+ * dequeued so that the work cannot be optimized away.
+ */
+
+static uint64_t runStanford(const Config & config)
+{
+    Queue<uint32_t> queue;
+    uint64_t checksum=0;
+
+    for (size_t done=0;done<config.operations;)
+    {
+        size_t round=std::min(config.capacity,config.operations-done);
+
+        for (size_t i=0;i<round;i++) queue.enqueue((uint32_t) (done+i));
+        for (size_t i=0;i<round;i++) checksum+=queue.dequeue();
+        done+=round;
+    }
+    return checksum;
+}
+
+static uint64_t runStd(const Config & config)
+{
+    std::queue<uint32_t> queue;
+    uint64_t checksum=0;
+
+    for (size_t done=0;done<config.operations;)
+    {
+        size_t round=std::min(config.capacity,config.operations-done);
+
+        for (size_t i=0;i<round;i++) queue.push((uint32_t) (done+i));
+        for (size_t i=0;i<round;i++)
+        {
+            checksum+=queue.front();
+            queue.pop();
+        }
+        done+=round;
+    }
+    return checksum;
+}
+
+static uint64_t runMPMC(const Config & config,size_t batch)
+{
+    MPMCQueue<uint32_t> queue(config.capacity);
+    std::vector<uint32_t> buffer(batch);
+    uint64_t checksum=0;
+
+    for (size_t done=0;done<config.operations;)
+    {
+        size_t round=std::min(config.capacity,config.operations-done);
+
+        if (batch==1)
+        {
+            uint32_t value;
+
+            for (size_t i=0;i<round;i++) queue.tryEnqueue((uint32_t) (done+i));
+            for (size_t i=0;i<round;i++)
+            {
+                queue.tryDequeue(value);
+                checksum+=value;
+            }
+        } else
+        {
+            for (size_t i=0;i<round;i+=batch)
+            {
+                size_t count=std::min(batch,round-i);
+
+                for (size_t k=0;k<count;k++) buffer[k]=(uint32_t) (done+i+k);
+                queue.enqueueBatch(buffer.data(),count);
+            }
+            for (size_t i=0;i<round;)
+            {
+                size_t count=queue.dequeueBatch(buffer.data(),std::min(batch,round-i));
+
+                for (size_t k=0;k<count;k++) checksum+=buffer[k];
+                i+=count;
+            }
+        }
+        done+=round;
+    }
+    return checksum;
+}
+
+/*
+ * Section: Concurrent throughput
+ * ------------------------------
+ * The producers share config.operations values evenly and the consumers take values until all of
+ * them have been dequeued. A thread that finds the queue full or empty yields the processor.
+ */
+
+template <typename queuetype>
+uint64_t runConcurrent(queuetype & queue,const Config & config,int producers,int consumers)
+{
+    std::atomic<size_t> remaining(config.operations);
+    std::atomic<uint64_t> checksum(0);
+    std::vector<std::thread> threads;
+
+    for (int p=0;p<producers;p++)
+    {
+        threads.push_back(std::thread([&,p]()
+        {
+            for (size_t v=p;v<config.operations;v+=producers)
+            {
+                while (!queue.tryEnqueue((uint32_t) v)) std::this_thread::yield();
+            }
+        }));
+    }
+    for (int c=0;c<consumers;c++)
+    {
+        threads.push_back(std::thread([&]()
+        {
+            uint64_t sum=0;
+            uint32_t value;
+
+            while (remaining.load(std::memory_order_relaxed)>0)
+            {
+                if (queue.tryDequeue(value))
+                {
+                    sum+=value;
+                    remaining.fetch_sub(1,std::memory_order_relaxed);
+                } else
+                {
+                    std::this_thread::yield();
+                }
+            }
+            checksum.fetch_add(sum,std::memory_order_relaxed);
+        }));
+    }
+    for (std::thread & thread:threads) thread.join();
+    return checksum.load();
+}
+
+/*
+ * Function: timeBest
+ * Usage: double seconds=timeBest(config,checksum,body);
+ * -----------------------------------------------------
+ * Runs body config.repetitions times and returns the shortest wall time; checksum receives the value
+ * returned by the last run.
+ */
+
+template <typename bodytype>
+double timeBest(const Config & config,uint64_t & checksum,bodytype body)
+{
+    double best=-1;
+
+    for (size_t rep=0;rep<config.repetitions;rep++)
+    {
+        Clock::time_point start=Clock::now();
+
+        checksum=body();
+
+        double seconds=std::chrono::duration<double>(Clock::now()-start).count();
+
+        if (best<0||seconds<best) best=seconds;
+    }
+    return best;
+}
+
+static std::vector<std::string> splitList(const std::string & str)
+{
+    std::vector<std::string> result;
+    size_t start=0;
+
+    while (start<=str.size())
+    {
+        size_t comma=str.find(',',start);
+
+        if (comma==std::string::npos) comma=str.size();
+        if (comma>start) result.push_back(str.substr(start,comma-start));
+        start=comma+1;
+    }
+    return result;
+}
+
+static Config parseArguments(int argc,char * argv[])
+{
+    Config config;
+    std::string batches="1,8,64";
+    std::string threads="1x1,2x2,4x4";
+
+    config.operations=10000000;
+    config.capacity=65536;
+    config.repetitions=3;
+    config.backends=splitList("stanford,std,mpmc");
+    for (int i=1;i<argc;i++)
+    {
+        std::string arg=argv[i];
+
+        if (i+1>=argc) error("QueueBenchmark: missing value for " + arg);
+
+        std::string value=argv[++i];
+
+        if (arg=="--operations") config.operations=std::stoul(value);
+        else if (arg=="--capacity") config.capacity=std::max<size_t>(1,std::stoul(value));
+        else if (arg=="--repetitions") config.repetitions=std::max<size_t>(1,std::stoul(value));
+        else if (arg=="--backends") config.backends=splitList(value);
+        else if (arg=="--batches") batches=value;
+        else if (arg=="--threads") threads=value;
+        else error("QueueBenchmark: unknown option " + arg);
+    }
+    for (const std::string & item:splitList(batches))
+    {
+        config.batches.push_back(std::max<size_t>(1,std::stoul(item)));
+    }
+    for (const std::string & item:splitList(threads))
+    {
+        size_t x=item.find('x');
+
+        if (x==std::string::npos) error("QueueBenchmark: bad thread setting " + item);
+        config.threads.push_back(std::make_pair(std::max(1,std::stoi(item.substr(0,x))),
+                                                std::max(1,std::stoi(item.substr(x+1)))));
+    }
+    return config;
+}
+
+static void writeResult(std::ostream & os,bool & first,const std::string & backend,
+                        const std::string & mode,double seconds,uint64_t checksum,
+                        const Config & config)
+{
+    if (!first) os<<",";
+    first=false;
+    os<<"\n{\"backend\":\""<<backend<<"\",\"mode\":\""<<mode<<"\",\"seconds\":"<<seconds
+      <<",\"ops_per_second\":"<<config.operations/std::max(seconds,1e-12)
+      <<",\"checksum\":"<<checksum<<"}";
+}
+
+int main(int argc,char * argv[])
+{
+    Config config=parseArguments(argc,argv);
+    std::ostream & os=std::cout;
+    bool first=true;
+    uint64_t checksum=0;
+    double seconds;
+
+    os.precision(9);
+    os<<"{\"benchmark\":\"queue\",\"config\":{\"operations\":"<<config.operations
+      <<",\"capacity\":"<<config.capacity<<",\"repetitions\":"<<config.repetitions
+      <<"},\"results\":[";
+    for (const std::string & backend:config.backends)
+    {
+        if (backend=="stanford")
+        {
+            seconds=timeBest(config,checksum,[&]() { return runStanford(config); });
+            writeResult(os,first,backend,"single",seconds,checksum,config);
+        } else if (backend=="std")
+        {
+            seconds=timeBest(config,checksum,[&]() { return runStd(config); });
+            writeResult(os,first,backend,"single",seconds,checksum,config);
+        } else if (backend=="mpmc")
+        {
+            for (size_t batch:config.batches)
+            {
+                seconds=timeBest(config,checksum,[&]() { return runMPMC(config,batch); });
+                writeResult(os,first,backend,"single/batch" + std::to_string(batch),seconds,
+                            checksum,config);
+            }
+        } else
+        {
+            error("QueueBenchmark: unknown backend " + backend);
+        }
+    }
+    for (const std::pair<int,int> & setting:config.threads)
+    {
+        std::string mode=std::to_string(setting.first) + "x" + std::to_string(setting.second);
+
+        seconds=timeBest(config,checksum,[&]()
+        {
+            LockedQueue<uint32_t> queue(config.capacity);
+
+            return runConcurrent(queue,config,setting.first,setting.second);
+        });
+        writeResult(os,first,"locked",mode,seconds,checksum,config);
+        seconds=timeBest(config,checksum,[&]()
+        {
+            MPMCQueue<uint32_t> queue(config.capacity);
+
+            return runConcurrent(queue,config,setting.first,setting.second);
+        });
+        writeResult(os,first,"mpmc",mode,seconds,checksum,config);
+    }
+    os<<"\n]}"<<std::endl;
+    return 0;
+}
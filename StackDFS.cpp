@@ -4,8 +4,12 @@
  * This program reimplements the depth-first search algorithm using an explicit stack.
  */
 
+#include "error.h"
 #include "graphtypes.h"
+#include "searchbudget.h"
 #include "stack.h"
+#include "tracing.h"
+#include "traversal.h"
 
 /*
  * Function: depthFirstSearch
@@ -14,8 +18,11 @@
  * Implements the depth-first search algorithm using an explicit stack.
  */
 
-void depthFirstSearch(Node * start)
+void depthFirstSearch(Node * start,PerfStats * stats,SearchBudget * budget)
 {
+    TRACE_SCOPE("depthFirstSearch");
+    PERF_SCOPE(stats);
+    BudgetMeter meter(budget);
     Stack<Node *> cities;
     Set<Node *> visited;
 
@@ -25,6 +32,9 @@ void depthFirstSearch(Node * start)
         Node * city = cities.pop();
 
         visited.add(city);
+        PERF_COUNT(stats,nodesVisited,1);
+        PERF_COUNT(stats,arcsScanned,city->arcs.size());
+        PERF_COUNT(stats,visitedProbes,city->arcs.size()+1);
         for (Arc * link:city->arcs)
         {
             if (!visited.contains(link->finish))
@@ -34,5 +44,52 @@ void depthFirstSearch(Node * start)
             }
         }
         std::cout<<city->name<<std::endl;
+        if (!meter.tick(1+city->arcs.size())) break;
     }
 }
+
+
+/*
+ * Implementation notes: depthFirstSearch on a CSRGraph
+ * ----------------------------------------------------
+ * The CSR version follows the same discipline as the pointer version, marking nodes when they are
+ * pushed, but keeps the stack in a vector and uses the parent array as the visited set. A search
+ * stopped by its budget leaves the nodes it has discovered in parent.
+ */
+
+size_t depthFirstSearch(const CSRGraph & graph,uint32_t start,std::vector<uint32_t> & parent,
+                        PerfStats * stats,SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("depthFirstSearch: start node out of range");
+    TRACE_SCOPE("depthFirstSearch");
+    PERF_SCOPE(stats);
+    BudgetMeter meter(budget);
+    std::vector<uint32_t> cities;
+    size_t scanned=0;
+
+    parent.assign(graph.nodeCount,NO_NODE);
+    parent[start]=start;
+    cities.push_back(start);
+    while (!cities.empty())
+    {
+        uint32_t city=cities.back();
+
+        cities.pop_back();
+        PERF_COUNT(stats,nodesVisited,1);
+        for (size_t i=graph.offsets[city];i<graph.offsets[city+1];i++)
+        {
+            uint32_t link=graph.targets[i];
+
+            if (parent[link]==NO_NODE)
+            {
+                parent[link]=city;
+                cities.push_back(link);
+            }
+        }
+        scanned+=graph.degree(city);
+        if (!meter.tick(1+graph.degree(city))) break;
+    }
+    PERF_COUNT(stats,arcsScanned,scanned);
+    PERF_COUNT(stats,visitedProbes,scanned);
+    return scanned;
+}
@@ -0,0 +1,292 @@
+/*
+ * File: TraversalBenchmark.cpp
+ * ----------------------------
+ * This program measures the graph traversal functions on synthetic graphs in the style of the
+ * Graph500 benchmark. It generates a graph in CSR form and, for small enough scales, builds its
+ * SimpleGraph form, runs every traversal engine from a set of random roots and prints per-phase
+ * timings, memory use and traversed edges per second (TEPS) as JSON.
+ *
+ * Usage: TraversalBenchmark [--generator rmat|er|ba|grid|regular|path] [--scale s] [--edgefactor k]
+ *                           [--roots n] [--seed n] [--threads n] [--simple-max-scale s]
+ *                           [--engines bfs,dfs,csr-bfs,csr-dfs,par-bfs,pipe-bfs] [--trace file]
+ *
+ * When compiled with GRAPH_INSTRUMENT, each engine also reports its accumulated PerfStats counters.
+ * When compiled with GRAPH_TRACING, --trace writes the spans of the whole run as a Chrome trace.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "csrgraph.h"
+#include "error.h"
+#include "graphgen.h"
+#include "threadpool.h"
+#include "tracing.h"
+#include "traversal.h"
+
+/*
+ * Type: Config
+ * ------------
+ * This type holds the command-line settings of a benchmark run. The graph has 2^scale nodes; for
+ * rmat, er, ba and regular graphs edgefactor controls the number of undirected edges per node.
+ */
+
+struct Config
+{
+    std::string generator;
+    std::string trace;                          /* Chrome trace output file, empty for none */
+    int scale;
+    int edgefactor;
+    int roots;
+    int simpleMaxScale;                         /* Largest scale that also builds a SimpleGraph */
+    int threads;                                /* Threads of the shared pool, 0 for all */
+    unsigned long seed;
+    std::vector<std::string> engines;
+};
+
+/*
+ * Class: NullBuffer
+ * -----------------
+ * A stream buffer that discards its output. It replaces the buffer of std::cout while the printing
+ * traversals run, so that the terminal does not dominate the measurement.
+ */
+
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c)
+    {
+        return c;
+    }
+
+    std::streamsize xsputn(const char *,std::streamsize n)
+    {
+        return n;
+    }
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+/*
+ * Function: generate
+ * Usage: generate(config,csr);
+ * ----------------------------
+ * Runs the generator selected by config with uniform arc costs in [0,1).
+ */
+
+static void generate(const Config & config,CSRGraph & csr)
+{
+    GeneratorOptions options;
+    size_t n=(size_t) 1<<config.scale;
+
+    options.seed=config.seed;
+    options.threads=config.threads;
+    if (config.generator=="rmat") generateRMAT(config.scale,config.edgefactor,options,csr);
+    else if (config.generator=="er") generateErdosRenyi(n,n*config.edgefactor,options,csr);
+    else if (config.generator=="ba") generateBarabasiAlbert(n,config.edgefactor,options,csr);
+    else if (config.generator=="grid")
+    {
+        size_t rows=(size_t) 1<<(config.scale/2);
+
+        generateGrid(rows,n/rows,options,csr);
+    }
+    else if (config.generator=="regular") generateRandomRegular(n,config.edgefactor,options,csr);
+    else if (config.generator=="path") generatePath(n,options,csr);
+    else error("TraversalBenchmark: unknown generator " + config.generator);
+}
+
+/*
+ * Function: writeStatistics
+ * Usage: writeStatistics(os,samples);
+ * -----------------------------------
+ * Writes the Graph500 summary of a sample (minimum, quartiles, maximum, mean and harmonic mean) as a
+ * JSON object. The harmonic mean is the appropriate average for rates such as TEPS.
+ */
+
+static void writeStatistics(std::ostream & os,std::vector<double> samples)
+{
+    double sum=0,inverse=0;
+
+    std::sort(samples.begin(),samples.end());
+    for (double x:samples)
+    {
+        sum+=x;
+        inverse+=(x>0) ? 1.0/x : 0;
+    }
+
+    size_t n=samples.size();
+
+    os<<"{\"min\":"<<samples[0]<<",\"firstquartile\":"<<samples[(n-1)/4]
+      <<",\"median\":"<<samples[(n-1)/2]<<",\"thirdquartile\":"<<samples[3*(n-1)/4]
+      <<",\"max\":"<<samples[n-1]<<",\"mean\":"<<sum/n
+      <<",\"harmonic_mean\":"<<((inverse>0) ? n/inverse : 0)<<"}";
+}
+
+static std::vector<std::string> splitList(const std::string & str)
+{
+    std::vector<std::string> result;
+    size_t start=0;
+
+    while (start<=str.size())
+    {
+        size_t comma=str.find(',',start);
+
+        if (comma==std::string::npos) comma=str.size();
+        if (comma>start) result.push_back(str.substr(start,comma-start));
+        start=comma+1;
+    }
+    return result;
+}
+
+static Config parseArguments(int argc,char * argv[])
+{
+    Config config;
+
+    config.generator="rmat";
+    config.trace="";
+    config.scale=16;
+    config.edgefactor=16;
+    config.roots=16;
+    config.simpleMaxScale=18;
+    config.threads=0;
+    config.seed=12345;
+    config.engines=splitList("bfs,dfs,csr-bfs,csr-dfs,par-bfs,pipe-bfs");
+    for (int i=1;i<argc;i++)
+    {
+        std::string arg=argv[i];
+
+        if (i+1>=argc) error("TraversalBenchmark: missing value for " + arg);
+
+        std::string value=argv[++i];
+
+        if (arg=="--generator") config.generator=value;
+        else if (arg=="--scale") config.scale=std::stoi(value);
+        else if (arg=="--edgefactor") config.edgefactor=std::stoi(value);
+        else if (arg=="--roots") config.roots=std::max(1,std::stoi(value));
+        else if (arg=="--simple-max-scale") config.simpleMaxScale=std::stoi(value);
+        else if (arg=="--seed") config.seed=std::stoul(value);
+        else if (arg=="--threads") config.threads=std::stoi(value);
+        else if (arg=="--engines") config.engines=splitList(value);
+        else if (arg=="--trace") config.trace=value;
+        else error("TraversalBenchmark: unknown option " + arg);
+    }
+    if (config.scale<1||config.scale>26) error("TraversalBenchmark: scale must be between 1 and 26");
+    return config;
+}
+
+int main(int argc,char * argv[])
+{
+    typedef std::chrono::steady_clock clock;
+    Config config=parseArguments(argc,argv);
+    std::mt19937_64 rng(config.seed);
+    std::ostream & os=std::cout;
+    CSRGraph csr;
+    SimpleGraph graph;
+    bool simple=config.scale<=config.simpleMaxScale;
+
+    ThreadPool::setSharedThreads(config.threads);
+    if (!config.trace.empty()) setTracingEnabled(true);
+
+    clock::time_point start=clock::now();
+
+    generate(config,csr);
+
+    double generateTime=secondsSince(start);
+    double simpleTime=0;
+
+    if (simple)
+    {
+        start=clock::now();
+        buildSimpleGraph(csr,graph);
+        simpleTime=secondsSince(start);
+    }
+
+    std::vector<uint32_t> roots;
+    std::uniform_int_distribution<uint32_t> pick(0,(uint32_t) (csr.nodeCount-1));
+
+    for (size_t tries=0;roots.size()<(size_t) config.roots&&tries<64*csr.nodeCount;tries++)
+    {
+        uint32_t v=pick(rng);
+
+        if (csr.degree(v)>0) roots.push_back(v);
+    }
+    if (roots.empty()) error("TraversalBenchmark: graph has no arcs");
+    os.precision(9);
+    os<<"{\"benchmark\":\"traversal\",\"config\":{\"generator\":\""<<config.generator
+      <<"\",\"scale\":"<<config.scale<<",\"edgefactor\":"<<config.edgefactor
+      <<",\"roots\":"<<roots.size()<<",\"seed\":"<<config.seed<<",\"threads\":"<<config.threads<<"}"
+      <<",\"graph\":{\"nodes\":"<<csr.nodeCount<<",\"arcs\":"<<csr.arcCount()
+      <<",\"csr_bytes\":"<<memoryUsage(csr)
+      <<",\"simplegraph_bytes\":"<<(simple ? memoryUsage(graph) : 0)<<"}"
+      <<",\"phases\":{\"generate_csr_seconds\":"<<generateTime
+      <<",\"build_simplegraph_seconds\":"<<simpleTime<<"},\"engines\":[";
+
+    NullBuffer sink;
+    std::vector<uint32_t> parent;
+    bool first=true;
+
+    for (const std::string & engine:config.engines)
+    {
+        bool pointer=(engine=="bfs"||engine=="dfs");
+        std::vector<double> times,teps;
+        PerfStats stats;
+
+        if (engine!="bfs"&&engine!="dfs"&&engine!="csr-bfs"&&engine!="csr-dfs"&&engine!="par-bfs"
+            &&engine!="pipe-bfs")
+        {
+            error("TraversalBenchmark: unknown engine " + engine);
+        }
+        if (pointer&&!simple) continue;
+        for (uint32_t root:roots)
+        {
+            size_t scanned=0;
+
+            start=clock::now();
+            if (engine=="csr-bfs") scanned=breadthFirstSearch(csr,root,parent,&stats);
+            else if (engine=="csr-dfs") scanned=depthFirstSearch(csr,root,parent,&stats);
+            else if (engine=="par-bfs") scanned=parallelBreadthFirstSearch(csr,root,parent,&stats);
+            else if (engine=="pipe-bfs") scanned=pipelinedBreadthFirstSearch(csr,root,parent,&stats);
+            else
+            {
+                std::streambuf * saved=std::cout.rdbuf(&sink);
+
+                if (engine=="bfs") breadthFirstSearch(csr.nodes[root],&stats);
+                else depthFirstSearch(csr.nodes[root],&stats);
+                std::cout.rdbuf(saved);
+            }
+
+            double seconds=secondsSince(start);
+
+            if (pointer) scanned=breadthFirstSearch(csr,root,parent);
+            times.push_back(seconds);
+            teps.push_back(scanned/std::max(seconds,1e-12));
+        }
+        if (!first) os<<",";
+        first=false;
+        os<<"\n{\"engine\":\""<<engine<<"\",\"time_seconds\":";
+        writeStatistics(os,times);
+        os<<",\"teps\":";
+        writeStatistics(os,teps);
+#ifdef GRAPH_INSTRUMENT
+        os<<",\"counters\":"<<stats;
+#endif
+        os<<"}";
+    }
+
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF,&usage);
+    os<<"\n],\"peak_rss_bytes\":"<<(size_t) usage.ru_maxrss*1024<<"}"<<std::endl;
+    if (simple) freeGraph(graph);
+    if (!config.trace.empty()) saveChromeTrace(config.trace);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * File: biconnected.cpp
+ * ---------------------
+ * This file implements the biconnected.h interface.
+ */
+
+#include <algorithm>
+#include "biconnected.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: arcPosition
+ * ---------------------------------
+ * Returns the position of the arc from u to v in the sorted row of u, or NO_NODE if there is none.
+ */
+
+static size_t arcPosition(const CSRGraph & graph,uint32_t u,uint32_t v)
+{
+    std::vector<uint32_t>::const_iterator first=graph.targets.begin()+graph.offsets[u];
+    std::vector<uint32_t>::const_iterator last=graph.targets.begin()+graph.offsets[u+1];
+    std::vector<uint32_t>::const_iterator it=std::lower_bound(first,last,v);
+
+    return (it!=last&&*it==v) ? it-graph.targets.begin() : NO_NODE;
+}
+
+/*
+ * Implementation notes: findBiconnectedComponents
+ * -----------------------------------------------
+ * This is the algorithm of Hopcroft and Tarjan on the simple undirected graph underlying graph,
+ * with the recursion replaced by an explicit stack of nodes and a per-node position in its row.
+ * discovery numbers the nodes in the order the search reaches them, and low[v] is the smallest
+ * discovery number reachable from the subtree of v by one back edge. Each edge is pushed on edges
+ * once, by the end that reaches it first: tree edges from the parent and back edges from the
+ * descendant. When the search returns from a child c to v with low[c]>=discovery[v], the edges down
+ * to the tree edge v-c form a component, v is an articulation point unless it is a root, and the
+ * tree edge is a bridge if low[c]>discovery[v] as well. A root is an articulation point if it has
+ * more than one child. The second arc of every edge and the arcs of the original graph take their
+ * labels by binary search afterwards.
+ */
+
+void findBiconnectedComponents(const CSRGraph & graph,Biconnectivity & result)
+{
+    TRACE_SCOPE("findBiconnectedComponents");
+    CSRGraph g;
+    size_t n=graph.nodeCount;
+    std::vector<uint32_t> discovery(n,0),low(n,0),parent(n,NO_NODE);
+    std::vector<size_t> next(n),parentArc(n);
+    std::vector<uint8_t> cut(n,0);
+    std::vector<uint32_t> stack;
+    std::vector<size_t> edges;
+    std::vector<uint32_t> label;
+    uint32_t time=0;
+
+    symmetrizeCSR(graph,g);
+    label.assign(g.arcCount(),NO_NODE);
+    result=Biconnectivity();
+    for (size_t root=0;root<n;root++)
+    {
+        if (discovery[root]!=0) continue;
+
+        size_t children=0;
+
+        discovery[root]=low[root]=++time;
+        next[root]=g.offsets[root];
+        stack.push_back((uint32_t) root);
+        while (!stack.empty())
+        {
+            uint32_t v=stack.back();
+
+            if (next[v]<g.offsets[v+1])
+            {
+                size_t i=next[v]++;
+                uint32_t t=g.targets[i];
+
+                if (t==parent[v]) continue;
+                if (discovery[t]==0)
+                {
+                    discovery[t]=low[t]=++time;
+                    parent[t]=v;
+                    parentArc[t]=i;
+                    next[t]=g.offsets[t];
+                    edges.push_back(i);
+                    stack.push_back(t);
+                } else if (discovery[t]<discovery[v])
+                {
+                    low[v]=std::min(low[v],discovery[t]);
+                    edges.push_back(i);
+                }
+                continue;
+            }
+            stack.pop_back();
+            if (stack.empty()) break;
+
+            uint32_t p=parent[v];
+
+            low[p]=std::min(low[p],low[v]);
+            if (low[v]<discovery[p]) continue;
+            if (p==root) children++;
+            else cut[p]=1;
+            if (low[v]>discovery[p])
+            {
+                result.bridges.push_back(std::make_pair(std::min(p,v),std::max(p,v)));
+            }
+
+            uint32_t component=(uint32_t) result.componentCount++;
+
+            while (true)
+            {
+                size_t e=edges.back();
+
+                edges.pop_back();
+                label[e]=component;
+                if (e==parentArc[v]) break;
+            }
+        }
+        if (children>1) cut[root]=1;
+    }
+    for (size_t u=0;u<n;u++)
+    {
+        if (cut[u]) result.articulationPoints.push_back((uint32_t) u);
+        for (size_t i=g.offsets[u];i<g.offsets[u+1];i++)
+        {
+            if (label[i]==NO_NODE) label[i]=label[arcPosition(g,g.targets[i],(uint32_t) u)];
+        }
+    }
+    std::sort(result.bridges.begin(),result.bridges.end());
+    result.arcComponent.resize(graph.arcCount());
+    for (size_t u=0;u<n;u++)
+    {
+        for (size_t i=graph.offsets[u];i<graph.offsets[u+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+
+            result.arcComponent[i]=(t==u) ? NO_NODE : label[arcPosition(g,(uint32_t) u,t)];
+        }
+    }
+}
+
+void findBiconnectedComponents(const SimpleGraph & graph,CSRGraph & csr,Biconnectivity & result)
+{
+    buildCSR(graph,csr);
+    findBiconnectedComponents(csr,result);
+}
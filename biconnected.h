@@ -0,0 +1,52 @@
+/*
+ * File: biconnected.h
+ * -------------------
+ * This interface exports the decomposition of a graph into biconnected components, which finds the
+ * single points of failure of a network: articulation points, whose removal disconnects the graph,
+ * and bridges, the edges whose removal does. Arcs are treated as undirected edges; self-loops and
+ * parallel arcs are ignored.
+ */
+
+#ifndef _biconnected_h
+#define _biconnected_h
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: Biconnectivity
+ * --------------------
+ * This type holds the result of findBiconnectedComponents. The biconnected components partition the
+ * edges; arcComponent gives the component of the edge of every arc position of the graph, counted
+ * from 0, or NO_NODE for self-loops. Articulation points are listed in increasing order, and bridges
+ * as pairs of nodes, the smaller first, in increasing order.
+ */
+
+struct Biconnectivity
+{
+    size_t componentCount;                      /* Number of biconnected components */
+    std::vector<uint32_t> articulationPoints;   /* Nodes whose removal splits a component */
+    std::vector<std::pair<uint32_t,uint32_t> > bridges;
+    std::vector<uint32_t> arcComponent;         /* Component of every arc position */
+
+    Biconnectivity() : componentCount(0) {}
+};
+
+/*
+ * Function: findBiconnectedComponents
+ * Usage: findBiconnectedComponents(csr,result);
+ *        findBiconnectedComponents(graph,csr,result);
+ * ---------------------------------------------------
+ * Computes the articulation points, bridges and biconnected components of graph in a single
+ * depth-first search that takes time linear in the size of the graph and no stack space beyond a
+ * few arrays, however long its paths. The SimpleGraph form first converts graph into csr, whose
+ * nodes and arcs fields map the indices of the result back to the graph.
+ */
+
+void findBiconnectedComponents(const CSRGraph & graph,Biconnectivity & result);
+void findBiconnectedComponents(const SimpleGraph & graph,CSRGraph & csr,Biconnectivity & result);
+
+#endif
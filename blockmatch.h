@@ -0,0 +1,42 @@
+/*
+ * File: blockmatch.h
+ * ------------------
+ * This interface exports matchBlocks, the SSE2 kernel shared by the merges of sorted integer lists
+ * in hoplabels.cpp and triangles.cpp. Those merges walk both lists four entries at a time and use
+ * matchBlocks to find out with one test which entries of the two blocks are equal. The function is
+ * available only when the compiler targets SSE2; callers keep an ordinary merge for other processors.
+ */
+
+#ifndef _blockmatch_h
+#define _blockmatch_h
+
+#ifdef __SSE2__
+
+#include <cstdint>
+#include <emmintrin.h>
+
+/*
+ * Function: matchBlocks
+ * Usage: int mask=matchBlocks(x,y);
+ * ---------------------------------
+ * Compares the four entries starting at x with the four starting at y, in any order, and returns a
+ * mask in which bit k is set if x[k] equals one of the entries of y. The block of y is compared in
+ * all four rotations, so one call covers all sixteen pairs. Neither pointer needs to be aligned.
+ */
+
+inline int matchBlocks(const uint32_t * x,const uint32_t * y)
+{
+    __m128i bx=_mm_loadu_si128((const __m128i *) x);
+    __m128i by=_mm_loadu_si128((const __m128i *) y);
+    __m128i eq=_mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi32(bx,by),
+                     _mm_cmpeq_epi32(bx,_mm_shuffle_epi32(by,_MM_SHUFFLE(0,3,2,1)))),
+        _mm_or_si128(_mm_cmpeq_epi32(bx,_mm_shuffle_epi32(by,_MM_SHUFFLE(1,0,3,2))),
+                     _mm_cmpeq_epi32(bx,_mm_shuffle_epi32(by,_MM_SHUFFLE(2,1,0,3)))));
+
+    return _mm_movemask_ps(_mm_castsi128_ps(eq));
+}
+
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * File: bucketqueue.cpp
+ * ---------------------
+ * This file implements the bucketqueue.h interface.
+ */
+
+#include <algorithm>
+#include "bucketqueue.h"
+#include "error.h"
+
+/*
+ * Implementation notes: BucketQueue constructor
+ * ---------------------------------------------
+ * The items are sorted by a counting sort over their keys, which also yields the bucket starts.
+ */
+
+BucketQueue::BucketQueue(const std::vector<uint32_t> & keys) : keys(keys),head(0)
+{
+    size_t n=keys.size();
+    uint32_t top=0;
+
+    for (uint32_t k:keys) top=std::max(top,k);
+    start.assign((size_t) top+2,0);
+    for (uint32_t k:keys) start[k+1]++;
+    for (size_t k=0;k<=top;k++) start[k+1]+=start[k];
+    order.resize(n);
+    position.resize(n);
+
+    std::vector<size_t> next(start.begin(),start.end()-1);
+
+    for (size_t v=0;v<n;v++)
+    {
+        size_t p=next[keys[v]]++;
+
+        order[p]=(uint32_t) v;
+        position[v]=(uint32_t) p;
+    }
+}
+
+bool BucketQueue::isEmpty() const
+{
+    return head==order.size();
+}
+
+size_t BucketQueue::size() const
+{
+    return order.size()-head;
+}
+
+bool BucketQueue::contains(uint32_t item) const
+{
+    return item<order.size()&&position[item]>=head;
+}
+
+uint32_t BucketQueue::key(uint32_t item) const
+{
+    if (item>=keys.size()) error("BucketQueue: item out of range");
+    return keys[item];
+}
+
+uint32_t BucketQueue::peek() const
+{
+    if (isEmpty()) error("BucketQueue: peek on an empty queue");
+    return order[head];
+}
+
+uint32_t BucketQueue::dequeue()
+{
+    if (isEmpty()) error("BucketQueue: dequeue on an empty queue");
+
+    uint32_t item=order[head++];
+
+    start[keys[item]]=head;
+    return item;
+}
+
+void BucketQueue::decrementKey(uint32_t item)
+{
+    if (!contains(item)) error("BucketQueue: item is not in the queue");
+
+    uint32_t k=keys[item];
+
+    if (k==0) error("BucketQueue: key is already 0");
+
+    size_t first=std::max(start[k],head);
+    uint32_t other=order[first];
+
+    order[first]=item;
+    order[position[item]]=other;
+    position[other]=position[item];
+    position[item]=(uint32_t) first;
+    start[k]=first+1;
+    keys[item]=k-1;
+}
@@ -0,0 +1,105 @@
+/*
+ * File: bucketqueue.h
+ * -------------------
+ * This interface exports the BucketQueue class, a priority queue for small integer keys that
+ * supports decreasing a key in constant time. It is the structure behind peeling algorithms such
+ * as the k-core decomposition, where the general PriorityQueue would need a decrease-key operation
+ * it does not have.
+ */
+
+#ifndef _bucketqueue_h
+#define _bucketqueue_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Class: BucketQueue
+ * ------------------
+ * This class holds the items 0 .. n-1, each with an integer key, and hands them out in increasing
+ * order of key. Items are dequeued in constant time; ties are broken arbitrarily. Keys can only be
+ * lowered, one step at a time, and items cannot be added after construction.
+ */
+
+class BucketQueue
+{
+public:
+
+/*
+ * Constructor: BucketQueue
+ * Usage: BucketQueue queue(keys);
+ * -------------------------------
+ * Creates a queue holding the items 0 .. keys.size()-1 with the given keys, in time proportional to
+ * the number of items plus the largest key.
+ */
+
+    explicit BucketQueue(const std::vector<uint32_t> & keys);
+
+/*
+ * Methods: isEmpty, size
+ * Usage: if (queue.isEmpty()) ...
+ *        size_t n=queue.size();
+ * -------------------------------
+ * Return whether the queue is empty and the number of items it still holds.
+ */
+
+    bool isEmpty() const;
+    size_t size() const;
+
+/*
+ * Methods: contains, key
+ * Usage: if (queue.contains(item)) ...
+ *        uint32_t k=queue.key(item);
+ * ------------------------------------
+ * Return whether item is still in the queue and its current key. The key of a dequeued item is the
+ * one it had when it left the queue.
+ */
+
+    bool contains(uint32_t item) const;
+    uint32_t key(uint32_t item) const;
+
+/*
+ * Methods: peek, dequeue
+ * Usage: uint32_t item=queue.peek();
+ *        uint32_t item=queue.dequeue();
+ * -------------------------------------
+ * Return an item with the smallest key; dequeue also removes it. Both signal an error if the queue
+ * is empty.
+ */
+
+    uint32_t peek() const;
+    uint32_t dequeue();
+
+/*
+ * Method: decrementKey
+ * Usage: queue.decrementKey(item);
+ * --------------------------------
+ * Lowers the key of item by one. It signals an error if item is not in the queue or its key is 0.
+ */
+
+    void decrementKey(uint32_t item);
+
+private:
+
+/*
+ * Implementation notes: data structure
+ * ------------------------------------
+ * This is the array layout of Batagelj and Zaversnik. order lists the items sorted by key and
+ * position is its inverse; the items still queued occupy order[head..n) and the bucket of key k
+ * starts at start[k]. Dequeuing takes order[head]. Lowering the key of an item swaps it with the
+ * first item of its bucket and moves that bucket's start past it, which puts it at the end of the
+ * next lower bucket. Dequeuing does not update the starts of the empty buckets below the current
+ * key, so a start that lies before head is read as head.
+ */
+
+/* Instance variables */
+
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> position;
+    std::vector<size_t> start;
+    size_t head;
+};
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * File: centrality.cpp
+ * --------------------
+ * This file implements the centrality.h interface.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <utility>
+#include "centrality.h"
+#include "error.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Type: BrandesWorker
+ * -------------------
+ * The storage one thread needs to process sources: the per-source arrays, which are reset after
+ * each source in time proportional to the nodes it reached, and the thread's running sums of the
+ * dependencies.
+ */
+
+struct BrandesWorker
+{
+    std::vector<double> distance;               /* -1 for nodes not reached */
+    std::vector<double> sigma;                  /* Number of shortest paths from the source */
+    std::vector<double> delta;                  /* Dependency of the source on each node */
+    std::vector<uint32_t> order;                /* Reached nodes in order of distance */
+    std::vector<double> sum;                    /* Accumulated dependencies */
+
+    explicit BrandesWorker(size_t n) : distance(n,-1.0),sigma(n,0.0),delta(n,0.0),sum(n,0.0) {}
+};
+
+/*
+ * Implementation notes: countPaths
+ * --------------------------------
+ * The first phase of Brandes' algorithm finds the nodes reachable from source in order of distance
+ * and counts the shortest paths to each. Without weights this is a breadth-first search; with
+ * weights it is Dijkstra's algorithm on a standard binary heap with lazy deletion, as in
+ * shortestpath.cpp, where a tie adds the paths of the new predecessor. A node may be pushed several
+ * times but joins order only when it is settled. Adding the paths at a tie is correct only because
+ * every predecessor of a node is settled before the node itself, which needs positive costs: with
+ * an arc of cost 0, a node could be settled before a predecessor at the same distance and pass on
+ * too few paths. betweennessCentrality therefore rejects such costs.
+ */
+
+typedef std::pair<double,uint32_t> HeapEntry;
+
+static void countPaths(const CSRGraph & graph,uint32_t source,bool weighted,BrandesWorker & w)
+{
+    w.order.clear();
+    w.distance[source]=0;
+    w.sigma[source]=1;
+    if (!weighted)
+    {
+        w.order.push_back(source);
+        for (size_t head=0;head<w.order.size();head++)
+        {
+            uint32_t v=w.order[head];
+
+            for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+            {
+                uint32_t t=graph.targets[i];
+
+                if (w.distance[t]<0)
+                {
+                    w.distance[t]=w.distance[v]+1;
+                    w.order.push_back(t);
+                }
+                if (w.distance[t]==w.distance[v]+1) w.sigma[t]+=w.sigma[v];
+            }
+        }
+        return;
+    }
+
+    std::priority_queue<HeapEntry,std::vector<HeapEntry>,std::greater<HeapEntry> > heap;
+
+    heap.push(HeapEntry(0,source));
+    while (!heap.empty())
+    {
+        uint32_t v=heap.top().second;
+
+        heap.pop();
+        if (w.delta[v]<0) continue;
+        w.delta[v]=-1;
+        w.order.push_back(v);
+        for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+            double d=w.distance[v]+graph.costs[i];
+
+            if (w.distance[t]<0||d<w.distance[t])
+            {
+                w.distance[t]=d;
+                w.sigma[t]=w.sigma[v];
+                heap.push(HeapEntry(d,t));
+            } else if (d==w.distance[t]&&w.delta[t]==0)
+            {
+                w.sigma[t]+=w.sigma[v];
+            }
+        }
+    }
+    for (uint32_t v:w.order) w.delta[v]=0;
+}
+
+/*
+ * Implementation notes: accumulate
+ * --------------------------------
+ * The second phase visits the reached nodes in decreasing order of distance. Instead of storing the
+ * predecessor lists of the textbook algorithm, each node v looks at its own arcs: an arc v->t lies
+ * on a shortest path exactly when the distance of t is that of v plus the arc's length, and then v
+ * receives its share sigma[v]/sigma[t] of the dependency of t. This needs no memory beyond the
+ * graph. The reset of the per-source arrays is folded into the same pass.
+ */
+
+static void accumulate(const CSRGraph & graph,uint32_t source,bool weighted,BrandesWorker & w)
+{
+    for (size_t k=w.order.size();k-->0;)
+    {
+        uint32_t v=w.order[k];
+        double dv=w.distance[v];
+        double share=0;
+
+        for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+            double step=weighted ? graph.costs[i] : 1.0;
+
+            if (w.distance[t]>=0&&w.distance[t]==dv+step&&w.sigma[t]>0)
+            {
+                share+=(1+w.delta[t])/w.sigma[t];
+            }
+        }
+        w.delta[v]=w.sigma[v]*share;
+        if (v!=source) w.sum[v]+=w.delta[v];
+    }
+    for (uint32_t v:w.order)
+    {
+        w.distance[v]=-1;
+        w.sigma[v]=0;
+        w.delta[v]=0;
+    }
+}
+
+/*
+ * Implementation notes: betweennessCentrality
+ * -------------------------------------------
+ * The sources are spread over the pool with parallelFor. A piece borrows a worker from a small
+ * free list, so there are never more workers than pieces running at once, and every worker keeps
+ * its own sums; nothing is shared while sources are processed. The sums of all workers are added
+ * up in a final parallel pass over the nodes.
+ */
+
+void betweennessCentrality(const CSRGraph & graph,std::vector<double> & centrality,
+                           const BetweennessOptions & options)
+{
+    TRACE_SCOPE("betweennessCentrality");
+    ThreadPool & pool=ThreadPool::current();
+    size_t n=graph.nodeCount;
+    std::vector<uint32_t> sources(n);
+    std::vector<std::unique_ptr<BrandesWorker> > workers;
+    std::vector<BrandesWorker *> idle;
+    std::mutex lock;
+
+    if (options.weighted)
+    {
+        for (size_t i=0;i<graph.costs.size();i++)
+        {
+            if (!(graph.costs[i]>0)) error("betweennessCentrality: arc costs must be positive");
+        }
+    }
+    std::iota(sources.begin(),sources.end(),0);
+    if (options.pivots>0&&options.pivots<n)
+    {
+        std::mt19937_64 rng(options.seed);
+
+        for (size_t i=0;i<options.pivots;i++)
+        {
+            std::uniform_int_distribution<size_t> pick(i,n-1);
+
+            std::swap(sources[i],sources[pick(rng)]);
+        }
+        sources.resize(options.pivots);
+    }
+    {
+        TRACE_SCOPE_VALUE("brandes.sources",sources.size());
+        pool.parallelFor(0,sources.size(),[&](size_t first,size_t last)
+        {
+            BrandesWorker * w;
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                if (idle.empty())
+                {
+                    workers.push_back(std::unique_ptr<BrandesWorker>(new BrandesWorker(n)));
+                    idle.push_back(workers.back().get());
+                }
+                w=idle.back();
+                idle.pop_back();
+            }
+            for (size_t k=first;k<last;k++)
+            {
+                countPaths(graph,sources[k],options.weighted,*w);
+                accumulate(graph,sources[k],options.weighted,*w);
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+
+            idle.push_back(w);
+        },1);
+    }
+
+    double scale=(sources.size()<n) ? (double) n/sources.size() : 1.0;
+
+    if (options.normalized&&n>2) scale/=(double) (n-1)*(n-2);
+    centrality.assign(n,0.0);
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            double total=0;
+
+            for (const std::unique_ptr<BrandesWorker> & w:workers) total+=w->sum[v];
+            centrality[v]=total*scale;
+        }
+    },4096);
+}
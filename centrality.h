@@ -0,0 +1,48 @@
+/*
+ * File: centrality.h
+ * ------------------
+ * This interface exports betweenness centrality for graphs in CSR form.
+ */
+
+#ifndef _centrality_h
+#define _centrality_h
+
+#include <cstddef>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: BetweennessOptions
+ * ------------------------
+ * This type collects the settings of betweennessCentrality. If weighted is false, every arc counts
+ * as one hop; otherwise shortest paths are measured by arc cost, which must be positive. A pivot
+ * count of 0 computes exact centrality from every source; a positive count estimates it from that
+ * many sources chosen at random with the given seed, scaled up to the whole graph.
+ */
+
+struct BetweennessOptions
+{
+    bool weighted;                              /* Use arc costs instead of hop counts */
+    size_t pivots;                              /* Sampled sources, 0 for all */
+    unsigned long long seed;                    /* Seed for choosing the pivots */
+    bool normalized;                            /* Divide by the number of node pairs */
+
+    BetweennessOptions() : weighted(false),pivots(0),seed(1),normalized(false) {}
+};
+
+/*
+ * Function: betweennessCentrality
+ * Usage: betweennessCentrality(csr,centrality);
+ *        betweennessCentrality(csr,centrality,options);
+ * -----------------------------------------------------
+ * Sets centrality[v] to the sum, over all ordered pairs of other nodes s and t, of the fraction of
+ * shortest paths from s to t that pass through v. In a graph whose arcs come in opposite pairs each
+ * undirected path is therefore counted twice. If options.normalized is true, the sums are divided
+ * by (n-1)(n-2). The sources are processed in parallel on the current thread pool. Signals an error
+ * if options.weighted is true and some arc costs zero or less.
+ */
+
+void betweennessCentrality(const CSRGraph & graph,std::vector<double> & centrality,
+                           const BetweennessOptions & options=BetweennessOptions());
+
+#endif
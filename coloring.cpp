@@ -0,0 +1,326 @@
+/*
+ * File: coloring.cpp
+ * ------------------
+ * This file implements the coloring.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "bucketqueue.h"
+#include "coloring.h"
+#include "splitmix.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+static const uint32_t NO_COLOR=UINT32_MAX;
+
+/*
+ * Implementation notes: greedyOrder
+ * ---------------------------------
+ * Fills order with the nodes in the requested order and rank with its inverse. The random and degree
+ * orders sort by a key whose high half is the degree, or its complement for LARGEST_FIRST, and whose
+ * low half is a hash of the node; the random ties keep chains of nodes with increasing rank short,
+ * which the parallel rounds depend on. SMALLEST_LAST peels the graph with a bucket queue as in
+ * cores.cpp and reverses the order of removal. Self-loops do not count towards the degree.
+ */
+
+static void greedyOrder(const CSRGraph & graph,GreedyOrder kind,unsigned long long seed,
+                        std::vector<uint32_t> & order,std::vector<uint32_t> & rank)
+{
+    TRACE_SCOPE("greedyOrder");
+    size_t n=graph.nodeCount;
+    std::vector<uint32_t> degree(n,0);
+
+    order.resize(n);
+    rank.resize(n);
+    parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+            {
+                if (graph.targets[i]!=v) degree[v]++;
+            }
+        }
+    },4096);
+    if (kind==SMALLEST_LAST)
+    {
+        BucketQueue queue(degree);
+        size_t k=n;
+
+        while (!queue.isEmpty())
+        {
+            uint32_t v=queue.dequeue();
+
+            order[--k]=v;
+            for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+            {
+                uint32_t t=graph.targets[i];
+
+                if (t!=v&&queue.contains(t)) queue.decrementKey(t);
+            }
+        }
+    }
+    else
+    {
+        std::vector<uint64_t> key(n);
+        uint64_t salt=mix64(seed);
+
+        for (size_t v=0;v<n;v++)
+        {
+            uint64_t high=0;
+
+            if (kind==LARGEST_FIRST) high=~degree[v];
+            if (kind==SMALLEST_FIRST) high=degree[v];
+            key[v]=(high<<32)|(mix64(v^salt)&0xFFFFFFFF);
+            order[v]=(uint32_t) v;
+        }
+        if (kind!=NATURAL_ORDER)
+        {
+            std::sort(order.begin(),order.end(),[&](uint32_t a,uint32_t b)
+            {
+                return key[a]<key[b]||(key[a]==key[b]&&a<b);
+            });
+        }
+    }
+    for (size_t k=0;k<n;k++) rank[order[k]]=(uint32_t) k;
+}
+
+/*
+ * Implementation notes: colorGraph
+ * --------------------------------
+ * This is the speculative coloring of Gebremedhin and Manne. Every round colors the nodes of the
+ * worklist in parallel, each taking the smallest color not used by a neighbor at that moment; the
+ * colors that are in use are marked in a per-thread array of stamps, which only needs to cover the
+ * colors up to the degree of the node. Two adjacent nodes colored at the same time may pick the same
+ * color, so a second parallel pass collects every node that shares its color with a neighbor of
+ * smaller rank. The node of smallest rank in a conflict keeps its color, which guarantees progress;
+ * the others form the next worklist, sorted by rank so that the order is still followed. Conflicts
+ * are rare, and the rounds quickly become short.
+ */
+
+uint32_t colorGraph(const CSRGraph & graph,std::vector<uint32_t> & color,
+                    const ColoringOptions & options)
+{
+    TRACE_SCOPE("colorGraph");
+    CSRGraph undirected;
+
+    if (!options.symmetric) symmetrizeCSR(graph,undirected);
+
+    const CSRGraph & g=options.symmetric ? graph : undirected;
+    size_t n=g.nodeCount;
+    std::vector<uint32_t> worklist,rank;
+    std::vector<uint32_t> next(n);
+    std::unique_ptr<std::atomic<uint32_t>[]> shade(new std::atomic<uint32_t>[n]);
+    std::atomic<size_t> nextSize(0);
+
+    greedyOrder(g,options.order,options.seed,worklist,rank);
+    for (size_t v=0;v<n;v++) shade[v].store(NO_COLOR,std::memory_order_relaxed);
+    while (!worklist.empty())
+    {
+        TRACE_SCOPE_VALUE("coloring.round",worklist.size());
+
+        parallelFor(0,worklist.size(),[&](size_t first,size_t last)
+        {
+            thread_local std::vector<uint32_t> stamp;
+            thread_local uint32_t epoch=0;
+
+            for (size_t k=first;k<last;k++)
+            {
+                uint32_t v=worklist[k];
+                size_t d=g.degree(v);
+
+                if (stamp.size()<=d) stamp.resize(d+1,0);
+                if (++epoch==0)
+                {
+                    std::fill(stamp.begin(),stamp.end(),0);
+                    epoch=1;
+                }
+                for (size_t i=g.offsets[v];i<g.offsets[v+1];i++)
+                {
+                    uint32_t t=g.targets[i];
+                    uint32_t c=shade[t].load(std::memory_order_relaxed);
+
+                    if (t!=v&&c<=d) stamp[c]=epoch;
+                }
+
+                uint32_t c=0;
+
+                while (stamp[c]==epoch) c++;
+                shade[v].store(c,std::memory_order_relaxed);
+            }
+        },256);
+        nextSize.store(0,std::memory_order_relaxed);
+        parallelFor(0,worklist.size(),[&](size_t first,size_t last)
+        {
+            std::vector<uint32_t> local;
+
+            for (size_t k=first;k<last;k++)
+            {
+                uint32_t v=worklist[k];
+                uint32_t c=shade[v].load(std::memory_order_relaxed);
+
+                for (size_t i=g.offsets[v];i<g.offsets[v+1];i++)
+                {
+                    uint32_t t=g.targets[i];
+
+                    if (t!=v&&rank[t]<rank[v]&&shade[t].load(std::memory_order_relaxed)==c)
+                    {
+                        local.push_back(v);
+                        break;
+                    }
+                }
+            }
+
+            size_t pos=nextSize.fetch_add(local.size(),std::memory_order_relaxed);
+
+            std::copy(local.begin(),local.end(),next.begin()+pos);
+        },256);
+        worklist.assign(next.begin(),next.begin()+nextSize.load(std::memory_order_relaxed));
+        std::sort(worklist.begin(),worklist.end(),[&](uint32_t a,uint32_t b)
+        {
+            return rank[a]<rank[b];
+        });
+    }
+
+    uint32_t count=0;
+
+    color.resize(n);
+    for (size_t v=0;v<n;v++)
+    {
+        color[v]=shade[v].load(std::memory_order_relaxed);
+        count=std::max(count,color[v]+1);
+    }
+    return count;
+}
+
+uint32_t colorGraph(const SimpleGraph & graph,std::unordered_map<Node *,uint32_t> & colors,
+                    const ColoringOptions & options)
+{
+    CSRGraph csr;
+    std::vector<uint32_t> color;
+
+    buildCSR(graph,csr);
+
+    uint32_t count=colorGraph(csr,color,options);
+
+    colors.clear();
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        colors[csr.nodes[v]]=color[v];
+    }
+    return count;
+}
+
+/*
+ * Implementation notes: maximalIndependentSet
+ * -------------------------------------------
+ * This is the rank-based form of the algorithm of Luby. In every round each undecided node whose
+ * neighbors of smaller rank are all excluded joins the set; afterwards the neighbors of the new
+ * members are excluded, and the undecided nodes are gathered into the next worklist. The first pass
+ * only reads the states, so the decisions of a round do not depend on each other, and the result is
+ * exactly the greedy set in rank order. With random ties the number of rounds grows only
+ * logarithmically with the number of nodes.
+ */
+
+size_t maximalIndependentSet(const CSRGraph & graph,std::vector<uint32_t> & independent,
+                             const IndependentSetOptions & options)
+{
+    TRACE_SCOPE("maximalIndependentSet");
+    CSRGraph undirected;
+
+    if (!options.symmetric) symmetrizeCSR(graph,undirected);
+
+    const CSRGraph & g=options.symmetric ? graph : undirected;
+    size_t n=g.nodeCount;
+    enum { UNDECIDED, MEMBER, EXCLUDED };
+    std::vector<uint32_t> worklist,rank;
+    std::vector<uint32_t> next(n);
+    std::vector<uint8_t> joins;
+    std::unique_ptr<std::atomic<uint8_t>[]> state(new std::atomic<uint8_t>[n]);
+    std::atomic<size_t> nextSize(0);
+
+    greedyOrder(g,options.order,options.seed,worklist,rank);
+    for (size_t v=0;v<n;v++) state[v].store(UNDECIDED,std::memory_order_relaxed);
+    while (!worklist.empty())
+    {
+        TRACE_SCOPE_VALUE("mis.round",worklist.size());
+        size_t size=worklist.size();
+
+        joins.assign(size,0);
+        parallelFor(0,size,[&](size_t first,size_t last)
+        {
+            for (size_t k=first;k<last;k++)
+            {
+                uint32_t v=worklist[k];
+                bool open=true;
+
+                for (size_t i=g.offsets[v];i<g.offsets[v+1]&&open;i++)
+                {
+                    uint32_t t=g.targets[i];
+
+                    if (t==v||rank[t]>rank[v]) continue;
+                    open=state[t].load(std::memory_order_relaxed)==EXCLUDED;
+                }
+                joins[k]=open;
+            }
+        },1024);
+        parallelFor(0,size,[&](size_t first,size_t last)
+        {
+            for (size_t k=first;k<last;k++)
+            {
+                if (!joins[k]) continue;
+
+                uint32_t v=worklist[k];
+
+                state[v].store(MEMBER,std::memory_order_relaxed);
+                for (size_t i=g.offsets[v];i<g.offsets[v+1];i++)
+                {
+                    uint32_t t=g.targets[i];
+
+                    if (t!=v) state[t].store(EXCLUDED,std::memory_order_relaxed);
+                }
+            }
+        },1024);
+        nextSize.store(0,std::memory_order_relaxed);
+        parallelFor(0,size,[&](size_t first,size_t last)
+        {
+            std::vector<uint32_t> local;
+
+            for (size_t k=first;k<last;k++)
+            {
+                uint32_t v=worklist[k];
+
+                if (state[v].load(std::memory_order_relaxed)==UNDECIDED) local.push_back(v);
+            }
+
+            size_t pos=nextSize.fetch_add(local.size(),std::memory_order_relaxed);
+
+            std::copy(local.begin(),local.end(),next.begin()+pos);
+        },1024);
+        worklist.assign(next.begin(),next.begin()+nextSize.load(std::memory_order_relaxed));
+    }
+    independent.clear();
+    for (size_t v=0;v<n;v++)
+    {
+        if (state[v].load(std::memory_order_relaxed)==MEMBER) independent.push_back((uint32_t) v);
+    }
+    return independent.size();
+}
+
+size_t maximalIndependentSet(const SimpleGraph & graph,std::vector<Node *> & independent,
+                             const IndependentSetOptions & options)
+{
+    CSRGraph csr;
+    std::vector<uint32_t> members;
+
+    buildCSR(graph,csr);
+    maximalIndependentSet(csr,members,options);
+    independent.clear();
+    for (uint32_t v:members)
+    {
+        independent.push_back(csr.nodes[v]);
+    }
+    return independent.size();
+}
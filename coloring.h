@@ -0,0 +1,96 @@
+/*
+ * File: coloring.h
+ * ----------------
+ * This interface exports parallel greedy algorithms for conflict graphs in CSR form: coloring, which
+ * gives adjacent nodes different colors, and maximal independent sets, which pick nodes no two of
+ * which are adjacent until no further node can be added. Arcs are treated as undirected edges.
+ */
+
+#ifndef _coloring_h
+#define _coloring_h
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: GreedyOrder
+ * -----------------
+ * Selects the order in which the greedy algorithms consider the nodes. NATURAL_ORDER follows the
+ * node numbers and RANDOM_ORDER a random permutation. LARGEST_FIRST and SMALLEST_FIRST sort by
+ * degree, breaking ties at random. SMALLEST_LAST repeatedly removes a node of smallest degree from
+ * the graph and takes the nodes in the reverse order of removal; it usually needs the fewest colors,
+ * but computing it is sequential.
+ */
+
+enum GreedyOrder { NATURAL_ORDER, RANDOM_ORDER, LARGEST_FIRST, SMALLEST_FIRST, SMALLEST_LAST };
+
+/*
+ * Type: ColoringOptions
+ * ---------------------
+ * This type collects the settings of colorGraph. If symmetric is true, the caller promises that
+ * every arc u->v is matched by an arc v->u, which saves building the undirected graph. The seed
+ * fixes the random order and the tie breaking of the degree orders.
+ */
+
+struct ColoringOptions
+{
+    GreedyOrder order;                          /* Order in which nodes pick colors */
+    bool symmetric;                             /* Arcs already come in opposite pairs */
+    unsigned long long seed;                    /* Seed for random choices */
+
+    ColoringOptions() : order(LARGEST_FIRST),symmetric(false),seed(1) {}
+};
+
+/*
+ * Type: IndependentSetOptions
+ * ---------------------------
+ * This type collects the settings of maximalIndependentSet, with the same meaning as in
+ * ColoringOptions. Taking nodes of small degree first tends to give larger sets.
+ */
+
+struct IndependentSetOptions
+{
+    GreedyOrder order;                          /* Order in which nodes are offered to the set */
+    bool symmetric;                             /* Arcs already come in opposite pairs */
+    unsigned long long seed;                    /* Seed for random choices */
+
+    IndependentSetOptions() : order(SMALLEST_FIRST),symmetric(false),seed(1) {}
+};
+
+/*
+ * Function: colorGraph
+ * Usage: uint32_t count=colorGraph(csr,color);
+ *        uint32_t count=colorGraph(graph,colors,options);
+ * ------------------------------------------------------
+ * Colors the nodes so that the ends of every edge differ and returns the number of colors used. The
+ * CSR form sets color[v] to a number between 0 and count-1; the SimpleGraph form converts the graph
+ * and reports the color by node. No node gets a color larger than its degree. The nodes are colored
+ * speculatively in parallel on the current thread pool, so the coloring may differ from run to run
+ * when more than one thread is used.
+ */
+
+uint32_t colorGraph(const CSRGraph & graph,std::vector<uint32_t> & color,
+                    const ColoringOptions & options=ColoringOptions());
+uint32_t colorGraph(const SimpleGraph & graph,std::unordered_map<Node *,uint32_t> & colors,
+                    const ColoringOptions & options=ColoringOptions());
+
+/*
+ * Function: maximalIndependentSet
+ * Usage: size_t count=maximalIndependentSet(csr,independent);
+ *        size_t count=maximalIndependentSet(graph,independent,options);
+ * -------------------------------------------------------------------
+ * Fills independent with a maximal independent set, in increasing order of node number for the CSR
+ * form, and returns its size. The set is the one the sequential greedy algorithm picks in the
+ * chosen order, so it does not depend on the number of threads; the work runs in parallel rounds on
+ * the current thread pool.
+ */
+
+size_t maximalIndependentSet(const CSRGraph & graph,std::vector<uint32_t> & independent,
+                             const IndependentSetOptions & options=IndependentSetOptions());
+size_t maximalIndependentSet(const SimpleGraph & graph,std::vector<Node *> & independent,
+                             const IndependentSetOptions & options=IndependentSetOptions());
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * File: communities.cpp
+ * ---------------------
+ * This file implements the communities.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include "communities.h"
+#include "error.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: chooseLabel
+ * ---------------------------------
+ * Adds up the votes of the neighbors of v per label in votes, a hash map that belongs to the calling
+ * thread and is only cleared between nodes, so its buckets are allocated once. The label with the
+ * largest total wins. A node keeps its current label if that is among the best, which stops pairs
+ * of nodes from swapping labels forever; other ties go to the smallest label so that the choice does
+ * not depend on the iteration order of the map. A node without any positive vote stays where it is.
+ * Parallel arcs in a symmetric graph vote separately.
+ */
+
+static uint32_t chooseLabel(const CSRGraph & graph,const std::atomic<uint32_t> * label,uint32_t v,
+                            bool weighted,std::unordered_map<uint32_t,double> & votes)
+{
+    uint32_t current=label[v].load(std::memory_order_relaxed);
+
+    votes.clear();
+    for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+    {
+        uint32_t t=graph.targets[i];
+
+        if (t==v) continue;
+        votes[label[t].load(std::memory_order_relaxed)]+=weighted ? graph.costs[i] : 1.0;
+    }
+
+    uint32_t best=current;
+    double most=0;
+
+    for (const std::pair<const uint32_t,double> & entry:votes)
+    {
+        if (entry.second>most||(entry.second==most&&entry.first<best)) best=entry.first;
+        most=std::max(most,entry.second);
+    }
+    if (most==0) return current;
+
+    std::unordered_map<uint32_t,double>::const_iterator own=votes.find(current);
+
+    if (own!=votes.end()&&own->second==most) return current;
+    return best;
+}
+
+/*
+ * Implementation notes: labelPropagation
+ * --------------------------------------
+ * The algorithm is asynchronous: labels live in one shared array of relaxed atomics, and a node
+ * that moves is seen at once by the neighbors evaluated after it. Only active nodes are evaluated.
+ * All nodes are active in the first round; afterwards a node is active if a neighbor changed its
+ * label in the previous round. A node clears its flag just before it votes, and a neighbor that
+ * moves sets the flag again with an exchange, so every node enters the next frontier at most once
+ * and no change goes unnoticed. Each round visits its frontier in a random order drawn from the
+ * seed, and new frontiers are gathered as in the parallel breadth-first search.
+ */
+
+size_t labelPropagation(const CSRGraph & graph,std::vector<uint32_t> & community,
+                        const LabelPropagationOptions & options)
+{
+    TRACE_SCOPE("labelPropagation");
+    ThreadPool & pool=ThreadPool::current();
+    CSRGraph undirected;
+
+    if (!options.symmetric) symmetrizeCSR(graph,undirected);
+
+    const CSRGraph & g=options.symmetric ? graph : undirected;
+    size_t n=g.nodeCount;
+    std::unique_ptr<std::atomic<uint32_t>[]> label(new std::atomic<uint32_t>[n]);
+    std::unique_ptr<std::atomic<uint8_t>[]> active(new std::atomic<uint8_t>[n]);
+    std::vector<uint32_t> frontier(n),next(n);
+    std::atomic<size_t> nextSize(0);
+    size_t size=n;
+    std::mt19937_64 rng(options.seed);
+
+    if (options.weighted)
+    {
+        for (double cost:g.costs)
+        {
+            if (cost<0) error("labelPropagation: negative arc cost");
+        }
+    }
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            label[v].store((uint32_t) v,std::memory_order_relaxed);
+            active[v].store(1,std::memory_order_relaxed);
+            frontier[v]=(uint32_t) v;
+        }
+    },4096);
+    for (int round=0;round<options.maxIterations&&size>0;round++)
+    {
+        TRACE_SCOPE_VALUE("lpa.round",size);
+
+        std::shuffle(frontier.begin(),frontier.begin()+size,rng);
+        nextSize.store(0,std::memory_order_relaxed);
+        pool.parallelFor(0,size,[&](size_t first,size_t last)
+        {
+            thread_local std::unordered_map<uint32_t,double> votes;
+            std::vector<uint32_t> local;
+
+            for (size_t k=first;k<last;k++)
+            {
+                uint32_t v=frontier[k];
+
+                active[v].store(0,std::memory_order_relaxed);
+
+                uint32_t chosen=chooseLabel(g,label.get(),v,options.weighted,votes);
+
+                if (chosen==label[v].load(std::memory_order_relaxed)) continue;
+                label[v].store(chosen,std::memory_order_relaxed);
+                for (size_t i=g.offsets[v];i<g.offsets[v+1];i++)
+                {
+                    uint32_t t=g.targets[i];
+
+                    if (active[t].load(std::memory_order_relaxed)==0
+                        &&active[t].exchange(1,std::memory_order_relaxed)==0)
+                    {
+                        local.push_back(t);
+                    }
+                }
+            }
+
+            size_t pos=nextSize.fetch_add(local.size(),std::memory_order_relaxed);
+
+            std::copy(local.begin(),local.end(),next.begin()+pos);
+        },256);
+        frontier.swap(next);
+        size=nextSize.load(std::memory_order_relaxed);
+    }
+
+    std::vector<uint32_t> number(n,NO_NODE);
+    size_t count=0;
+
+    community.resize(n);
+    for (size_t v=0;v<n;v++)
+    {
+        uint32_t l=label[v].load(std::memory_order_relaxed);
+
+        if (number[l]==NO_NODE) number[l]=(uint32_t) count++;
+        community[v]=number[l];
+    }
+    return count;
+}
+
+size_t labelPropagation(const SimpleGraph & graph,std::unordered_map<Node *,uint32_t> & communities,
+                        const LabelPropagationOptions & options)
+{
+    CSRGraph csr;
+    std::vector<uint32_t> community;
+
+    buildCSR(graph,csr);
+
+    size_t count=labelPropagation(csr,community,options);
+
+    communities.clear();
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        communities[csr.nodes[v]]=community[v];
+    }
+    return count;
+}
@@ -0,0 +1,55 @@
+/*
+ * File: communities.h
+ * -------------------
+ * This interface exports community detection by label propagation. Every node starts in a
+ * community of its own and repeatedly joins the community that carries the most weight among its
+ * neighbors, until no node wants to move. Arcs are treated as undirected edges.
+ */
+
+#ifndef _communities_h
+#define _communities_h
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: LabelPropagationOptions
+ * -----------------------------
+ * This type collects the settings of labelPropagation. If weighted is true, each edge votes with
+ * its cost, which must not be negative; otherwise every edge has one vote. If symmetric is true, the
+ * caller promises that every arc u->v is matched by an arc v->u, which saves building the undirected
+ * graph; otherwise an edge weighs as much as the cheapest arc between its ends. The seed fixes the
+ * order in which each round visits the nodes.
+ */
+
+struct LabelPropagationOptions
+{
+    bool weighted;                              /* Votes are weighted by arc cost */
+    bool symmetric;                             /* Arcs already come in opposite pairs */
+    int maxIterations;                          /* Limit on the number of rounds */
+    unsigned long long seed;                    /* Seed for the visiting order */
+
+    LabelPropagationOptions() : weighted(true),symmetric(false),maxIterations(20),seed(1) {}
+};
+
+/*
+ * Function: labelPropagation
+ * Usage: size_t count=labelPropagation(csr,community);
+ *        size_t count=labelPropagation(graph,communities,options);
+ * -------------------------------------------------------------
+ * Finds communities and returns their number. The CSR form sets community[v] to a number between 0
+ * and count-1, assigned in order of the smallest node of each community; the SimpleGraph form
+ * converts the graph and reports the number by node. The work runs on the current thread pool, and
+ * nodes see the moves of other threads as soon as they happen, so the result may differ from run to
+ * run when more than one thread is used.
+ */
+
+size_t labelPropagation(const CSRGraph & graph,std::vector<uint32_t> & community,
+                        const LabelPropagationOptions & options=LabelPropagationOptions());
+size_t labelPropagation(const SimpleGraph & graph,std::unordered_map<Node *,uint32_t> & communities,
+                        const LabelPropagationOptions & options=LabelPropagationOptions());
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * File: components.cpp
+ * --------------------
+ * This file implements the components.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include "components.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: union-find
+ * --------------------------------
+ * The components form a union-find forest stored in parent, in which every root is the smallest index
+ * of its tree. Linking hooks the larger of two roots below the smaller one with compare-and-swap, so
+ * concurrent links never form a cycle; a failed swap means another thread changed the root, and
+ * link climbs one more level and tries again. Between phases compress points every node directly
+ * at its root. All accesses are relaxed: a thread that reads a stale parent only climbs further.
+ */
+
+typedef std::atomic<uint32_t> Label;
+
+static uint32_t parentOf(Label * parent,uint32_t v)
+{
+    return parent[v].load(std::memory_order_relaxed);
+}
+
+static void link(Label * parent,uint32_t u,uint32_t v)
+{
+    uint32_t p1=parentOf(parent,u);
+    uint32_t p2=parentOf(parent,v);
+
+    while (p1!=p2)
+    {
+        uint32_t high=std::max(p1,p2);
+        uint32_t low=std::min(p1,p2);
+        uint32_t above=parentOf(parent,high);
+
+        if (above==low) return;
+        if (above==high
+            &&parent[high].compare_exchange_strong(above,low,std::memory_order_relaxed))
+        {
+            return;
+        }
+        p1=parentOf(parent,parentOf(parent,high));
+        p2=parentOf(parent,low);
+    }
+}
+
+static void compress(ThreadPool & pool,Label * parent,size_t nodeCount)
+{
+    TRACE_SCOPE("components.compress");
+    pool.parallelFor(0,nodeCount,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            uint32_t p=parentOf(parent,v);
+
+            while (p!=parentOf(parent,p))
+            {
+                p=parentOf(parent,p);
+            }
+            parent[v].store(p,std::memory_order_relaxed);
+        }
+    },4096);
+}
+
+/*
+ * Implementation notes: mostFrequentLabel
+ * ---------------------------------------
+ * Estimates the label of the largest component from a fixed random sample of nodes. The seed is
+ * constant, so the estimate, and with it the work done, is the same on every run.
+ */
+
+const size_t LABEL_SAMPLES=1024;
+
+static uint32_t mostFrequentLabel(Label * parent,size_t nodeCount)
+{
+    std::mt19937 rng(27491095);
+    std::uniform_int_distribution<uint32_t> pick(0,(uint32_t) (nodeCount-1));
+    std::unordered_map<uint32_t,size_t> counts;
+    uint32_t best=0;
+    size_t bestCount=0;
+
+    for (size_t i=0;i<LABEL_SAMPLES;i++)
+    {
+        uint32_t label=parentOf(parent,pick(rng));
+        size_t count=++counts[label];
+
+        if (count>bestCount)
+        {
+            best=label;
+            bestCount=count;
+        }
+    }
+    return best;
+}
+
+/*
+ * Implementation notes: connectedComponents
+ * -----------------------------------------
+ * This is the Afforest algorithm of Sutton, Ben-Nun and Barak. The first NEIGHBOR_ROUNDS arcs of
+ * every node are linked in separate rounds, which in graphs with a giant component already merges
+ * most nodes into it. A sample then identifies that component, and the final phase links the
+ * remaining arcs of every node outside it only. In a symmetric graph an arc leaving the giant
+ * component is also seen from its other end, so the nodes of the giant component are skipped
+ * entirely; otherwise their remaining arcs are still scanned, but only those leading outside the
+ * component are linked.
+ */
+
+const size_t NEIGHBOR_ROUNDS=2;
+const size_t COMPONENTS_GRAIN=1024;
+
+size_t connectedComponents(const CSRGraph & graph,std::vector<uint32_t> & component,
+                           bool symmetric,PerfStats * stats)
+{
+    TRACE_SCOPE("connectedComponents");
+    PERF_SCOPE(stats);
+    ThreadPool & pool=ThreadPool::current();
+    size_t n=graph.nodeCount;
+    std::unique_ptr<Label[]> parent(new Label[n]);
+    std::atomic<size_t> scanned(0);
+    std::atomic<size_t> count(0);
+
+    component.resize(n);
+    if (n==0) return 0;
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++) parent[v].store((uint32_t) v,std::memory_order_relaxed);
+    },4096);
+    for (size_t round=0;round<NEIGHBOR_ROUNDS;round++)
+    {
+        TRACE_SCOPE_VALUE("components.round",round);
+        pool.parallelFor(0,n,[&](size_t first,size_t last)
+        {
+            size_t arcs=0;
+
+            for (size_t v=first;v<last;v++)
+            {
+                if (graph.degree(v)>round)
+                {
+                    link(parent.get(),v,graph.targets[graph.offsets[v]+round]);
+                    arcs++;
+                }
+            }
+            scanned.fetch_add(arcs,std::memory_order_relaxed);
+        },COMPONENTS_GRAIN);
+        compress(pool,parent.get(),n);
+    }
+
+    uint32_t giant=mostFrequentLabel(parent.get(),n);
+
+    {
+        TRACE_SCOPE("components.finish");
+        pool.parallelFor(0,n,[&](size_t first,size_t last)
+        {
+            size_t arcs=0;
+
+            for (size_t v=first;v<last;v++)
+            {
+                bool inGiant=(parentOf(parent.get(),v)==giant);
+
+                if (inGiant&&symmetric) continue;
+                for (size_t i=graph.offsets[v]+NEIGHBOR_ROUNDS;i<graph.offsets[v+1];i++)
+                {
+                    uint32_t u=graph.targets[i];
+
+                    if (!inGiant||parentOf(parent.get(),u)!=giant) link(parent.get(),v,u);
+                }
+                if (graph.degree(v)>NEIGHBOR_ROUNDS) arcs+=graph.degree(v)-NEIGHBOR_ROUNDS;
+            }
+            scanned.fetch_add(arcs,std::memory_order_relaxed);
+        },COMPONENTS_GRAIN);
+    }
+    compress(pool,parent.get(),n);
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        size_t roots=0;
+
+        for (size_t v=first;v<last;v++)
+        {
+            component[v]=parentOf(parent.get(),v);
+            if (component[v]==v) roots++;
+        }
+        count.fetch_add(roots,std::memory_order_relaxed);
+    },4096);
+    PERF_COUNT(stats,nodesVisited,n);
+    PERF_COUNT(stats,arcsScanned,scanned.load());
+    return count.load();
+}
@@ -0,0 +1,34 @@
+/*
+ * File: components.h
+ * ------------------
+ * This interface exports a parallel algorithm for the connected components of a graph in CSR form.
+ * Arcs are treated as undirected edges, so for a directed graph the result is the weakly connected
+ * components.
+ */
+
+#ifndef _components_h
+#define _components_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "csrgraph.h"
+#include "perfstats.h"
+
+/*
+ * Function: connectedComponents
+ * Usage: size_t count=connectedComponents(csr,component);
+ *        size_t count=connectedComponents(csr,component,true,&stats);
+ * -------------------------------------------------------------------
+ * Labels every node with its component and returns the number of components. On return
+ * component[v] is the smallest node index in the component of v, so the labels do not depend on the
+ * number of threads. The work runs on the current thread pool in time close to linear in the size of
+ * the graph. If symmetric is true, the caller promises that every arc u->v is matched by an arc
+ * v->u, as in the undirected graphs made by the generators, which lets the search skip most of the
+ * arcs of the largest component.
+ */
+
+size_t connectedComponents(const CSRGraph & graph,std::vector<uint32_t> & component,
+                           bool symmetric=false,PerfStats * stats=NULL);
+
+#endif
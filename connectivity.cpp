@@ -0,0 +1,241 @@
+/*
+ * File: connectivity.cpp
+ * ----------------------
+ * This file implements the connectivity.h interface.
+ */
+
+#include <algorithm>
+#include "connectivity.h"
+#include "error.h"
+
+IncrementalConnectivity::IncrementalConnectivity(size_t capacity)
+{
+    init(capacity);
+}
+
+IncrementalConnectivity::IncrementalConnectivity(const SimpleGraph & graph,size_t capacity)
+{
+    init(std::max(capacity,2*(size_t) graph.nodes.size()));
+    for (Node * node:graph.nodes)
+    {
+        addNode(node);
+    }
+    for (Arc * arc:graph.arcs)
+    {
+        addArc(arc);
+    }
+}
+
+void IncrementalConnectivity::init(size_t capacity)
+{
+    if (capacity>=NO_NODE) error("IncrementalConnectivity: capacity too large");
+    this->capacity=capacity;
+    parent.reset(new std::atomic<uint32_t>[capacity]);
+    size.reset(new std::atomic<uint32_t>[capacity]);
+    rank.assign(capacity,0);
+    for (size_t v=0;v<capacity;v++)
+    {
+        parent[v].store((uint32_t) v,std::memory_order_relaxed);
+        size[v].store(1,std::memory_order_relaxed);
+    }
+    nodes.store(0);
+    components.store(0);
+}
+
+uint32_t IncrementalConnectivity::addNode()
+{
+    size_t v=nodes.fetch_add(1);
+
+    if (v>=capacity)
+    {
+        nodes.fetch_sub(1);
+        error("IncrementalConnectivity: capacity exhausted");
+    }
+    components.fetch_add(1);
+    return (uint32_t) v;
+}
+
+uint32_t IncrementalConnectivity::addNode(Node * node)
+{
+    std::unique_lock<std::shared_mutex> guard(indexLock);
+    std::unordered_map<Node *,uint32_t>::iterator it=index.find(node);
+
+    if (it!=index.end()) return it->second;
+
+    uint32_t v=addNode();
+
+    index[node]=v;
+    return v;
+}
+
+uint32_t IncrementalConnectivity::indexOf(Node * node) const
+{
+    std::shared_lock<std::shared_mutex> guard(indexLock);
+    std::unordered_map<Node *,uint32_t>::const_iterator it=index.find(node);
+
+    return (it==index.end()) ? NO_NODE : it->second;
+}
+
+/*
+ * Implementation notes: find
+ * --------------------------
+ * Path halving points every node on the way at its grandparent. The compare-and-swap makes a
+ * concurrent halving of the same node harmless: whichever wins, the node points at an ancestor.
+ */
+
+uint32_t IncrementalConnectivity::find(uint32_t v)
+{
+    while (true)
+    {
+        uint32_t p=parent[v].load(std::memory_order_acquire);
+
+        if (p==v) return v;
+
+        uint32_t grandparent=parent[p].load(std::memory_order_acquire);
+
+        if (grandparent==p) return p;
+        parent[v].compare_exchange_weak(p,grandparent,std::memory_order_release,
+                                        std::memory_order_relaxed);
+        v=grandparent;
+    }
+}
+
+void IncrementalConnectivity::checkNode(uint32_t v) const
+{
+    if (v>=nodes.load(std::memory_order_relaxed)) error("IncrementalConnectivity: no such node");
+}
+
+bool IncrementalConnectivity::addArc(uint32_t u,uint32_t v)
+{
+    checkNode(u);
+    checkNode(v);
+    if (find(u)==find(v)) return false;
+
+    std::shared_lock<std::shared_mutex> merging(mergeLock);
+
+    while (true)
+    {
+        uint32_t ru=find(u);
+        uint32_t rv=find(v);
+
+        if (ru==rv) return false;
+
+        std::mutex & first=stripes[std::min(ru%LOCK_STRIPES,rv%LOCK_STRIPES)];
+        std::mutex & second=stripes[std::max(ru%LOCK_STRIPES,rv%LOCK_STRIPES)];
+        std::unique_lock<std::mutex> lock1(first);
+        std::unique_lock<std::mutex> lock2;
+
+        if (&second!=&first) lock2=std::unique_lock<std::mutex>(second);
+        if (parent[ru].load(std::memory_order_relaxed)!=ru
+            ||parent[rv].load(std::memory_order_relaxed)!=rv)
+        {
+            continue;
+        }
+        if (rank[ru]>rank[rv]) std::swap(ru,rv);
+        if (rank[ru]==rank[rv]) rank[rv]++;
+        size[rv].fetch_add(size[ru].load(std::memory_order_relaxed),std::memory_order_relaxed);
+        parent[ru].store(rv,std::memory_order_release);
+        components.fetch_sub(1,std::memory_order_relaxed);
+        return true;
+    }
+}
+
+bool IncrementalConnectivity::addArc(Node * start,Node * finish)
+{
+    uint32_t u=indexOf(start);
+    uint32_t v=indexOf(finish);
+
+    if (u==NO_NODE) u=addNode(start);
+    if (v==NO_NODE) v=addNode(finish);
+    return addArc(u,v);
+}
+
+bool IncrementalConnectivity::addArc(Arc * arc)
+{
+    return addArc(arc->start,arc->finish);
+}
+
+/*
+ * Implementation notes: isConnected
+ * ---------------------------------
+ * Two finds are not atomic with respect to merges: the root of u may be hooked below another node
+ * after it was found. The roots are therefore compared again until the first one is still a root,
+ * which means the answer was true at that moment.
+ */
+
+bool IncrementalConnectivity::isConnected(uint32_t u,uint32_t v)
+{
+    checkNode(u);
+    checkNode(v);
+    while (true)
+    {
+        uint32_t ru=find(u);
+        uint32_t rv=find(v);
+
+        if (ru==rv) return true;
+        if (parent[ru].load(std::memory_order_acquire)==ru) return false;
+    }
+}
+
+bool IncrementalConnectivity::isConnected(Node * u,Node * v)
+{
+    if (u==v) return true;
+
+    uint32_t iu=indexOf(u);
+    uint32_t iv=indexOf(v);
+
+    if (iu==NO_NODE||iv==NO_NODE) return false;
+    return isConnected(iu,iv);
+}
+
+size_t IncrementalConnectivity::componentSize(uint32_t v)
+{
+    checkNode(v);
+    while (true)
+    {
+        uint32_t root=find(v);
+        size_t result=size[root].load(std::memory_order_relaxed);
+
+        if (parent[root].load(std::memory_order_acquire)==root) return result;
+    }
+}
+
+size_t IncrementalConnectivity::componentSize(Node * v)
+{
+    uint32_t iv=indexOf(v);
+
+    return (iv==NO_NODE) ? 1 : componentSize(iv);
+}
+
+size_t IncrementalConnectivity::componentCount() const
+{
+    return components.load(std::memory_order_relaxed);
+}
+
+size_t IncrementalConnectivity::nodeCount() const
+{
+    return nodes.load(std::memory_order_relaxed);
+}
+
+/*
+ * Implementation notes: snapshot
+ * ------------------------------
+ * With merges stopped, the nodes are visited in increasing order, so the first node found in a tree
+ * is the smallest one and becomes the label of its root.
+ */
+
+void IncrementalConnectivity::snapshot(std::vector<uint32_t> & labels)
+{
+    std::unique_lock<std::shared_mutex> guard(mergeLock);
+    size_t n=nodes.load();
+    std::vector<uint32_t> smallest(n,NO_NODE);
+
+    labels.resize(n);
+    for (size_t v=0;v<n;v++)
+    {
+        uint32_t root=find((uint32_t) v);
+
+        if (smallest[root]==NO_NODE) smallest[root]=(uint32_t) v;
+        labels[v]=smallest[root];
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * File: connectivity.h
+ * --------------------
+ * This interface exports the IncrementalConnectivity class, which keeps track of the connected
+ * components of a graph while arcs are being added to it. Connectivity and component-size queries
+ * take nearly constant time, and queries and insertions may come from any number of threads at
+ * once. Arcs are treated as undirected edges; arcs cannot be removed.
+ */
+
+#ifndef _connectivity_h
+#define _connectivity_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Class: IncrementalConnectivity
+ * ------------------------------
+ * This class is a concurrent union-find structure over the nodes 0 .. nodeCount()-1. Nodes are
+ * either numbered by the caller or registered as Node pointers from a SimpleGraph, in which case
+ * the structure assigns the numbers. Room for all nodes is reserved when the structure is created.
+ */
+
+class IncrementalConnectivity
+{
+public:
+
+/*
+ * Constructor: IncrementalConnectivity
+ * Usage: IncrementalConnectivity conn(capacity);
+ *        IncrementalConnectivity conn(graph,capacity);
+ * ----------------------------------------------------
+ * Creates a structure with room for capacity nodes. The first form starts with no nodes; the second
+ * registers every node and arc already in graph, reserving room for at least twice its node count
+ * unless capacity is larger.
+ */
+
+    explicit IncrementalConnectivity(size_t capacity);
+    IncrementalConnectivity(const SimpleGraph & graph,size_t capacity=0);
+
+/*
+ * Method: addNode
+ * Usage: uint32_t v=conn.addNode();
+ *        uint32_t v=conn.addNode(node);
+ * -------------------------------------
+ * Adds a node in a component of its own and returns its number. The second form also associates
+ * the number with node; if node is already registered, its existing number is returned. Both
+ * signal an error when the capacity is exhausted.
+ */
+
+    uint32_t addNode();
+    uint32_t addNode(Node * node);
+
+/*
+ * Method: addArc
+ * Usage: conn.addArc(u,v);
+ *        conn.addArc(arc);
+ * ------------------------
+ * Records an arc between two nodes and returns true if it joined two components. The Arc form is
+ * meant to be called for every arc added to the graph, and registers endpoints it has not seen.
+ */
+
+    bool addArc(uint32_t u,uint32_t v);
+    bool addArc(Node * start,Node * finish);
+    bool addArc(Arc * arc);
+
+/*
+ * Method: isConnected
+ * Usage: if (conn.isConnected(u,v)) . . .
+ * ---------------------------------------
+ * Returns true if u and v are in the same component. Unregistered nodes are connected to nothing
+ * but themselves.
+ */
+
+    bool isConnected(uint32_t u,uint32_t v);
+    bool isConnected(Node * u,Node * v);
+
+/*
+ * Methods: componentSize, componentCount, nodeCount
+ * Usage: size_t n=conn.componentSize(v);
+ * --------------------------------------
+ * Return the number of nodes in the component of v, the number of components and the number of
+ * nodes. While insertions are running the answers reflect some recent state.
+ */
+
+    size_t componentSize(uint32_t v);
+    size_t componentSize(Node * v);
+    size_t componentCount() const;
+    size_t nodeCount() const;
+
+/*
+ * Method: indexOf
+ * Usage: uint32_t v=conn.indexOf(node);
+ * -------------------------------------
+ * Returns the number of a registered node, or NO_NODE if node is not registered.
+ */
+
+    uint32_t indexOf(Node * node) const;
+
+/*
+ * Method: snapshot
+ * Usage: conn.snapshot(labels);
+ * -----------------------------
+ * Fills labels with the component of every node, labeled like connectedComponents by the smallest
+ * node number in the component. The snapshot is consistent: insertions that would merge components
+ * wait until it is taken.
+ */
+
+    void snapshot(std::vector<uint32_t> & labels);
+
+private:
+
+/*
+ * Implementation notes: data structure
+ * ------------------------------------
+ * parent holds the union-find forest. find is lock-free and shortens paths by halving, which only
+ * ever redirects a non-root to one of its ancestors and therefore can run concurrently with anything.
+ * Merging two roots is the only step that needs mutual exclusion: it locks the stripes of both
+ * roots, checks that they are still roots, and hooks the root of lower rank below the other. A graph
+ * of n nodes has at most n-1 merges, so these locks are rarely contended, and queries never take
+ * them. The size of a component is kept at its root. Merges hold mergeLock in shared mode so that
+ * snapshot can stop them all by taking it exclusively.
+ */
+
+    static const size_t LOCK_STRIPES=256;
+
+/* Instance variables */
+
+    size_t capacity;
+    std::unique_ptr<std::atomic<uint32_t>[]> parent;
+    std::unique_ptr<std::atomic<uint32_t>[]> size;
+    std::vector<uint8_t> rank;                  /* Changed only under the stripe locks */
+    std::atomic<size_t> nodes;
+    std::atomic<size_t> components;
+    std::mutex stripes[LOCK_STRIPES];
+    std::shared_mutex mergeLock;
+    mutable std::shared_mutex indexLock;
+    std::unordered_map<Node *,uint32_t> index;
+
+/* Private method prototypes */
+
+    void init(size_t capacity);
+    uint32_t find(uint32_t v);
+    void checkNode(uint32_t v) const;
+
+    IncrementalConnectivity(const IncrementalConnectivity &);
+    IncrementalConnectivity & operator=(const IncrementalConnectivity &);
+};
+
+#endif
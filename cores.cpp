@@ -0,0 +1,232 @@
+/*
+ * File: cores.cpp
+ * ---------------
+ * This file implements the cores.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "bucketqueue.h"
+#include "cores.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: simpleDegree
+ * ----------------------------------
+ * Returns the number of distinct neighbors of v other than v itself. Rows are sorted by target, so
+ * parallel arcs are adjacent; the peeling loops skip them the same way.
+ */
+
+static uint32_t simpleDegree(const CSRGraph & graph,uint32_t v)
+{
+    uint32_t count=0;
+    uint32_t last=NO_NODE;
+
+    for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+    {
+        uint32_t t=graph.targets[i];
+
+        if (t!=last&&t!=v) count++;
+        last=t;
+    }
+    return count;
+}
+
+/*
+ * Implementation notes: coreNumbers
+ * ---------------------------------
+ * This is the algorithm of Batagelj and Zaversnik. The nodes wait in a bucket queue keyed by their
+ * degree in the part of the graph not yet removed. The node with the smallest key is removed with
+ * that key as its core number, and each remaining neighbor with a larger key loses one; a neighbor
+ * whose key equals the current one already has its core number fixed. Every arc is looked at once
+ * from each end, and every queue operation takes constant time.
+ */
+
+uint32_t coreNumbers(const CSRGraph & graph,std::vector<uint32_t> & core,bool symmetric)
+{
+    TRACE_SCOPE("coreNumbers");
+    CSRGraph undirected;
+
+    if (!symmetric) symmetrizeCSR(graph,undirected);
+
+    const CSRGraph & g=symmetric ? graph : undirected;
+    size_t n=g.nodeCount;
+    std::vector<uint32_t> degree(n);
+    uint32_t degeneracy=0;
+
+    for (size_t v=0;v<n;v++) degree[v]=simpleDegree(g,(uint32_t) v);
+
+    BucketQueue queue(degree);
+
+    core.resize(n);
+    while (!queue.isEmpty())
+    {
+        uint32_t v=queue.dequeue();
+        uint32_t k=queue.key(v);
+        uint32_t last=NO_NODE;
+
+        core[v]=k;
+        degeneracy=std::max(degeneracy,k);
+        for (size_t i=g.offsets[v];i<g.offsets[v+1];i++)
+        {
+            uint32_t t=g.targets[i];
+
+            if (t==last) continue;
+            last=t;
+            if (queue.contains(t)&&queue.key(t)>k) queue.decrementKey(t);
+        }
+    }
+    return degeneracy;
+}
+
+/*
+ * Implementation notes: parallelCoreNumbers
+ * -----------------------------------------
+ * The parallel version peels the graph one core number k at a time. A level starts by splitting the
+ * nodes not yet peeled into a frontier, those whose degree is at most k, and the rest; if the
+ * frontier is empty, k jumps to the smallest remaining degree. Frontier nodes get core number k and
+ * are processed with parallelFor: each lowers the degree of its neighbors that are still above k
+ * with compare-and-swap, and the thread that brings a degree down to exactly k adds that node to
+ * the next frontier, so every node is peeled exactly once. Degrees at or below k are never lowered,
+ * which keeps the degrees of peeled nodes fixed without a separate flag. As in the parallel
+ * breadth-first search, threads collect nodes in local buffers and copy them out with one atomic
+ * reservation per piece. Each level scans the remaining nodes once, so the total work is linear in
+ * the size of the graph plus the sum over levels of the nodes left.
+ */
+
+const size_t PARALLEL_CORE_GRAIN=256;
+
+static void append(const std::vector<uint32_t> & local,std::vector<uint32_t> & out,
+                   std::atomic<size_t> & size)
+{
+    size_t pos=size.fetch_add(local.size(),std::memory_order_relaxed);
+
+    std::copy(local.begin(),local.end(),out.begin()+pos);
+}
+
+static void lowerTo(std::atomic<uint32_t> & value,uint32_t bound)
+{
+    uint32_t seen=value.load(std::memory_order_relaxed);
+
+    while (bound<seen)
+    {
+        if (value.compare_exchange_weak(seen,bound,std::memory_order_relaxed)) return;
+    }
+}
+
+static bool decrementAbove(std::atomic<uint32_t> & degree,uint32_t k)
+{
+    uint32_t d=degree.load(std::memory_order_relaxed);
+
+    while (d>k)
+    {
+        if (degree.compare_exchange_weak(d,d-1,std::memory_order_relaxed)) return d==k+1;
+    }
+    return false;
+}
+
+uint32_t parallelCoreNumbers(const CSRGraph & graph,std::vector<uint32_t> & core,bool symmetric)
+{
+    TRACE_SCOPE("parallelCoreNumbers");
+    ThreadPool & pool=ThreadPool::current();
+    CSRGraph undirected;
+
+    if (!symmetric) symmetrizeCSR(graph,undirected);
+
+    const CSRGraph & g=symmetric ? graph : undirected;
+    size_t n=g.nodeCount;
+    std::unique_ptr<std::atomic<uint32_t>[]> degree(new std::atomic<uint32_t>[n]);
+    std::vector<uint32_t> remaining(n),rest(n),frontier(n),next(n);
+    size_t remainingSize=n;
+    std::atomic<size_t> restSize(0),frontierSize(0),nextSize(0);
+    std::atomic<uint32_t> smallest(0);
+    uint32_t k=0;
+
+    core.assign(n,NO_NODE);
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            degree[v].store(simpleDegree(g,(uint32_t) v),std::memory_order_relaxed);
+            remaining[v]=(uint32_t) v;
+        }
+    },4096);
+    while (remainingSize>0)
+    {
+        TRACE_SCOPE_VALUE("cores.level",k);
+
+        restSize.store(0,std::memory_order_relaxed);
+        frontierSize.store(0,std::memory_order_relaxed);
+        smallest.store(UINT32_MAX,std::memory_order_relaxed);
+        pool.parallelFor(0,remainingSize,[&](size_t first,size_t last)
+        {
+            std::vector<uint32_t> low,high;
+            uint32_t least=UINT32_MAX;
+
+            for (size_t i=first;i<last;i++)
+            {
+                uint32_t v=remaining[i];
+                uint32_t d=degree[v].load(std::memory_order_relaxed);
+
+                if (core[v]!=NO_NODE) continue;
+                if (d<=k)
+                {
+                    low.push_back(v);
+                } else
+                {
+                    high.push_back(v);
+                    least=std::min(least,d);
+                }
+            }
+            append(low,frontier,frontierSize);
+            append(high,rest,restSize);
+
+            lowerTo(smallest,least);
+        },4096);
+        remaining.swap(rest);
+        remainingSize=restSize.load(std::memory_order_relaxed);
+
+        size_t size=frontierSize.load(std::memory_order_relaxed);
+
+        if (size==0)
+        {
+            k=smallest.load(std::memory_order_relaxed);
+            continue;
+        }
+        while (size>0)
+        {
+            nextSize.store(0,std::memory_order_relaxed);
+            pool.parallelFor(0,size,[&](size_t first,size_t last)
+            {
+                std::vector<uint32_t> local;
+
+                for (size_t i=first;i<last;i++)
+                {
+                    uint32_t v=frontier[i];
+                    uint32_t previous=NO_NODE;
+
+                    core[v]=k;
+                    for (size_t a=g.offsets[v];a<g.offsets[v+1];a++)
+                    {
+                        uint32_t t=g.targets[a];
+
+                        if (t==previous) continue;
+                        previous=t;
+                        if (decrementAbove(degree[t],k)) local.push_back(t);
+                    }
+                }
+                append(local,next,nextSize);
+            },PARALLEL_CORE_GRAIN);
+            frontier.swap(next);
+            size=nextSize.load(std::memory_order_relaxed);
+        }
+        k++;
+    }
+
+    uint32_t degeneracy=0;
+
+    for (uint32_t c:core) degeneracy=std::max(degeneracy,c);
+    return degeneracy;
+}
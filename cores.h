@@ -0,0 +1,42 @@
+/*
+ * File: cores.h
+ * -------------
+ * This interface exports the k-core decomposition of a graph in CSR form. The k-core is the largest
+ * subgraph in which every node has at least k neighbors, and the core number of a node is the
+ * largest k for which it belongs to the k-core. Arcs are treated as undirected edges; self-loops
+ * and parallel arcs are ignored.
+ */
+
+#ifndef _cores_h
+#define _cores_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Function: coreNumbers
+ * Usage: uint32_t degeneracy=coreNumbers(csr,core);
+ *        uint32_t degeneracy=coreNumbers(csr,core,true);
+ * ------------------------------------------------------
+ * Sets core[v] to the core number of every node and returns the largest one, the degeneracy of the
+ * graph. This version runs on the calling thread in time linear in the size of the graph. If
+ * symmetric is true, the caller promises that every arc u->v is matched by an arc v->u, which saves
+ * building the undirected graph.
+ */
+
+uint32_t coreNumbers(const CSRGraph & graph,std::vector<uint32_t> & core,bool symmetric=false);
+
+/*
+ * Function: parallelCoreNumbers
+ * Usage: uint32_t degeneracy=parallelCoreNumbers(csr,core);
+ *        uint32_t degeneracy=parallelCoreNumbers(csr,core,true);
+ * --------------------------------------------------------------
+ * Computes the same core numbers as coreNumbers on the current thread pool.
+ */
+
+uint32_t parallelCoreNumbers(const CSRGraph & graph,std::vector<uint32_t> & core,
+                             bool symmetric=false);
+
+#endif
@@ -0,0 +1,452 @@
+/*
+ * File: csrgraph.cpp
+ * ------------------
+ * This file implements the csrgraph.h interface.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include "csrgraph.h"
+#include "error.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: sortArcs
+ * ------------------------------
+ * Rows are almost always short, so a permutation buffer is reused from row to row and rows that are
+ * already sorted are skipped. The optional arc pointers are carried along with the targets.
+ */
+
+void sortArcs(CSRGraph & csr,size_t first,size_t last)
+{
+    std::vector<size_t> perm;
+    std::vector<uint32_t> targets;
+    std::vector<double> costs;
+    std::vector<Arc *> arcs;
+    bool hasArcs=!csr.arcs.empty();
+
+    for (size_t v=first;v<last;v++)
+    {
+        size_t begin=csr.offsets[v];
+        size_t end=csr.offsets[v+1];
+        bool sorted=true;
+
+        for (size_t i=begin+1;i<end&&sorted;i++)
+        {
+            sorted=csr.targets[i-1]<csr.targets[i]
+                    ||(csr.targets[i-1]==csr.targets[i]&&csr.costs[i-1]<=csr.costs[i]);
+        }
+        if (sorted) continue;
+        perm.resize(end-begin);
+        for (size_t i=0;i<perm.size();i++) perm[i]=begin+i;
+        std::stable_sort(perm.begin(),perm.end(),[&](size_t a,size_t b)
+        {
+            if (csr.targets[a]!=csr.targets[b]) return csr.targets[a]<csr.targets[b];
+            return csr.costs[a]<csr.costs[b];
+        });
+        targets.resize(perm.size());
+        costs.resize(perm.size());
+        arcs.resize(perm.size());
+        for (size_t i=0;i<perm.size();i++)
+        {
+            targets[i]=csr.targets[perm[i]];
+            costs[i]=csr.costs[perm[i]];
+            if (hasArcs) arcs[i]=csr.arcs[perm[i]];
+        }
+        std::copy(targets.begin(),targets.end(),csr.targets.begin()+begin);
+        std::copy(costs.begin(),costs.end(),csr.costs.begin()+begin);
+        if (hasArcs) std::copy(arcs.begin(),arcs.end(),csr.arcs.begin()+begin);
+    }
+}
+
+/*
+ * Implementation notes: buildCSR
+ * ------------------------------
+ * Nodes are numbered in the iteration order of the node set. The SimpleGraph version copies each
+ * node's arc set into its row; the EdgeList version counts the out-degrees, turns them into row
+ * offsets with a prefix sum and scatters the arcs into place.
+ */
+
+void buildCSR(const SimpleGraph & graph,CSRGraph & csr)
+{
+    TRACE_SCOPE("buildCSR");
+    uint32_t next=0;
+
+    csr=CSRGraph();
+    csr.nodeCount=graph.nodes.size();
+    csr.nodes.reserve(csr.nodeCount);
+    csr.index.reserve(csr.nodeCount);
+    for (Node * node:graph.nodes)
+    {
+        csr.nodes.push_back(node);
+        csr.index[node]=next++;
+    }
+    csr.offsets.assign(csr.nodeCount+1,0);
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        csr.offsets[v+1]=csr.offsets[v]+csr.nodes[v]->arcs.size();
+    }
+    csr.targets.resize(csr.offsets[csr.nodeCount]);
+    csr.costs.resize(csr.offsets[csr.nodeCount]);
+    csr.arcs.resize(csr.offsets[csr.nodeCount]);
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        size_t pos=csr.offsets[v];
+
+        for (Arc * arc:csr.nodes[v]->arcs)
+        {
+            std::unordered_map<Node *,uint32_t>::const_iterator it=csr.index.find(arc->finish);
+
+            if (it==csr.index.end()) error("buildCSR: arc leads to a node outside the graph");
+            csr.targets[pos]=it->second;
+            csr.costs[pos]=arc->cost;
+            csr.arcs[pos]=arc;
+            pos++;
+        }
+    }
+    sortArcs(csr,0,csr.nodeCount);
+}
+
+void buildCSR(const EdgeList & edges,CSRGraph & csr)
+{
+    TRACE_SCOPE("buildCSR");
+    size_t m=edges.sources.size();
+    bool hasCosts=!edges.costs.empty();
+
+    if (edges.targets.size()!=m||(hasCosts&&edges.costs.size()!=m))
+    {
+        error("buildCSR: edge list arrays differ in length");
+    }
+    csr=CSRGraph();
+    csr.nodeCount=edges.nodeCount;
+    csr.offsets.assign(csr.nodeCount+1,0);
+    for (size_t i=0;i<m;i++)
+    {
+        if (edges.sources[i]>=csr.nodeCount||edges.targets[i]>=csr.nodeCount)
+        {
+            error("buildCSR: edge endpoint out of range");
+        }
+        csr.offsets[edges.sources[i]+1]++;
+    }
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        csr.offsets[v+1]+=csr.offsets[v];
+    }
+    csr.targets.resize(m);
+    csr.costs.resize(m);
+
+    std::vector<size_t> pos(csr.offsets.begin(),csr.offsets.end()-1);
+
+    for (size_t i=0;i<m;i++)
+    {
+        size_t p=pos[edges.sources[i]]++;
+
+        csr.targets[p]=edges.targets[i];
+        csr.costs[p]=hasCosts ? edges.costs[i] : 1.0;
+    }
+    sortArcs(csr,0,csr.nodeCount);
+}
+
+/*
+ * Implementation notes: reverseCSR
+ * --------------------------------
+ * The rows of the reverse graph are filled by a counting sort over the arcs of csr. The sources are
+ * visited in increasing order, so every reverse row comes out sorted by target; only rows with
+ * parallel arcs of different costs may still need sortArcs.
+ */
+
+void reverseCSR(const CSRGraph & csr,CSRGraph & reverse)
+{
+    TRACE_SCOPE("reverseCSR");
+    size_t m=csr.arcCount();
+
+    reverse=CSRGraph();
+    reverse.nodeCount=csr.nodeCount;
+    reverse.offsets.assign(csr.nodeCount+1,0);
+    for (uint32_t target:csr.targets)
+    {
+        reverse.offsets[target+1]++;
+    }
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        reverse.offsets[v+1]+=reverse.offsets[v];
+    }
+    reverse.targets.resize(m);
+    reverse.costs.resize(m);
+
+    std::vector<size_t> pos(reverse.offsets.begin(),reverse.offsets.end()-1);
+
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        for (size_t i=csr.offsets[v];i<csr.offsets[v+1];i++)
+        {
+            size_t p=pos[csr.targets[i]]++;
+
+            reverse.targets[p]=(uint32_t) v;
+            reverse.costs[p]=csr.costs[i];
+        }
+    }
+    sortArcs(reverse,0,reverse.nodeCount);
+}
+
+/*
+ * Implementation notes: symmetrizeCSR
+ * -----------------------------------
+ * Every row of the result is the merge of the same row in csr and in its reverse, both of which are
+ * sorted by target. The merge runs twice, first only counting the distinct targets to size the
+ * rows and then filling them, so no temporary edge list is needed.
+ */
+
+static size_t mergeRows(const CSRGraph & a,const CSRGraph & b,uint32_t v,uint32_t * targets,
+                        double * costs)
+{
+    size_t i=a.offsets[v],j=b.offsets[v];
+    size_t count=0;
+    uint32_t last=NO_NODE;
+
+    while (i<a.offsets[v+1]||j<b.offsets[v+1])
+    {
+        uint32_t t;
+        double c;
+
+        if (j==b.offsets[v+1]||(i<a.offsets[v+1]&&a.targets[i]<=b.targets[j]))
+        {
+            t=a.targets[i];
+            c=a.costs[i++];
+        } else
+        {
+            t=b.targets[j];
+            c=b.costs[j++];
+        }
+        if (t==v) continue;
+        if (t!=last)
+        {
+            if (targets!=NULL)
+            {
+                targets[count]=t;
+                costs[count]=c;
+            }
+            last=t;
+            count++;
+        } else if (targets!=NULL)
+        {
+            costs[count-1]=std::min(costs[count-1],c);
+        }
+    }
+    return count;
+}
+
+void symmetrizeCSR(const CSRGraph & csr,CSRGraph & undirected)
+{
+    TRACE_SCOPE("symmetrizeCSR");
+    CSRGraph reverse;
+
+    reverseCSR(csr,reverse);
+    undirected=CSRGraph();
+    undirected.nodeCount=csr.nodeCount;
+    undirected.offsets.assign(csr.nodeCount+1,0);
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        undirected.offsets[v+1]=undirected.offsets[v]+mergeRows(csr,reverse,(uint32_t) v,NULL,NULL);
+    }
+    undirected.targets.resize(undirected.offsets[csr.nodeCount]);
+    undirected.costs.resize(undirected.offsets[csr.nodeCount]);
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        size_t p=undirected.offsets[v];
+
+        mergeRows(csr,reverse,(uint32_t) v,undirected.targets.data()+p,undirected.costs.data()+p);
+    }
+}
+
+/*
+ * Implementation notes: buildSimpleGraph
+ * --------------------------------------
+ * Nodes are allocated first so that every arc can point at its finish node immediately.
+ */
+
+void buildSimpleGraph(CSRGraph & csr,SimpleGraph & graph)
+{
+    TRACE_SCOPE("buildSimpleGraph");
+    csr.nodes.resize(csr.nodeCount);
+    csr.arcs.resize(csr.arcCount());
+    csr.index.clear();
+    csr.index.reserve(csr.nodeCount);
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        Node * node=new Node;
+
+        node->name=std::to_string(v);
+        graph.nodes.add(node);
+        graph.nodeMap[node->name]=node;
+        csr.nodes[v]=node;
+        csr.index[node]=(uint32_t) v;
+    }
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        for (size_t i=csr.offsets[v];i<csr.offsets[v+1];i++)
+        {
+            Arc * arc=new Arc;
+
+            arc->start=csr.nodes[v];
+            arc->finish=csr.nodes[csr.targets[i]];
+            arc->cost=csr.costs[i];
+            arc->start->arcs.add(arc);
+            graph.arcs.add(arc);
+            csr.arcs[i]=arc;
+        }
+    }
+}
+
+void freeGraph(SimpleGraph & graph)
+{
+    for (Arc * arc:graph.arcs)
+    {
+        delete arc;
+    }
+    for (Node * node:graph.nodes)
+    {
+        delete node;
+    }
+    graph.arcs.clear();
+    graph.nodes.clear();
+    graph.nodeMap.clear();
+}
+
+/*
+ * Implementation notes: saveBinaryGraph, loadBinaryGraph
+ * ------------------------------------------------------
+ * The target and cost arrays are transferred with one bulk write or read each. Offsets are stored as
+ * 64-bit values one at a time, so the format does not depend on the size of size_t. The loader
+ * checks the header sizes against the file length before allocating anything, and then checks that
+ * the offsets are nondecreasing, that every target names a node and that every row is sorted by
+ * target, which the duplicate skipping, binary searches and merges of the engines rely on. These
+ * are all the structural properties of a CSRGraph, so a corrupt file is reported instead of being
+ * loaded; the costs are not checked. Nothing is stored in csr unless the whole file is valid.
+ */
+
+static const char GRAPH_MAGIC[4]={'C','S','R','G'};
+static const uint32_t GRAPH_VERSION=1;
+
+void saveBinaryGraph(const CSRGraph & csr,const std::string & filename)
+{
+    TRACE_SCOPE("saveBinaryGraph");
+    std::ofstream out(filename.c_str(),std::ios::binary);
+    uint64_t nodes=csr.nodeCount;
+    uint64_t arcs=csr.arcCount();
+
+    if (!out) error("saveBinaryGraph: can't open " + filename);
+    out.write(GRAPH_MAGIC,sizeof GRAPH_MAGIC);
+    out.write((const char *) &GRAPH_VERSION,sizeof GRAPH_VERSION);
+    out.write((const char *) &nodes,sizeof nodes);
+    out.write((const char *) &arcs,sizeof arcs);
+    for (size_t v=0;v<=csr.nodeCount;v++)
+    {
+        uint64_t offset=csr.offsets[v];
+
+        out.write((const char *) &offset,sizeof offset);
+    }
+    out.write((const char *) csr.targets.data(),arcs*sizeof(uint32_t));
+    out.write((const char *) csr.costs.data(),arcs*sizeof(double));
+    if (!out) error("saveBinaryGraph: write failed for " + filename);
+}
+
+void loadBinaryGraph(const std::string & filename,CSRGraph & csr)
+{
+    TRACE_SCOPE("loadBinaryGraph");
+    std::ifstream in(filename.c_str(),std::ios::binary|std::ios::ate);
+    char magic[4];
+    uint32_t version;
+    uint64_t nodes,arcs,fileSize,headerSize;
+    CSRGraph loaded;
+
+    if (!in) error("loadBinaryGraph: can't open " + filename);
+    fileSize=(uint64_t) in.tellg();
+    in.seekg(0);
+    in.read(magic,sizeof magic);
+    in.read((char *) &version,sizeof version);
+    in.read((char *) &nodes,sizeof nodes);
+    in.read((char *) &arcs,sizeof arcs);
+    if (!in||!std::equal(magic,magic+4,GRAPH_MAGIC)||version!=GRAPH_VERSION||nodes>=NO_NODE)
+    {
+        error("loadBinaryGraph: " + filename + " is not a graph file");
+    }
+    headerSize=sizeof magic+sizeof version+sizeof nodes+sizeof arcs;
+    if ((fileSize-headerSize)/sizeof(uint64_t)<nodes+1) error("loadBinaryGraph: " + filename + " is truncated");
+    fileSize-=headerSize+(nodes+1)*sizeof(uint64_t);
+    if (fileSize/(sizeof(uint32_t)+sizeof(double))<arcs) error("loadBinaryGraph: " + filename + " is truncated");
+    loaded.nodeCount=nodes;
+    loaded.offsets.resize(nodes+1);
+    for (size_t v=0;v<=nodes;v++)
+    {
+        uint64_t offset;
+
+        in.read((char *) &offset,sizeof offset);
+        if (offset>arcs||(v>0&&offset<loaded.offsets[v-1])||(v==0&&offset!=0))
+        {
+            error("loadBinaryGraph: " + filename + " has invalid offsets");
+        }
+        loaded.offsets[v]=offset;
+    }
+    loaded.targets.resize(arcs);
+    loaded.costs.resize(arcs);
+    in.read((char *) loaded.targets.data(),arcs*sizeof(uint32_t));
+    in.read((char *) loaded.costs.data(),arcs*sizeof(double));
+    if (!in) error("loadBinaryGraph: " + filename + " is truncated");
+    if (loaded.offsets[nodes]!=arcs) error("loadBinaryGraph: " + filename + " has invalid offsets");
+    for (size_t v=0;v<nodes;v++)
+    {
+        for (size_t i=loaded.offsets[v];i<loaded.offsets[v+1];i++)
+        {
+            if (loaded.targets[i]>=nodes)
+            {
+                error("loadBinaryGraph: " + filename + " has an arc to a nonexistent node");
+            }
+            if (i>loaded.offsets[v]&&loaded.targets[i]<loaded.targets[i-1])
+            {
+                error("loadBinaryGraph: " + filename + " has a row that is not sorted");
+            }
+        }
+    }
+    csr=std::move(loaded);
+}
+
+/*
+ * Implementation notes: memoryUsage
+ * ---------------------------------
+ * The SimpleGraph estimate assumes that Set and Map are balanced trees whose nodes carry three
+ * pointers and a color word in addition to the stored value.
+ */
+
+static const size_t TREE_NODE_OVERHEAD=4*sizeof(void *);
+
+size_t memoryUsage(const CSRGraph & csr)
+{
+    size_t bytes=sizeof(CSRGraph);
+
+    bytes+=csr.offsets.capacity()*sizeof(size_t);
+    bytes+=csr.targets.capacity()*sizeof(uint32_t);
+    bytes+=csr.costs.capacity()*sizeof(double);
+    bytes+=csr.nodes.capacity()*sizeof(Node *);
+    bytes+=csr.arcs.capacity()*sizeof(Arc *);
+    bytes+=csr.index.size()*(sizeof(std::pair<Node *,uint32_t>)+2*sizeof(void *));
+    return bytes;
+}
+
+size_t memoryUsage(const SimpleGraph & graph)
+{
+    size_t bytes=sizeof(SimpleGraph);
+    size_t nodes=graph.nodes.size();
+    size_t arcs=graph.arcs.size();
+
+    bytes+=nodes*(sizeof(Node)+sizeof(Node *)+TREE_NODE_OVERHEAD);
+    bytes+=nodes*(sizeof(std::string)+sizeof(Node *)+TREE_NODE_OVERHEAD);
+    bytes+=arcs*(sizeof(Arc)+2*(sizeof(Arc *)+TREE_NODE_OVERHEAD));
+    for (Node * node:graph.nodes)
+    {
+        if (node->name.capacity()>15) bytes+=2*(node->name.capacity()+1);
+    }
+    return bytes;
+}
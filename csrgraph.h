@@ -0,0 +1,163 @@
+/*
+ * File: csrgraph.h
+ * ----------------
+ * This interface exports a compressed sparse row (CSR) representation of a graph together with the
+ * functions that convert between it and the pointer-based SimpleGraph.
+ */
+
+#ifndef _csrgraph_h
+#define _csrgraph_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "graphtypes.h"
+
+/*
+ * Constant: NO_NODE
+ * -----------------
+ * Marks an index that does not refer to any node, for example the parent of an unreached node.
+ */
+
+const uint32_t NO_NODE=UINT32_MAX;
+
+/*
+ * Type: CSRGraph
+ * --------------
+ * This type stores a directed graph in compressed sparse row form. The arcs leaving node v occupy
+ * the positions offsets[v] up to offsets[v+1] of the targets and costs arrays, sorted by target. When
+ * the graph was built from a SimpleGraph, nodes and arcs map every index and arc position back to
+ * the original structures, and index maps nodes to their indices; otherwise these are empty.
+ */
+
+struct CSRGraph
+{
+    size_t nodeCount;                           /* Number of nodes */
+    std::vector<size_t> offsets;                /* Row boundaries, nodeCount+1 entries */
+    std::vector<uint32_t> targets;              /* Finish index of every arc */
+    std::vector<double> costs;                  /* Cost of every arc */
+    std::vector<Node *> nodes;                  /* Node for every index (optional) */
+    std::vector<Arc *> arcs;                    /* Arc for every arc position (optional) */
+    std::unordered_map<Node *,uint32_t> index;  /* Index for every node (optional) */
+
+    CSRGraph() : nodeCount(0) {}
+
+    size_t arcCount() const
+    {
+        return targets.size();
+    }
+
+    size_t degree(uint32_t v) const
+    {
+        return offsets[v+1]-offsets[v];
+    }
+};
+
+/*
+ * Type: EdgeList
+ * --------------
+ * This type holds a graph as three parallel arrays, one entry per arc. It is the intermediate form
+ * produced by graph generators and loaders.
+ */
+
+struct EdgeList
+{
+    size_t nodeCount;
+    std::vector<uint32_t> sources;
+    std::vector<uint32_t> targets;
+    std::vector<double> costs;
+
+    EdgeList() : nodeCount(0) {}
+};
+
+/*
+ * Function: buildCSR
+ * Usage: buildCSR(graph,csr);
+ * ---------------------------
+ * Fills csr with the nodes and arcs of graph, which may be either a SimpleGraph or an EdgeList.
+ * Conversion from a SimpleGraph records the node and arc pointers so that results can be mapped back;
+ * it signals an error if an arc leads to a node that is not in the graph.
+ */
+
+void buildCSR(const SimpleGraph & graph,CSRGraph & csr);
+void buildCSR(const EdgeList & edges,CSRGraph & csr);
+
+/*
+ * Function: sortArcs
+ * Usage: sortArcs(csr,first,last);
+ * --------------------------------
+ * Sorts the arcs in rows first up to (but not including) last by target, breaking ties by cost, so
+ * that builders which scatter arcs in an arbitrary order still produce a canonical graph. Disjoint
+ * row ranges may be sorted concurrently.
+ */
+
+void sortArcs(CSRGraph & csr,size_t first,size_t last);
+
+/*
+ * Function: reverseCSR
+ * Usage: reverseCSR(csr,reverse);
+ * -------------------------------
+ * Fills reverse with the graph that has an arc v->u of the same cost for every arc u->v of csr. Node
+ * and arc pointers are not carried over.
+ */
+
+void reverseCSR(const CSRGraph & csr,CSRGraph & reverse);
+
+/*
+ * Function: symmetrizeCSR
+ * Usage: symmetrizeCSR(csr,undirected);
+ * -------------------------------------
+ * Fills undirected with the simple undirected graph underlying csr: arcs u->v and v->u for every
+ * pair of distinct nodes joined by an arc of csr in either direction. Self-loops are dropped and
+ * parallel arcs merged into one with the smallest cost. Node and arc pointers are not carried over.
+ */
+
+void symmetrizeCSR(const CSRGraph & csr,CSRGraph & undirected);
+
+/*
+ * Function: buildSimpleGraph
+ * Usage: buildSimpleGraph(csr,graph);
+ * -----------------------------------
+ * Creates one heap-allocated Node per index, named by its decimal index, and one Arc per arc position
+ * and adds them to graph. On return the nodes, arcs and index fields of csr refer to the new graph.
+ */
+
+void buildSimpleGraph(CSRGraph & csr,SimpleGraph & graph);
+
+/*
+ * Function: freeGraph
+ * Usage: freeGraph(graph);
+ * ------------------------
+ * Deletes every node and arc owned by graph and leaves it empty.
+ */
+
+void freeGraph(SimpleGraph & graph);
+
+/*
+ * Function: saveBinaryGraph, loadBinaryGraph
+ * Usage: saveBinaryGraph(csr,filename);
+ *        loadBinaryGraph(filename,csr);
+ * ------------------------------------------
+ * Write and read the arrays of a CSRGraph in a compact binary file: the magic string "CSRG", a
+ * format version, the node and arc counts as 64-bit integers, then the offsets, targets and costs
+ * in native byte order. Node and arc pointers are not stored. Both functions signal an error if the
+ * file cannot be accessed or is not a valid graph file; loadBinaryGraph leaves csr unchanged then.
+ */
+
+void saveBinaryGraph(const CSRGraph & csr,const std::string & filename);
+void loadBinaryGraph(const std::string & filename,CSRGraph & csr);
+
+/*
+ * Function: memoryUsage
+ * Usage: size_t bytes=memoryUsage(csr);
+ * -------------------------------------
+ * Returns the number of bytes held by the arrays of csr. The SimpleGraph version is an estimate that
+ * charges every node, arc and set or map entry with its size plus the bookkeeping of a tree node.
+ */
+
+size_t memoryUsage(const CSRGraph & csr);
+size_t memoryUsage(const SimpleGraph & graph);
+
+#endif
@@ -0,0 +1,239 @@
+/*
+ * File: diameter.cpp
+ * ------------------
+ * This file implements the diameter.h interface.
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "components.h"
+#include "diameter.h"
+#include "threadpool.h"
+#include "tracing.h"
+#include "traversal.h"
+
+/*
+ * Type: SweepState
+ * ----------------
+ * The arrays shared by the sequential searches of computeDiameter: the arrays of the latest search,
+ * and for every node the best known lower and upper bounds on its eccentricity.
+ */
+
+struct SweepState
+{
+    const CSRGraph & graph;
+    std::vector<uint32_t> distance;
+    std::vector<uint32_t> order;
+    std::vector<size_t> levels;
+    std::vector<uint32_t> lower;
+    std::vector<uint32_t> upper;
+    DiameterResult & result;
+
+    SweepState(const CSRGraph & graph,DiameterResult & result)
+        : graph(graph),lower(graph.nodeCount,0),upper(graph.nodeCount,UINT32_MAX),result(result) {}
+};
+
+/*
+ * Implementation notes: sweep
+ * ---------------------------
+ * Runs one search from v and returns its eccentricity e. A longer path than any seen so far raises
+ * the lower bound on the diameter. By the triangle inequality every node w at distance d from v has
+ * an eccentricity of at least max(d,e-d) and at most d+e, which tightens the bounds that the radius
+ * phase works with.
+ */
+
+static uint32_t sweep(SweepState & state,uint32_t v)
+{
+    uint32_t e=breadthFirstLevels(state.graph,v,state.distance,state.order,state.levels);
+
+    state.result.searches++;
+    if (e>state.result.diameter||state.result.from==NO_NODE)
+    {
+        state.result.diameter=e;
+        state.result.from=v;
+        state.result.to=state.order.back();
+    }
+    for (uint32_t w:state.order)
+    {
+        uint32_t d=state.distance[w];
+
+        state.lower[w]=std::max(state.lower[w],std::max(d,e-d));
+        state.upper[w]=std::min(state.upper[w],d+e);
+    }
+    return e;
+}
+
+/*
+ * Implementation notes: midpoint
+ * ------------------------------
+ * Returns the node halfway along a shortest path from the source of the latest search to far,
+ * found by walking back from far through nodes one step closer to the source.
+ */
+
+static uint32_t midpoint(const SweepState & state,uint32_t far)
+{
+    const CSRGraph & graph=state.graph;
+    uint32_t v=far;
+    uint32_t half=state.distance[far]/2;
+
+    while (state.distance[v]>half)
+    {
+        for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+
+            if (state.distance[t]+1==state.distance[v])
+            {
+                v=t;
+                break;
+            }
+        }
+    }
+    return v;
+}
+
+/*
+ * Implementation notes: computeDiameter
+ * -------------------------------------
+ * The diameter is found with the iFUB method of Crescenzi et al. A 4-sweep, two double sweeps each
+ * started from the midpoint of the previous longest path, yields a good lower bound and a central
+ * node u. Any two nodes within distance i-1 of u are at most 2(i-1) apart, since a path between
+ * them can pass through u. Once the searches from every node at distance i or more from u have been
+ * run, every longer path has an endpoint among those nodes, so the diameter is either the largest
+ * eccentricity found so far or at most 2(i-1). iFUB therefore works down from the deepest level of
+ * u, searching from all nodes of one level, in parallel, and stops as soon as the lower bound
+ * exceeds 2(i-1).
+ *
+ * The radius is found with the eccentricity bounds of Takes and Kosters, which every sequential
+ * search tightens. The smallest upper bound seen so far is an upper bound on the radius; nodes whose
+ * lower bound reaches it, or whose eccentricity is known, cannot improve it and are dropped. The search then
+ * continues from the candidate with the smallest lower bound, which is the most promising center,
+ * until no candidate is left.
+ */
+
+void computeDiameter(const CSRGraph & graph,DiameterResult & result,bool symmetric)
+{
+    TRACE_SCOPE("computeDiameter");
+    CSRGraph undirected;
+
+    if (!symmetric) symmetrizeCSR(graph,undirected);
+
+    const CSRGraph & g=symmetric ? graph : undirected;
+    size_t n=g.nodeCount;
+    std::vector<uint32_t> component;
+    std::vector<size_t> size(n,0);
+    uint32_t largest=0;
+
+    result=DiameterResult();
+    if (n==0) return;
+    connectedComponents(g,component,true);
+    for (size_t v=0;v<n;v++)
+    {
+        if (++size[component[v]]>size[largest]) largest=component[v];
+    }
+    result.componentSize=size[largest];
+
+    SweepState state(g,result);
+    uint32_t start=largest;
+
+    for (size_t v=0;v<n;v++)
+    {
+        if (component[v]==largest&&g.degree(v)>g.degree(start)) start=(uint32_t) v;
+    }
+    {
+        TRACE_SCOPE("diameter.sweeps");
+        for (int round=0;round<2;round++)
+        {
+            sweep(state,start);
+
+            uint32_t a=state.order.back();
+
+            sweep(state,a);
+            start=midpoint(state,state.order.back());
+        }
+    }
+
+    uint32_t i=sweep(state,start);
+    std::vector<uint32_t> order(state.order);
+    std::vector<size_t> levels(state.levels);
+    std::mutex lock;
+
+    while (i>0&&result.diameter<2*i)
+    {
+        TRACE_SCOPE_VALUE("diameter.fringe",i);
+        size_t first=levels[i];
+        size_t last=levels[i+1];
+
+        parallelFor(first,last,[&](size_t begin,size_t end)
+        {
+            std::vector<uint32_t> distance;
+            std::vector<uint32_t> reached;
+            std::vector<size_t> bounds;
+            uint32_t best=0,from=NO_NODE,to=NO_NODE;
+
+            for (size_t k=begin;k<end;k++)
+            {
+                uint32_t e=breadthFirstLevels(g,order[k],distance,reached,bounds);
+
+                if (e>best||from==NO_NODE)
+                {
+                    best=e;
+                    from=order[k];
+                    to=reached.back();
+                }
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+
+            result.searches+=end-begin;
+            if (best>result.diameter)
+            {
+                result.diameter=best;
+                result.from=from;
+                result.to=to;
+            }
+        },1);
+        if (result.diameter>2*(i-1)) break;
+        i--;
+    }
+
+    std::vector<uint32_t> candidates;
+    uint32_t bound=UINT32_MAX;
+
+    for (size_t v=0;v<n;v++)
+    {
+        if (component[v]==largest) candidates.push_back((uint32_t) v);
+    }
+    {
+        TRACE_SCOPE("diameter.radius");
+        while (true)
+        {
+            uint32_t next=NO_NODE;
+            size_t kept=0;
+
+            for (uint32_t v:candidates)
+            {
+                if (state.upper[v]<bound)
+                {
+                    bound=state.upper[v];
+                    result.center=v;
+                }
+            }
+            for (uint32_t v:candidates)
+            {
+                if (state.lower[v]>=bound||state.lower[v]==state.upper[v]) continue;
+                candidates[kept++]=v;
+                if (next==NO_NODE||state.lower[v]<state.lower[next]
+                    ||(state.lower[v]==state.lower[next]&&g.degree(v)>g.degree(next)))
+                {
+                    next=v;
+                }
+            }
+            if (kept==0) break;
+            candidates.resize(kept);
+            sweep(state,next);
+        }
+    }
+    result.radius=bound;
+}
@@ -0,0 +1,53 @@
+/*
+ * File: diameter.h
+ * ----------------
+ * This interface exports the exact computation of the diameter and radius of a graph in CSR form,
+ * the largest and smallest eccentricity of its nodes, usually with far fewer breadth-first searches
+ * than one from every node. Arcs are treated as undirected edges.
+ */
+
+#ifndef _diameter_h
+#define _diameter_h
+
+#include <cstddef>
+#include <cstdint>
+#include "csrgraph.h"
+
+/*
+ * Type: DiameterResult
+ * --------------------
+ * This type holds the result of computeDiameter, which describes the largest connected component.
+ * from and to are the ends of a shortest path of length diameter, and center is a node whose
+ * eccentricity equals the radius. searches counts the breadth-first searches that were needed.
+ */
+
+struct DiameterResult
+{
+    uint32_t diameter;                          /* Largest eccentricity */
+    uint32_t radius;                            /* Smallest eccentricity */
+    uint32_t from;                              /* One end of a longest shortest path */
+    uint32_t to;                                /* The other end */
+    uint32_t center;                            /* A node of eccentricity radius */
+    size_t componentSize;                       /* Nodes in the largest component */
+    size_t searches;                            /* Breadth-first searches performed */
+
+    DiameterResult() : diameter(0),radius(0),from(NO_NODE),to(NO_NODE),center(NO_NODE),
+                       componentSize(0),searches(0) {}
+};
+
+/*
+ * Function: computeDiameter
+ * Usage: computeDiameter(csr,result);
+ *        computeDiameter(csr,result,true);
+ * ----------------------------------------
+ * Computes the exact diameter and radius of the largest connected component of graph. If symmetric
+ * is true, the caller promises that every arc u->v is matched by an arc v->u, which saves building
+ * the undirected graph. The searches of the exact phase run in parallel on the current thread pool.
+ * The number of searches depends on how many nodes lie on the deepest levels of the central node:
+ * on R-MAT graphs of 2^12 to 2^18 nodes it ranges from 5 to about 200. In the worst case it degrades
+ * to one search per node.
+ */
+
+void computeDiameter(const CSRGraph & graph,DiameterResult & result,bool symmetric=false);
+
+#endif
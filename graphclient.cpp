@@ -0,0 +1,169 @@
+/*
+ * File: graphclient.cpp
+ * ---------------------
+ * This file implements the graphclient.h interface.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "error.h"
+#include "graphclient.h"
+
+GraphClient::GraphClient() : fd(-1),nextId(0)
+{}
+
+GraphClient::GraphClient(const std::string & path) : fd(-1),nextId(0)
+{
+    connect(path);
+}
+
+GraphClient::~GraphClient()
+{
+    close();
+}
+
+void GraphClient::connect(const std::string & path)
+{
+    struct sockaddr_un address;
+
+    close();
+    if (path.size()>=sizeof address.sun_path) error("GraphClient: socket path too long");
+    std::memset(&address,0,sizeof address);
+    address.sun_family=AF_UNIX;
+    std::strcpy(address.sun_path,path.c_str());
+    fd=socket(AF_UNIX,SOCK_STREAM,0);
+    if (fd<0) error("GraphClient: can't create socket");
+    if (::connect(fd,(struct sockaddr *) &address,sizeof address)<0)
+    {
+        close();
+        error("GraphClient: can't connect to " + path);
+    }
+}
+
+void GraphClient::close()
+{
+    if (fd>=0) ::close(fd);
+    fd=-1;
+    early.clear();
+}
+
+uint32_t GraphClient::send(QueryType type,uint32_t source,uint32_t target)
+{
+    QueryRequest request;
+    unsigned char frame[FRAME_SIZE];
+    size_t sent=0;
+
+    if (fd<0) error("GraphClient: not connected");
+    request.id=nextId++;
+    request.type=(uint8_t) type;
+    request.source=source;
+    request.target=target;
+    encodeRequest(request,frame);
+    while (sent<FRAME_SIZE)
+    {
+        ssize_t n=::send(fd,frame+sent,FRAME_SIZE-sent,MSG_NOSIGNAL);
+
+        if (n<0&&errno==EINTR) continue;
+        if (n<=0) error("GraphClient: connection lost");
+        sent+=n;
+    }
+    return request.id;
+}
+
+/*
+ * Implementation notes: receive
+ * -----------------------------
+ * Responses set aside by call are handed out first, so no response is ever lost.
+ */
+
+QueryResponse GraphClient::receive()
+{
+    unsigned char frame[FRAME_SIZE];
+    size_t got=0;
+
+    if (!early.empty())
+    {
+        QueryResponse response=early.begin()->second;
+
+        early.erase(early.begin());
+        return response;
+    }
+    if (fd<0) error("GraphClient: not connected");
+    while (got<FRAME_SIZE)
+    {
+        ssize_t n=::recv(fd,frame+got,FRAME_SIZE-got,0);
+
+        if (n<0&&errno==EINTR) continue;
+        if (n<=0) error("GraphClient: connection lost");
+        got+=n;
+    }
+    return decodeResponse(frame);
+}
+
+/*
+ * Implementation notes: call
+ * --------------------------
+ * Because the server may answer out of order when the client also has pipelined queries in flight,
+ * call sets aside every response that belongs to another query until its own arrives.
+ */
+
+QueryResponse GraphClient::call(QueryType type,uint32_t source,uint32_t target)
+{
+    uint32_t id=send(type,source,target);
+    std::map<uint32_t,QueryResponse>::iterator it=early.find(id);
+
+    if (it!=early.end())
+    {
+        QueryResponse response=it->second;
+
+        early.erase(it);
+        return response;
+    }
+    while (true)
+    {
+        unsigned char frame[FRAME_SIZE];
+        size_t got=0;
+
+        while (got<FRAME_SIZE)
+        {
+            ssize_t n=::recv(fd,frame+got,FRAME_SIZE-got,0);
+
+            if (n<0&&errno==EINTR) continue;
+            if (n<=0) error("GraphClient: connection lost");
+            got+=n;
+        }
+
+        QueryResponse response=decodeResponse(frame);
+
+        if (response.id==id)
+        {
+            if (response.status==STATUS_ABORTED) error("GraphClient: query aborted by server");
+            if (response.status!=STATUS_OK) error("GraphClient: query rejected by server");
+            return response;
+        }
+        early[response.id]=response;
+    }
+}
+
+size_t GraphClient::nodeCount()
+{
+    return (size_t) call(QUERY_INFO,0,0).value;
+}
+
+int GraphClient::hops(uint32_t source,uint32_t target)
+{
+    return (int) call(QUERY_HOPS,source,target).value;
+}
+
+bool GraphClient::isReachable(uint32_t source,uint32_t target)
+{
+    return call(QUERY_REACHABLE,source,target).value!=0;
+}
+
+double GraphClient::shortestPath(uint32_t source,uint32_t target)
+{
+    return call(QUERY_SHORTEST_PATH,source,target).value;
+}
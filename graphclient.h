@@ -0,0 +1,106 @@
+/*
+ * File: graphclient.h
+ * -------------------
+ * This interface exports the GraphClient class, which sends queries to a running GraphServer.
+ */
+
+#ifndef _graphclient_h
+#define _graphclient_h
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "graphprotocol.h"
+
+/*
+ * Class: GraphClient
+ * ------------------
+ * This class represents a connection to a GraphServer. The convenience methods send one query and
+ * wait for its answer; send and receive allow many queries to be in flight at once. A client must
+ * not be shared between threads without external locking.
+ */
+
+class GraphClient
+{
+public:
+
+/*
+ * Constructor: GraphClient
+ * Usage: GraphClient client;
+ *        GraphClient client(path);
+ * --------------------------------
+ * Creates a client, optionally connecting it to the server listening on path.
+ */
+
+    GraphClient();
+    explicit GraphClient(const std::string & path);
+
+/*
+ * Destructor: ~GraphClient
+ * Usage: (usually implicit)
+ * -------------------------
+ * Closes the connection.
+ */
+
+    ~GraphClient();
+
+/*
+ * Method: connect
+ * Usage: client.connect(path);
+ * ----------------------------
+ * Connects to the server listening on the Unix-domain socket path, closing any previous connection.
+ * This method signals an error if the connection fails.
+ */
+
+    void connect(const std::string & path);
+
+/*
+ * Method: close
+ * Usage: client.close();
+ * ----------------------
+ * Closes the connection, if any.
+ */
+
+    void close();
+
+/*
+ * Methods: nodeCount, hops, isReachable, shortestPath
+ * Usage: size_t n=client.nodeCount();
+ *        int h=client.hops(source,target);
+ *        if (client.isReachable(source,target)) . . .
+ *        double cost=client.shortestPath(source,target);
+ * -------------------------------------------------------
+ * Send one query and return its answer. hops and shortestPath return -1 if target cannot be reached.
+ * These methods signal an error if the server rejects or aborts the query or the connection fails.
+ */
+
+    size_t nodeCount();
+    int hops(uint32_t source,uint32_t target);
+    bool isReachable(uint32_t source,uint32_t target);
+    double shortestPath(uint32_t source,uint32_t target);
+
+/*
+ * Methods: send, receive
+ * Usage: uint32_t id=client.send(type,source,target);
+ *        QueryResponse response=client.receive();
+ * ---------------------------------------------------
+ * send transmits a query without waiting and returns its id. receive waits for the next response,
+ * which may belong to any outstanding query; match it by id.
+ */
+
+    uint32_t send(QueryType type,uint32_t source,uint32_t target);
+    QueryResponse receive();
+
+private:
+    int fd;                                     /* Socket descriptor, -1 if not connected */
+    uint32_t nextId;                            /* Id of the next query */
+    std::map<uint32_t,QueryResponse> early;     /* Responses received while awaiting another */
+
+    QueryResponse call(QueryType type,uint32_t source,uint32_t target);
+
+    GraphClient(const GraphClient &);
+    GraphClient & operator=(const GraphClient &);
+};
+
+#endif
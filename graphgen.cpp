@@ -0,0 +1,338 @@
+/*
+ * File: graphgen.cpp
+ * ------------------
+ * This file implements the graphgen.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "error.h"
+#include "graphgen.h"
+#include "splitmix.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: counter-based random numbers
+ * --------------------------------------------------
+ * Instead of one sequential generator, every edge derives its own short random stream from the seed,
+ * a stream tag and the edge number using the SplitMix64 finalizer. Any thread can therefore produce
+ * any edge, and each edge can be regenerated on demand, which is what allows the generators to run
+ * their two passes without storing an edge list.
+ */
+
+enum RandomStream { RMAT_STREAM=1, PAIR_STREAM, ATTACH_STREAM, COST_STREAM };
+
+class EdgeRandom
+{
+public:
+    EdgeRandom(uint64_t seed,uint64_t stream,uint64_t index)
+    {
+        state=mix64(seed+mix64(stream*0x9E3779B97F4A7C15ULL+mix64(index)));
+    }
+
+    uint64_t next()
+    {
+        state+=0x9E3779B97F4A7C15ULL;
+        return mix64(state);
+    }
+
+    double uniform()
+    {
+        return (next()>>11)*(1.0/9007199254740992.0);
+    }
+
+    uint64_t below(uint64_t n)
+    {
+        return next()%n;
+    }
+
+private:
+    uint64_t state;
+};
+
+/*
+ * Function: scramble
+ * Usage: uint32_t label=scramble(v,bits,seed);
+ * --------------------------------------------
+ * Returns the image of v under a seeded bijection of the integers below 2^bits, built from
+ * multiplications by odd constants and xor-shifts, each of which is invertible modulo 2^bits.
+ */
+
+static inline uint32_t scramble(uint64_t v,int bits,uint64_t seed)
+{
+    uint64_t mask=(bits>=64) ? ~0ULL : (1ULL<<bits)-1;
+    uint64_t k1=mix64(seed)|1;
+    uint64_t k2=mix64(seed+1)|1;
+    int shift=bits/2+1;
+
+    v=(v*k1+mix64(seed+2))&mask;
+    v^=v>>shift;
+    v=(v*k2)&mask;
+    v^=v>>shift;
+    return (uint32_t) v;
+}
+
+static double costAt(uint64_t edge,const GeneratorOptions & options)
+{
+    if (options.costDistribution==CONSTANT_COST) return options.costMin;
+
+    EdgeRandom rnd(options.seed,COST_STREAM,edge);
+    double u=rnd.uniform();
+
+    switch (options.costDistribution)
+    {
+    case UNIFORM_COST:
+        return options.costMin+(options.costMax-options.costMin)*u;
+    case INTEGER_COST:
+        return std::floor(options.costMin+(std::floor(options.costMax)-options.costMin+1)*u);
+    case EXPONENTIAL_COST:
+        return options.costMin-std::log1p(-u)*options.costMax;
+    default:
+        return options.costMin;
+    }
+}
+
+/*
+ * Constant: GENERATOR_GRAIN
+ * -------------------------
+ * The smallest number of edges or nodes handed to one task; generating an edge takes only a few
+ * nanoseconds, so smaller pieces would cost more to schedule than to run.
+ */
+
+const size_t GENERATOR_GRAIN=4096;
+
+/*
+ * Implementation notes: emitGraph
+ * -------------------------------
+ * All generators share this two-pass builder. edgeAt(e,u,v) computes the endpoints of edge e. The
+ * first pass counts the out-degree of every node with atomic increments, a prefix sum turns the
+ * counts into row offsets, and the second pass regenerates every edge and claims a slot in its row
+ * with an atomic cursor. Because threads claim slots in an arbitrary order, the rows are sorted at
+ * the end, which makes the output canonical. The only allocations are the CSR arrays themselves and
+ * one cursor per node. The passes run on the current thread pool unless options.threads asks for a
+ * different number of threads, in which case a private pool of that size is used.
+ */
+
+template <typename edgefunction>
+static void emitGraph(size_t nodeCount,size_t edgeCount,edgefunction edgeAt,
+                      const GeneratorOptions & options,CSRGraph & csr)
+{
+    if (nodeCount>NO_NODE) error("graphgen: too many nodes for 32-bit indices");
+
+    TRACE_SCOPE_VALUE("graphgen",edgeCount);
+    std::unique_ptr<std::atomic<size_t>[]> cursor(new std::atomic<size_t>[nodeCount+1]);
+    size_t arcsPerEdge=options.undirected ? 2 : 1;
+    std::unique_ptr<ThreadPool> privatePool;
+    ThreadPool * pool=&ThreadPool::current();
+
+    if (options.threads>0&&options.threads!=pool->size())
+    {
+        privatePool.reset(new ThreadPool(options.threads));
+        pool=privatePool.get();
+    }
+
+    pool->parallelFor(0,nodeCount+1,[&](size_t begin,size_t end)
+    {
+        for (size_t v=begin;v<end;v++) cursor[v].store(0,std::memory_order_relaxed);
+    },GENERATOR_GRAIN);
+    pool->parallelFor(0,edgeCount,[&](size_t begin,size_t end)
+    {
+        TRACE_SCOPE("graphgen.count");
+
+        for (size_t e=begin;e<end;e++)
+        {
+            uint32_t u,v;
+
+            edgeAt(e,u,v);
+            cursor[u].fetch_add(1,std::memory_order_relaxed);
+            if (options.undirected) cursor[v].fetch_add(1,std::memory_order_relaxed);
+        }
+    },GENERATOR_GRAIN);
+    csr=CSRGraph();
+    csr.nodeCount=nodeCount;
+    csr.offsets.resize(nodeCount+1);
+    csr.offsets[0]=0;
+    for (size_t v=0;v<nodeCount;v++)
+    {
+        csr.offsets[v+1]=csr.offsets[v]+cursor[v].load(std::memory_order_relaxed);
+        cursor[v].store(csr.offsets[v],std::memory_order_relaxed);
+    }
+    csr.targets.resize(edgeCount*arcsPerEdge);
+    csr.costs.resize(edgeCount*arcsPerEdge);
+    pool->parallelFor(0,edgeCount,[&](size_t begin,size_t end)
+    {
+        TRACE_SCOPE("graphgen.scatter");
+
+        for (size_t e=begin;e<end;e++)
+        {
+            uint32_t u,v;
+            double cost=costAt(e,options);
+            size_t pos;
+
+            edgeAt(e,u,v);
+            pos=cursor[u].fetch_add(1,std::memory_order_relaxed);
+            csr.targets[pos]=v;
+            csr.costs[pos]=cost;
+            if (options.undirected)
+            {
+                pos=cursor[v].fetch_add(1,std::memory_order_relaxed);
+                csr.targets[pos]=u;
+                csr.costs[pos]=cost;
+            }
+        }
+    },GENERATOR_GRAIN);
+    pool->parallelFor(0,nodeCount,[&](size_t begin,size_t end)
+    {
+        TRACE_SCOPE("graphgen.sort");
+        sortArcs(csr,begin,end);
+    },GENERATOR_GRAIN);
+}
+
+/*
+ * Implementation notes: generateRMAT
+ * ----------------------------------
+ * Each edge descends scale levels of the adjacency matrix, choosing one quadrant per level.
+ */
+
+void generateRMAT(int scale,size_t edgeFactor,const GeneratorOptions & options,CSRGraph & csr)
+{
+    if (scale<1||scale>31) error("generateRMAT: scale must be between 1 and 31");
+
+    double ab=options.rmatA+options.rmatB;
+    double abc=ab+options.rmatC;
+    uint64_t labelSeed=mix64(options.seed^RMAT_STREAM);
+
+    emitGraph((size_t) 1<<scale,edgeFactor<<scale,[&](size_t e,uint32_t & u,uint32_t & v)
+    {
+        EdgeRandom rnd(options.seed,RMAT_STREAM,e);
+        uint64_t row=0,col=0;
+
+        for (int bit=scale-1;bit>=0;bit--)
+        {
+            double r=rnd.uniform();
+
+            if (r<options.rmatA) continue;
+            if (r<ab) col|=1ULL<<bit;
+            else if (r<abc) row|=1ULL<<bit;
+            else
+            {
+                row|=1ULL<<bit;
+                col|=1ULL<<bit;
+            }
+        }
+        u=scramble(row,scale,labelSeed);
+        v=scramble(col,scale,labelSeed);
+    },options,csr);
+}
+
+void generateErdosRenyi(size_t nodeCount,size_t edgeCount,const GeneratorOptions & options,
+                        CSRGraph & csr)
+{
+    if (nodeCount<2) error("generateErdosRenyi: at least two nodes are required");
+    emitGraph(nodeCount,edgeCount,[&](size_t e,uint32_t & u,uint32_t & v)
+    {
+        EdgeRandom rnd(options.seed,PAIR_STREAM,e);
+
+        u=(uint32_t) rnd.below(nodeCount);
+        v=(uint32_t) rnd.below(nodeCount-1);
+        if (v>=u) v++;
+    },options,csr);
+}
+
+/*
+ * Implementation notes: generateBarabasiAlbert
+ * --------------------------------------------
+ * This generator uses the copy formulation of Sanders and Schulz. Edge k starts at node k/m and its
+ * endpoints occupy positions 2k and 2k+1 of a virtual endpoint list, so choosing a uniformly random
+ * earlier position selects a node with probability proportional to its degree. An even position
+ * names a source directly; an odd position is the target of an earlier edge, whose own choice is
+ * regenerated in the same way. The chain is short on average and needs no shared state.
+ */
+
+void generateBarabasiAlbert(size_t nodeCount,size_t edgesPerNode,const GeneratorOptions & options,
+                            CSRGraph & csr)
+{
+    if (edgesPerNode==0) error("generateBarabasiAlbert: edgesPerNode must be positive");
+    emitGraph(nodeCount,nodeCount*edgesPerNode,[&](size_t e,uint32_t & u,uint32_t & v)
+    {
+        uint64_t position=2*(uint64_t) e+1;
+
+        while (true)
+        {
+            EdgeRandom rnd(options.seed,ATTACH_STREAM,position);
+            uint64_t r=rnd.below(position);
+
+            if (r%2==0)
+            {
+                v=(uint32_t) (r/2/edgesPerNode);
+                break;
+            }
+            position=r;
+        }
+        u=(uint32_t) (e/edgesPerNode);
+    },options,csr);
+}
+
+void generateGrid(size_t rows,size_t cols,const GeneratorOptions & options,CSRGraph & csr)
+{
+    if (rows==0||cols==0) error("generateGrid: empty grid");
+
+    size_t horizontal=rows*(cols-1);
+
+    emitGraph(rows*cols,horizontal+(rows-1)*cols,[&](size_t e,uint32_t & u,uint32_t & v)
+    {
+        if (e<horizontal)
+        {
+            u=(uint32_t) (e/(cols-1)*cols+e%(cols-1));
+            v=u+1;
+        } else
+        {
+            u=(uint32_t) (e-horizontal);
+            v=(uint32_t) (u+cols);
+        }
+    },options,csr);
+}
+
+/*
+ * Implementation notes: generateRandomRegular
+ * -------------------------------------------
+ * Round r joins every node v to p_r(v), where p_r is a seeded pseudo-random permutation, so each
+ * round contributes one outgoing and one incoming arc per node. The permutation is a cycle-walking
+ * restriction of scramble to the node range, which keeps it a bijection for any node count.
+ */
+
+void generateRandomRegular(size_t nodeCount,size_t degree,const GeneratorOptions & options,
+                           CSRGraph & csr)
+{
+    int bits=1;
+    size_t rounds=degree/2;
+
+    if (degree==0||degree%2!=0) error("generateRandomRegular: degree must be even and positive");
+    while (((size_t) 1<<bits)<nodeCount) bits++;
+    emitGraph(nodeCount,nodeCount*rounds,[&](size_t e,uint32_t & u,uint32_t & v)
+    {
+        uint64_t seed=mix64(options.seed+PAIR_STREAM+e/nodeCount);
+        uint64_t x=e%nodeCount;
+
+        u=(uint32_t) x;
+        do
+        {
+            x=scramble(x,bits,seed);
+        } while (x>=nodeCount);
+        v=(uint32_t) x;
+    },options,csr);
+}
+
+void generatePath(size_t nodeCount,const GeneratorOptions & options,CSRGraph & csr)
+{
+    if (nodeCount==0) error("generatePath: empty path");
+    emitGraph(nodeCount,nodeCount-1,[&](size_t e,uint32_t & u,uint32_t & v)
+    {
+        u=(uint32_t) e;
+        v=(uint32_t) (e+1);
+    },options,csr);
+}
@@ -0,0 +1,111 @@
+/*
+ * File: graphgen.h
+ * ----------------
+ * This interface exports functions that synthesize large graphs directly in CSR form. Every
+ * generator is deterministic for a given seed: the result does not depend on the number of threads
+ * used to produce it.
+ */
+
+#ifndef _graphgen_h
+#define _graphgen_h
+
+#include <cstddef>
+#include "csrgraph.h"
+
+/*
+ * Type: CostDistribution
+ * ----------------------
+ * Selects how the cost of each generated arc is drawn. CONSTANT_COST uses costMin for every arc,
+ * UNIFORM_COST draws from [costMin,costMax), INTEGER_COST draws a whole number from
+ * [costMin,costMax] and EXPONENTIAL_COST adds an exponential variate with mean costMax to costMin.
+ */
+
+enum CostDistribution { CONSTANT_COST, UNIFORM_COST, INTEGER_COST, EXPONENTIAL_COST };
+
+/*
+ * Type: GeneratorOptions
+ * ----------------------
+ * This type collects the settings shared by all generators. If undirected is true, every generated
+ * edge becomes a pair of opposite arcs with the same cost. A thread count of 0 runs on the current
+ * thread pool (see threadpool.h).
+ */
+
+struct GeneratorOptions
+{
+    unsigned long long seed;                    /* Seed from which every random choice is derived */
+    int threads;                                /* Threads to use, 0 for the current pool */
+    bool undirected;                            /* Emit both arc directions for every edge */
+    CostDistribution costDistribution;
+    double costMin;
+    double costMax;
+    double rmatA;                               /* R-MAT quadrant probabilities; D is the rest */
+    double rmatB;
+    double rmatC;
+
+    GeneratorOptions() : seed(1),threads(0),undirected(true),costDistribution(UNIFORM_COST),
+        costMin(0.0),costMax(1.0),rmatA(0.57),rmatB(0.19),rmatC(0.19) {}
+};
+
+/*
+ * Function: generateRMAT
+ * Usage: generateRMAT(scale,edgeFactor,options,csr);
+ * --------------------------------------------------
+ * Generates an R-MAT (recursive Kronecker) graph with 2^scale nodes and edgeFactor*2^scale edges.
+ * Node labels are scrambled by a seeded bijection, so high-degree nodes are spread over the index
+ * range as in the Graph500 generator.
+ */
+
+void generateRMAT(int scale,size_t edgeFactor,const GeneratorOptions & options,CSRGraph & csr);
+
+/*
+ * Function: generateErdosRenyi
+ * Usage: generateErdosRenyi(nodeCount,edgeCount,options,csr);
+ * -----------------------------------------------------------
+ * Generates a G(n,m) random graph whose edges join uniformly chosen pairs of distinct nodes.
+ */
+
+void generateErdosRenyi(size_t nodeCount,size_t edgeCount,const GeneratorOptions & options,
+                        CSRGraph & csr);
+
+/*
+ * Function: generateBarabasiAlbert
+ * Usage: generateBarabasiAlbert(nodeCount,edgesPerNode,options,csr);
+ * ------------------------------------------------------------------
+ * Generates a preferential-attachment graph in which every node adds edgesPerNode edges to earlier
+ * nodes chosen with probability proportional to their degree.
+ */
+
+void generateBarabasiAlbert(size_t nodeCount,size_t edgesPerNode,const GeneratorOptions & options,
+                            CSRGraph & csr);
+
+/*
+ * Function: generateGrid
+ * Usage: generateGrid(rows,cols,options,csr);
+ * -------------------------------------------
+ * Generates a rows by cols grid in which node r*cols+c is joined to its right and lower neighbors.
+ */
+
+void generateGrid(size_t rows,size_t cols,const GeneratorOptions & options,CSRGraph & csr);
+
+/*
+ * Function: generateRandomRegular
+ * Usage: generateRandomRegular(nodeCount,degree,options,csr);
+ * -----------------------------------------------------------
+ * Generates a graph in which every node has exactly degree incident edges, formed as the union of
+ * degree/2 random permutations. Loops and parallel edges may occur. Signals an error if degree is
+ * zero or odd.
+ */
+
+void generateRandomRegular(size_t nodeCount,size_t degree,const GeneratorOptions & options,
+                           CSRGraph & csr);
+
+/*
+ * Function: generatePath
+ * Usage: generatePath(nodeCount,options,csr);
+ * -------------------------------------------
+ * Generates a simple path through the nodes in index order.
+ */
+
+void generatePath(size_t nodeCount,const GeneratorOptions & options,CSRGraph & csr);
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * File: graphprotocol.h
+ * ---------------------
+ * This interface defines the binary protocol spoken between GraphServer and GraphClient over a
+ * Unix-domain stream socket. Every request and every response is a fixed-size frame of 16 bytes with
+ * all integers in little-endian order, so frames need no length prefix and a client may pipeline as
+ * many requests as it likes. Responses carry the id of their request and may arrive out of order.
+ *
+ *   request:   u32 id | u8 type | u8 0 | u8 0 | u8 0 | u32 source | u32 target
+ *   response:  u32 id | u8 status | u8 0 | u8 0 | u8 0 | f64 value
+ */
+
+#ifndef _graphprotocol_h
+#define _graphprotocol_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+const size_t FRAME_SIZE=16;
+
+/*
+ * Type: QueryType
+ * ---------------
+ * The kinds of request. QUERY_INFO returns the number of nodes of the served graph; QUERY_HOPS the
+ * number of arcs on the shortest path from source to target; QUERY_REACHABLE 1 or 0; and
+ * QUERY_SHORTEST_PATH the cost of the cheapest path. Unreachable targets give the value -1.
+ */
+
+enum QueryType { QUERY_INFO=0, QUERY_HOPS=1, QUERY_REACHABLE=2, QUERY_SHORTEST_PATH=3 };
+
+/*
+ * Type: QueryStatus
+ * -----------------
+ * The outcome of a request. STATUS_BAD_REQUEST reports an unknown type or an out-of-range node, and
+ * STATUS_ABORTED a query the server gave up on because it exceeded the server's per-query budget.
+ */
+
+enum QueryStatus { STATUS_OK=0, STATUS_BAD_REQUEST=1, STATUS_ABORTED=2 };
+
+struct QueryRequest
+{
+    uint32_t id;
+    uint8_t type;
+    uint32_t source;
+    uint32_t target;
+};
+
+struct QueryResponse
+{
+    uint32_t id;
+    uint8_t status;
+    double value;
+};
+
+/*
+ * Functions: encodeRequest, decodeRequest, encodeResponse, decodeResponse
+ * -----------------------------------------------------------------------
+ * Convert between the structures above and their FRAME_SIZE-byte wire form.
+ */
+
+inline void putWord(unsigned char * bytes,uint32_t word)
+{
+    for (int i=0;i<4;i++) bytes[i]=(unsigned char) (word>>(8*i));
+}
+
+inline uint32_t getWord(const unsigned char * bytes)
+{
+    uint32_t word=0;
+
+    for (int i=0;i<4;i++) word|=(uint32_t) bytes[i]<<(8*i);
+    return word;
+}
+
+inline void encodeRequest(const QueryRequest & request,unsigned char * frame)
+{
+    std::memset(frame,0,FRAME_SIZE);
+    putWord(frame,request.id);
+    frame[4]=request.type;
+    putWord(frame+8,request.source);
+    putWord(frame+12,request.target);
+}
+
+inline QueryRequest decodeRequest(const unsigned char * frame)
+{
+    QueryRequest request;
+
+    request.id=getWord(frame);
+    request.type=frame[4];
+    request.source=getWord(frame+8);
+    request.target=getWord(frame+12);
+    return request;
+}
+
+inline void encodeResponse(const QueryResponse & response,unsigned char * frame)
+{
+    uint64_t bits;
+
+    std::memset(frame,0,FRAME_SIZE);
+    std::memcpy(&bits,&response.value,sizeof bits);
+    putWord(frame,response.id);
+    frame[4]=response.status;
+    putWord(frame+8,(uint32_t) bits);
+    putWord(frame+12,(uint32_t) (bits>>32));
+}
+
+inline QueryResponse decodeResponse(const unsigned char * frame)
+{
+    QueryResponse response;
+    uint64_t bits=getWord(frame+8)|(uint64_t) getWord(frame+12)<<32;
+
+    response.id=getWord(frame);
+    response.status=frame[4];
+    std::memcpy(&response.value,&bits,sizeof bits);
+    return response;
+}
+
+#endif
@@ -0,0 +1,383 @@
+/*
+ * File: hoplabels.cpp
+ * -------------------
+ * This file implements the hoplabels.h interface.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <utility>
+#include "blockmatch.h"
+#include "error.h"
+#include "hoplabels.h"
+#include "tracing.h"
+
+/*
+ * Type: LabelEntry
+ * ----------------
+ * One entry of a label while the index is being built.
+ */
+
+struct LabelEntry
+{
+    uint32_t hub;
+    uint16_t distance;
+};
+
+typedef std::vector<std::vector<LabelEntry> > LabelLists;
+
+const uint32_t MAX_LABEL_DISTANCE=65534;
+
+HopLabelIndex::HopLabelIndex() : n(0),symmetric(true)
+{}
+
+HopLabelIndex::HopLabelIndex(const CSRGraph & graph,bool symmetric)
+{
+    build(graph,symmetric);
+}
+
+/*
+ * Implementation notes: prunedSearch
+ * ----------------------------------
+ * This is one pruned breadth-first search of the labeling algorithm of Akiba, Iwata and Yoshida.
+ * The search from the hub of the given rank stops at every node v whose distance the labels built
+ * so far already answer, since then some earlier hub covers every shortest path through v. The
+ * labels of the root are spread out in rootDistance first, so that the query for v costs one pass
+ * over the labels of v.
+ */
+
+static void prunedSearch(const CSRGraph & graph,uint32_t root,uint32_t rank,
+                         const std::vector<LabelEntry> & rootLabels,LabelLists & labels,
+                         std::vector<uint32_t> & rootDistance,std::vector<uint32_t> & distance,
+                         std::vector<uint32_t> & queue)
+{
+    for (const LabelEntry & e:rootLabels) rootDistance[e.hub]=e.distance;
+    queue.clear();
+    queue.push_back(root);
+    distance[root]=0;
+    for (size_t head=0;head<queue.size();head++)
+    {
+        uint32_t v=queue[head];
+        uint32_t d=distance[v];
+        bool covered=false;
+
+        for (const LabelEntry & e:labels[v])
+        {
+            if (rootDistance[e.hub]!=NO_NODE&&rootDistance[e.hub]+e.distance<=d)
+            {
+                covered=true;
+                break;
+            }
+        }
+        if (covered) continue;
+        if (d>MAX_LABEL_DISTANCE) error("HopLabelIndex: path too long for the index");
+        labels[v].push_back({rank,(uint16_t) d});
+        for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+        {
+            uint32_t w=graph.targets[i];
+
+            if (distance[w]==NO_NODE)
+            {
+                distance[w]=d+1;
+                queue.push_back(w);
+            }
+        }
+    }
+    for (uint32_t v:queue) distance[v]=NO_NODE;
+    for (const LabelEntry & e:rootLabels) rootDistance[e.hub]=NO_NODE;
+}
+
+static void flatten(const LabelLists & lists,std::vector<size_t> & offsets,
+                    std::vector<uint32_t> & hubs,std::vector<uint16_t> & distances)
+{
+    offsets.assign(lists.size()+1,0);
+    for (size_t v=0;v<lists.size();v++)
+    {
+        offsets[v+1]=offsets[v]+(lists[v].size()+4)/4*4;
+    }
+    hubs.assign(offsets.back(),NO_NODE);
+    distances.assign(offsets.back(),0);
+    for (size_t v=0;v<lists.size();v++)
+    {
+        for (size_t i=0;i<lists[v].size();i++)
+        {
+            hubs[offsets[v]+i]=lists[v][i].hub;
+            distances[offsets[v]+i]=lists[v][i].distance;
+        }
+    }
+}
+
+/*
+ * Implementation notes: build
+ * ---------------------------
+ * Hubs are processed in decreasing order of degree, because high-degree nodes lie on many shortest
+ * paths and prune the later searches most. A directed index runs two searches per hub, one along
+ * the arcs and one against them on the reverse graph.
+ */
+
+void HopLabelIndex::build(const CSRGraph & graph,bool symmetric)
+{
+    TRACE_SCOPE("HopLabelIndex::build");
+    CSRGraph reverse;
+    std::vector<uint32_t> order(graph.nodeCount);
+    std::vector<size_t> degree(graph.nodeCount);
+    LabelLists to(graph.nodeCount);
+    LabelLists from(symmetric ? 0 : graph.nodeCount);
+    std::vector<uint32_t> rootDistance(graph.nodeCount,NO_NODE);
+    std::vector<uint32_t> distance(graph.nodeCount,NO_NODE);
+    std::vector<uint32_t> queue;
+
+    if (graph.nodeCount>=NO_NODE) error("HopLabelIndex: graph too large");
+    n=graph.nodeCount;
+    this->symmetric=symmetric;
+    if (!symmetric) reverseCSR(graph,reverse);
+    for (uint32_t v=0;v<n;v++)
+    {
+        degree[v]=graph.degree(v)+(symmetric ? 0 : reverse.degree(v));
+    }
+    std::iota(order.begin(),order.end(),0);
+    std::stable_sort(order.begin(),order.end(),[&](uint32_t a,uint32_t b)
+    {
+        return degree[a]>degree[b];
+    });
+    for (uint32_t rank=0;rank<n;rank++)
+    {
+        uint32_t hub=order[rank];
+
+        if (symmetric)
+        {
+            prunedSearch(graph,hub,rank,to[hub],to,rootDistance,distance,queue);
+        } else
+        {
+            prunedSearch(graph,hub,rank,to[hub],from,rootDistance,distance,queue);
+            prunedSearch(reverse,hub,rank,from[hub],to,rootDistance,distance,queue);
+        }
+    }
+    flatten(to,toHub.offsets,toHub.hubs,toHub.distances);
+    if (symmetric) fromHub=labelset();
+    else flatten(from,fromHub.offsets,fromHub.hubs,fromHub.distances);
+}
+
+/*
+ * Implementation notes: merge
+ * ---------------------------
+ * The SSE2 version compares a block of four hubs from each list with matchBlocks, so one test
+ * covers all sixteen pairs. Only blocks with a common hub are examined one entry at a time. The
+ * block with the smaller last hub is then replaced, or both if their last hubs are equal, until
+ * both lists have reached their padding. Other processors use the ordinary merge.
+ */
+
+int HopLabelIndex::merge(const labelset & a,uint32_t u,const labelset & b,uint32_t v)
+{
+    const uint32_t * x=&a.hubs[a.offsets[u]];
+    const uint32_t * y=&b.hubs[b.offsets[v]];
+    const uint16_t * dx=&a.distances[a.offsets[u]];
+    const uint16_t * dy=&b.distances[b.offsets[v]];
+    uint32_t best=NO_NODE;
+
+#ifdef __SSE2__
+    while (true)
+    {
+        if (matchBlocks(x,y)!=0)
+        {
+            for (int i=0;i<4;i++)
+            {
+                for (int j=0;j<4;j++)
+                {
+                    if (x[i]==y[j]&&x[i]!=NO_NODE) best=std::min(best,(uint32_t) dx[i]+dy[j]);
+                }
+            }
+        }
+        if (x[3]==NO_NODE&&y[3]==NO_NODE) break;
+
+        uint32_t lastX=x[3];
+        uint32_t lastY=y[3];
+
+        if (lastX<=lastY)
+        {
+            x+=4;
+            dx+=4;
+        }
+        if (lastY<=lastX)
+        {
+            y+=4;
+            dy+=4;
+        }
+    }
+#else
+    while (*x!=NO_NODE&&*y!=NO_NODE)
+    {
+        if (*x==*y)
+        {
+            best=std::min(best,(uint32_t) *dx+*dy);
+            x++,dx++;
+            y++,dy++;
+        } else if (*x<*y)
+        {
+            x++,dx++;
+        } else
+        {
+            y++,dy++;
+        }
+    }
+#endif
+    return (best==NO_NODE) ? -1 : (int) best;
+}
+
+int HopLabelIndex::hops(uint32_t from,uint32_t to) const
+{
+    if (from>=n||to>=n) error("HopLabelIndex: node out of range");
+    if (from==to) return 0;
+    return merge(toHub,from,symmetric ? toHub : fromHub,to);
+}
+
+size_t HopLabelIndex::nodeCount() const
+{
+    return n;
+}
+
+size_t HopLabelIndex::labelCount() const
+{
+    size_t count=0;
+
+    for (uint32_t hub:toHub.hubs) count+=(hub!=NO_NODE);
+    for (uint32_t hub:fromHub.hubs) count+=(hub!=NO_NODE);
+    return count;
+}
+
+bool HopLabelIndex::isSymmetric() const
+{
+    return symmetric;
+}
+
+/*
+ * Implementation notes: save, load
+ * --------------------------------
+ * The format follows saveBinaryGraph: offsets are written as 64-bit values one at a time and the
+ * other arrays in bulk. The padding is stored with the lists, so a loaded index is ready for queries
+ * without further work. Because merge finds the end of a list only from its padding, the loader
+ * checks every list before using it: the offsets must be nondecreasing multiples of four, the hubs
+ * of each list must be increasing ranks below the node count, and the list must end in NO_NODE.
+ * The arrays are read into temporaries, so a failed load leaves the index as it was.
+ */
+
+static const char LABEL_MAGIC[4]={'H','O','P','L'};
+static const uint32_t LABEL_VERSION=1;
+
+static void writeLabels(std::ofstream & out,const std::vector<size_t> & offsets,
+                        const std::vector<uint32_t> & hubs,const std::vector<uint16_t> & distances)
+{
+    uint64_t entries=hubs.size();
+
+    out.write((const char *) &entries,sizeof entries);
+    for (size_t offset:offsets)
+    {
+        uint64_t value=offset;
+
+        out.write((const char *) &value,sizeof value);
+    }
+    out.write((const char *) hubs.data(),entries*sizeof(uint32_t));
+    out.write((const char *) distances.data(),entries*sizeof(uint16_t));
+}
+
+static void readLabels(std::ifstream & in,size_t n,uint64_t fileSize,std::vector<size_t> & offsets,
+                       std::vector<uint32_t> & hubs,std::vector<uint16_t> & distances)
+{
+    uint64_t entries=0;
+    uint64_t remaining;
+
+    in.read((char *) &entries,sizeof entries);
+    if (!in) error("HopLabelIndex: label file is truncated");
+    remaining=fileSize-(uint64_t) in.tellg();
+    if (remaining/sizeof(uint64_t)<n+1) error("HopLabelIndex: label file is truncated");
+    remaining-=(n+1)*sizeof(uint64_t);
+    if (remaining/(sizeof(uint32_t)+sizeof(uint16_t))<entries)
+    {
+        error("HopLabelIndex: label file is truncated");
+    }
+    offsets.resize(n+1);
+    for (size_t v=0;v<=n;v++)
+    {
+        uint64_t value=0;
+
+        in.read((char *) &value,sizeof value);
+        if (value%4!=0||value>entries||(v>0&&value<offsets[v-1])||(v==0&&value!=0))
+        {
+            error("HopLabelIndex: label file has invalid offsets");
+        }
+        offsets[v]=value;
+    }
+    if (!in) error("HopLabelIndex: label file is truncated");
+    if (offsets[n]!=entries) error("HopLabelIndex: label file has invalid offsets");
+    hubs.resize(entries);
+    distances.resize(entries);
+    in.read((char *) hubs.data(),entries*sizeof(uint32_t));
+    in.read((char *) distances.data(),entries*sizeof(uint16_t));
+    if (!in) error("HopLabelIndex: label file is truncated");
+    for (size_t v=0;v<n;v++)
+    {
+        size_t first=offsets[v];
+        size_t last=offsets[v+1];
+
+        if (first==last||hubs[last-1]!=NO_NODE) error("HopLabelIndex: label list is not padded");
+        for (size_t i=first;i<last;i++)
+        {
+            if (hubs[i]==NO_NODE)
+            {
+                if (i+1<last&&hubs[i+1]!=NO_NODE) error("HopLabelIndex: label list is not padded");
+            } else if (hubs[i]>=n)
+            {
+                error("HopLabelIndex: label list has a hub out of range");
+            } else if (i>first&&hubs[i]<=hubs[i-1])
+            {
+                error("HopLabelIndex: label list is not sorted");
+            }
+        }
+    }
+}
+
+void HopLabelIndex::save(const std::string & filename) const
+{
+    TRACE_SCOPE("HopLabelIndex::save");
+    std::ofstream out(filename.c_str(),std::ios::binary);
+    uint64_t nodes=n;
+    uint32_t kind=symmetric ? 1 : 0;
+
+    if (!out) error("HopLabelIndex: can't open " + filename);
+    out.write(LABEL_MAGIC,sizeof LABEL_MAGIC);
+    out.write((const char *) &LABEL_VERSION,sizeof LABEL_VERSION);
+    out.write((const char *) &nodes,sizeof nodes);
+    out.write((const char *) &kind,sizeof kind);
+    writeLabels(out,toHub.offsets,toHub.hubs,toHub.distances);
+    if (!symmetric) writeLabels(out,fromHub.offsets,fromHub.hubs,fromHub.distances);
+    if (!out) error("HopLabelIndex: write failed for " + filename);
+}
+
+void HopLabelIndex::load(const std::string & filename)
+{
+    TRACE_SCOPE("HopLabelIndex::load");
+    std::ifstream in(filename.c_str(),std::ios::binary|std::ios::ate);
+    char magic[4];
+    uint32_t version,kind;
+    uint64_t nodes,fileSize;
+    labelset to,from;
+
+    if (!in) error("HopLabelIndex: can't open " + filename);
+    fileSize=(uint64_t) in.tellg();
+    in.seekg(0);
+    in.read(magic,sizeof magic);
+    in.read((char *) &version,sizeof version);
+    in.read((char *) &nodes,sizeof nodes);
+    in.read((char *) &kind,sizeof kind);
+    if (!in||!std::equal(magic,magic+4,LABEL_MAGIC)||version!=LABEL_VERSION||kind>1||nodes>=NO_NODE)
+    {
+        error("HopLabelIndex: " + filename + " is not a label file");
+    }
+    readLabels(in,nodes,fileSize,to.offsets,to.hubs,to.distances);
+    if (kind==0) readLabels(in,nodes,fileSize,from.offsets,from.hubs,from.distances);
+    n=nodes;
+    symmetric=(kind==1);
+    toHub=std::move(to);
+    fromHub=std::move(from);
+}
@@ -0,0 +1,119 @@
+/*
+ * File: hoplabels.h
+ * -----------------
+ * This interface exports the HopLabelIndex class, a pruned landmark labeling that answers exact
+ * hop-distance queries on a fixed graph without searching it.
+ */
+
+#ifndef _hoplabels_h
+#define _hoplabels_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Class: HopLabelIndex
+ * --------------------
+ * This class stores for every node a short list of hub nodes together with the number of arcs
+ * between the node and each hub, chosen so that every shortest path passes through a hub that the
+ * labels of both of its ends share (a 2-hop cover). A query merges two sorted lists. Arc costs are
+ * ignored. Queries may be made from several threads at once.
+ */
+
+class HopLabelIndex
+{
+public:
+
+/*
+ * Constructor: HopLabelIndex
+ * Usage: HopLabelIndex index;
+ *        HopLabelIndex index(csr,symmetric);
+ * ------------------------------------------
+ * Creates an empty index, or the index of graph. If symmetric is true, the caller promises that
+ * every arc is matched by one in the opposite direction, which halves the size and build time of
+ * the index; otherwise separate labels are kept for paths leaving and entering each node.
+ */
+
+    HopLabelIndex();
+    explicit HopLabelIndex(const CSRGraph & graph,bool symmetric=false);
+
+/*
+ * Method: build
+ * Usage: index.build(csr,symmetric);
+ * ----------------------------------
+ * Replaces the contents of the index with the index of graph. This method signals an error if a
+ * shortest path is longer than 65534 arcs.
+ */
+
+    void build(const CSRGraph & graph,bool symmetric=false);
+
+/*
+ * Method: hops
+ * Usage: int n=index.hops(from,to);
+ * ---------------------------------
+ * Returns the number of arcs on a shortest path from from to to, or -1 if there is none.
+ */
+
+    int hops(uint32_t from,uint32_t to) const;
+
+/*
+ * Methods: nodeCount, labelCount, isSymmetric
+ * Usage: size_t entries=index.labelCount();
+ * -----------------------------------------
+ * Return the number of nodes, the total number of label entries and the kind of the index.
+ */
+
+    size_t nodeCount() const;
+    size_t labelCount() const;
+    bool isSymmetric() const;
+
+/*
+ * Methods: save, load
+ * Usage: index.save(filename);
+ *        index.load(filename);
+ * ----------------------------
+ * Write the index to a binary file and read it back: the magic string "HOPL", a format version, the
+ * node count and kind, then the label arrays in native byte order. Both methods signal an error if
+ * the file cannot be accessed or is not a valid index file; load leaves the index unchanged then.
+ */
+
+    void save(const std::string & filename) const;
+    void load(const std::string & filename);
+
+private:
+
+/*
+ * Implementation notes: data structure
+ * ------------------------------------
+ * Hubs are identified by their rank in the order in which they were processed, so each list is
+ * sorted simply by being built in that order. The lists of all nodes are stored back to back in one
+ * array of hubs and one parallel array of distances, like the rows of a CSR graph. Every list is
+ * padded with NO_NODE to a multiple of four entries with at least one pad, which lets the query
+ * compare four hubs of each list at a time and find the end of a list without its length. A directed
+ * index keeps two such label sets: toHub holds the distances from each node to its hubs and fromHub
+ * those from the hubs to the node. A symmetric index uses toHub for both.
+ */
+
+    struct labelset
+    {
+        std::vector<size_t> offsets;            /* List boundaries, nodeCount+1 entries */
+        std::vector<uint32_t> hubs;             /* Hub ranks, sorted and padded per node */
+        std::vector<uint16_t> distances;        /* Hops to or from each hub */
+    };
+
+/* Instance variables */
+
+    size_t n;
+    bool symmetric;
+    labelset toHub;
+    labelset fromHub;
+
+/* Private method prototypes */
+
+    static int merge(const labelset & a,uint32_t u,const labelset & b,uint32_t v);
+};
+
+#endif
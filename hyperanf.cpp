@@ -0,0 +1,199 @@
+/*
+ * File: hyperanf.cpp
+ * ------------------
+ * This file implements the hyperanf.h interface.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include "error.h"
+#include "hyperanf.h"
+#include "splitmix.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Implementation notes: unionInto
+ * -------------------------------
+ * The union of two HyperLogLog counters is their register-wise maximum. The SSE2 version takes the
+ * maximum of sixteen registers per instruction, which is why counters have at least sixteen
+ * registers. Returns true if target changed.
+ */
+
+static bool unionInto(uint8_t * target,const uint8_t * source,size_t registers)
+{
+#ifdef __SSE2__
+    __m128i changed=_mm_setzero_si128();
+
+    for (size_t j=0;j<registers;j+=16)
+    {
+        __m128i a=_mm_loadu_si128((const __m128i *) (target+j));
+        __m128i b=_mm_loadu_si128((const __m128i *) (source+j));
+        __m128i m=_mm_max_epu8(a,b);
+
+        changed=_mm_or_si128(changed,_mm_xor_si128(m,a));
+        _mm_storeu_si128((__m128i *) (target+j),m);
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(changed,_mm_setzero_si128()))!=0xFFFF;
+#else
+    bool changed=false;
+
+    for (size_t j=0;j<registers;j++)
+    {
+        if (source[j]>target[j])
+        {
+            target[j]=source[j];
+            changed=true;
+        }
+    }
+    return changed;
+#endif
+}
+
+/*
+ * Implementation notes: estimate
+ * ------------------------------
+ * The HyperLogLog estimate of Flajolet et al.: alpha m^2 divided by the sum of 2^-r over the
+ * registers r, replaced by linear counting, m ln(m/V) for V empty registers, while the estimate is
+ * below 2.5m. power holds 2^-r for every possible register value.
+ */
+
+static double estimate(const uint8_t * counter,size_t registers,const double * power)
+{
+    double m=(double) registers;
+    double alpha=0.7213/(1+1.079/m);
+    double sum=0;
+    size_t zeros=0;
+
+    for (size_t j=0;j<registers;j++)
+    {
+        sum+=power[counter[j]];
+        if (counter[j]==0) zeros++;
+    }
+
+    double e=alpha*m*m/sum;
+
+    if (e<=2.5*m&&zeros>0) e=m*std::log(m/zeros);
+    return e;
+}
+
+/*
+ * Implementation notes: hyperANF
+ * ------------------------------
+ * The counter of node v at distance h is the union of its own counter at distance h-1 with those
+ * of its successors, because v reaches within h arcs exactly the nodes its successors reach within
+ * h-1. Every round reads one array of counters and writes the other, so the nodes can be processed
+ * in parallel without locks. A node needs to be recomputed only if one of its successors changed in
+ * the previous round; otherwise its new counter is a copy of the old one, and even the copy is
+ * needed only if the node itself changed, since the two arrays already agree on the other nodes.
+ * Each piece adds its share of the neighborhood function under a lock once.
+ */
+
+void hyperANF(const CSRGraph & graph,std::vector<double> & neighborhood,std::vector<double> & reach,
+              const HyperANFOptions & options)
+{
+    TRACE_SCOPE("hyperANF");
+    size_t n=graph.nodeCount;
+
+    if (options.log2Registers<4||options.log2Registers>16)
+    {
+        error("hyperANF: log2Registers must be between 4 and 16");
+    }
+
+    int b=options.log2Registers;
+    size_t registers=(size_t) 1<<b;
+    std::vector<uint8_t> current(n*registers,0),next(n*registers,0);
+    std::vector<uint8_t> changed(n,1),changedNext(n,0);
+    double power[66];
+    std::mutex lock;
+    double total=0;
+
+    for (int r=0;r<66;r++) power[r]=std::ldexp(1.0,-r);
+    parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        double sum=0;
+
+        for (size_t v=first;v<last;v++)
+        {
+            uint64_t h=mix64(v^mix64(options.seed));
+            size_t j=h&(registers-1);
+            uint64_t rest=h>>b;
+            int rank=1;
+
+            while (rank<=64-b&&(rest&1)==0)
+            {
+                rank++;
+                rest>>=1;
+            }
+            current[v*registers+j]=(uint8_t) rank;
+            next[v*registers+j]=(uint8_t) rank;
+            sum+=estimate(&current[v*registers],registers,power);
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        total+=sum;
+    },1024);
+    neighborhood.assign(1,total);
+    for (int hop=1;options.maxHops<=0||hop<=options.maxHops;hop++)
+    {
+        TRACE_SCOPE_VALUE("hyperanf.hop",hop);
+        bool any=false;
+
+        total=0;
+        parallelFor(0,n,[&](size_t first,size_t last)
+        {
+            double sum=0;
+            bool moved=false;
+
+            for (size_t v=first;v<last;v++)
+            {
+                uint8_t * target=&next[v*registers];
+                bool dirty=false;
+                bool grew=false;
+
+                for (size_t i=graph.offsets[v];i<graph.offsets[v+1]&&!dirty;i++)
+                {
+                    dirty=changed[graph.targets[i]]!=0;
+                }
+                if (dirty||changed[v])
+                {
+                    std::memcpy(target,&current[v*registers],registers);
+                }
+                if (dirty)
+                {
+                    for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+                    {
+                        uint32_t t=graph.targets[i];
+
+                        if (!changed[t]) continue;
+                        if (unionInto(target,&current[t*registers],registers)) grew=true;
+                    }
+                }
+                changedNext[v]=grew;
+                moved|=grew;
+                sum+=estimate(target,registers,power);
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+
+            total+=sum;
+            any|=moved;
+        },1024);
+        if (!any) break;
+        neighborhood.push_back(total);
+        current.swap(next);
+        changed.swap(changedNext);
+    }
+    reach.resize(n);
+    parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++) reach[v]=estimate(&current[v*registers],registers,power);
+    },1024);
+}
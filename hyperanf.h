@@ -0,0 +1,52 @@
+/*
+ * File: hyperanf.h
+ * ----------------
+ * This interface exports HyperANF, which estimates the neighborhood function of a graph in CSR form:
+ * for every distance h, the number of pairs of nodes u,v such that v can be reached from u along at
+ * most h arcs. It also estimates for every node how many nodes it can reach. The estimates come
+ * from one HyperLogLog counter per node, so the memory needed is fixed in advance and the work is
+ * linear in the size of the graph per distance.
+ */
+
+#ifndef _hyperanf_h
+#define _hyperanf_h
+
+#include <cstddef>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: HyperANFOptions
+ * ---------------------
+ * This type collects the settings of hyperANF. Every counter has 2^log2Registers one-byte registers,
+ * between 2^4 and 2^16; the relative standard error of an estimate is about 1.04/sqrt(registers),
+ * and the memory used is twice the number of nodes times the number of registers in bytes. The
+ * iteration stops when no counter changes or after maxHops distances, if maxHops is positive. The
+ * seed selects the hash function.
+ */
+
+struct HyperANFOptions
+{
+    int log2Registers;                          /* Base-2 logarithm of the registers per counter */
+    int maxHops;                                /* Limit on the distance, 0 for none */
+    unsigned long long seed;                    /* Seed for hashing the nodes */
+
+    HyperANFOptions() : log2Registers(6),maxHops(0),seed(1) {}
+};
+
+/*
+ * Function: hyperANF
+ * Usage: hyperANF(csr,neighborhood,reach);
+ *        hyperANF(csr,neighborhood,reach,options);
+ * ------------------------------------------------
+ * Estimates the neighborhood function of graph, following arcs in their direction. On return
+ * neighborhood[h] is the estimated number of pairs within distance h, starting with h=0, and the
+ * last entry is the estimate for the largest distance computed; reach[v] is the estimated number of
+ * nodes reachable from v at that distance, including v itself. The work runs on the current thread
+ * pool.
+ */
+
+void hyperANF(const CSRGraph & graph,std::vector<double> & neighborhood,std::vector<double> & reach,
+              const HyperANFOptions & options=HyperANFOptions());
+
+#endif
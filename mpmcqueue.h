@@ -0,0 +1,332 @@
+/*
+ * File: mpmcqueue.h
+ * -----------------
+ * This interface exports the MPMCQueue template class, a bounded first-in, first-out queue that any
+ * number of threads may enqueue to and dequeue from at the same time without locks. It is meant for
+ * frontiers and pipelines shared between worker threads, where the single-threaded Queue class
+ * cannot be used.
+ */
+
+#ifndef _mpmcqueue_h
+#define _mpmcqueue_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "error.h"
+
+/*
+ * Class: MPMCQueue<valuetype>
+ * ---------------------------
+ * This class models a ring buffer of fixed capacity shared by several producers and consumers. The
+ * try methods never wait: they report failure when the queue is full or empty. Because other threads
+ * may operate on the queue concurrently, size and isEmpty are only snapshots. The value type must be
+ * default-constructible and copyable.
+ */
+
+template <typename valuetype>
+class MPMCQueue
+{
+public:
+
+/*
+ * Constructor: MPMCQueue
+ * Usage: MPMCQueue<valuetype> queue(capacity);
+ * --------------------------------------------
+ * Creates an empty queue that holds at least capacity values; the capacity is rounded up to a power
+ * of two. All storage is allocated here, so the queue never allocates afterwards.
+ */
+
+    explicit MPMCQueue(size_t capacity);
+
+/*
+ * Destructor: ~MPMCQueue
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage of the queue. No other thread may be using it.
+ */
+
+    ~MPMCQueue();
+
+/*
+ * Methods: capacity, size, isEmpty
+ * Usage: size_t n=queue.size();
+ * -----------------------------
+ * Return the capacity of the queue and the approximate number of values it holds.
+ */
+
+    size_t capacity() const;
+    size_t size() const;
+    bool isEmpty() const;
+
+/*
+ * Methods: tryEnqueue, tryDequeue
+ * Usage: if (queue.tryEnqueue(value)) . . .
+ *        if (queue.tryDequeue(value)) . . .
+ * -----------------------------------------
+ * Add a value at the tail or remove the value at the head. Each returns false, leaving the queue
+ * unchanged, if the queue is full or empty respectively.
+ */
+
+    bool tryEnqueue(const valuetype & value);
+    bool tryDequeue(valuetype & value);
+
+/*
+ * Methods: enqueueBatch, dequeueBatch
+ * Usage: size_t n=queue.enqueueBatch(values,count);
+ *        size_t n=queue.dequeueBatch(values,count);
+ * -------------------------------------------------
+ * Move up to count values between the array values and the queue, claiming all of their slots with a
+ * single atomic operation, and return the number moved. The values of one batch stay consecutive in
+ * the queue.
+ */
+
+    size_t enqueueBatch(const valuetype * values,size_t count);
+    size_t dequeueBatch(valuetype * values,size_t count);
+
+/*
+ * Method: enqueue
+ * Usage: queue.enqueue(value);
+ * ----------------------------
+ * Adds a value at the tail, yielding the processor while the queue is full.
+ */
+
+    void enqueue(const valuetype & value);
+
+private:
+
+/*
+ * Implementation notes: data structure
+ * ------------------------------------
+ * This is Dmitry Vyukov's bounded MPMC queue. Every cell carries a sequence number that says whose
+ * turn it is: a cell at position pos is free for the producer of pos when its sequence is pos, and
+ * holds a value for the consumer of pos when its sequence is pos+1. A producer claims a position
+ * by advancing enqueuePos with compare-and-swap, writes the value and publishes it by storing the
+ * new sequence; consumers do the mirror image with dequeuePos and release the cell for the next lap
+ * by setting its sequence to pos+capacity. The two positions sit on separate cache lines so that
+ * producers and consumers do not invalidate each other's line.
+ *
+ *   enqueuePos --> | seq=pos   |  free          dequeuePos --> | seq=pos+1 |  full
+ */
+
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        valuetype data;
+    };
+
+/* Instance variables */
+
+    std::unique_ptr<cell[]> buffer;             /* Ring of cells */
+    size_t mask;                                /* Capacity minus one */
+    alignas(64) std::atomic<size_t> enqueuePos; /* Next position to be filled */
+    alignas(64) std::atomic<size_t> dequeuePos; /* Next position to be emptied */
+
+/* Private method prototypes */
+
+    MPMCQueue(const MPMCQueue &);
+    MPMCQueue & operator=(const MPMCQueue &);
+};
+
+/*
+ * Implementation section
+ * ----------------------
+ * C++ requires that the implementation for a template class be available to the compiler whenever that
+ * type is used. The effect of this restriction is that header files must include the implementation.
+ * Clients should not need to look at any of the code beyond this point.
+ */
+
+template <typename valuetype>
+MPMCQueue<valuetype>::MPMCQueue(size_t capacity)
+{
+    size_t size=2;
+
+    if (capacity>((size_t) 1<<(8*sizeof(size_t)-2))) error("MPMCQueue: capacity too large");
+    while (size<capacity) size*=2;
+    buffer.reset(new cell[size]);
+    mask=size-1;
+    for (size_t i=0;i<size;i++) buffer[i].sequence.store(i,std::memory_order_relaxed);
+    enqueuePos.store(0,std::memory_order_relaxed);
+    dequeuePos.store(0,std::memory_order_relaxed);
+}
+
+template <typename valuetype>
+MPMCQueue<valuetype>::~MPMCQueue()
+{}
+
+template <typename valuetype>
+size_t MPMCQueue<valuetype>::capacity() const
+{
+    return mask+1;
+}
+
+template <typename valuetype>
+size_t MPMCQueue<valuetype>::size() const
+{
+    size_t tail=enqueuePos.load(std::memory_order_relaxed);
+    size_t head=dequeuePos.load(std::memory_order_relaxed);
+
+    return (tail>head) ? tail-head : 0;
+}
+
+template <typename valuetype>
+bool MPMCQueue<valuetype>::isEmpty() const
+{
+    return size()==0;
+}
+
+/*
+ * Implementation notes: tryEnqueue, tryDequeue
+ * --------------------------------------------
+ * The difference between a cell's sequence and the position tells the three cases apart: zero means
+ * the cell is ready, negative means the queue is full (or empty), and positive means another thread
+ * claimed the position first, so the position is reloaded and the attempt repeated.
+ */
+
+template <typename valuetype>
+bool MPMCQueue<valuetype>::tryEnqueue(const valuetype & value)
+{
+    size_t pos=enqueuePos.load(std::memory_order_relaxed);
+    cell * c;
+
+    while (true)
+    {
+        c=&buffer[pos&mask];
+
+        size_t seq=c->sequence.load(std::memory_order_acquire);
+        intptr_t diff=(intptr_t) seq-(intptr_t) pos;
+
+        if (diff==0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed)) break;
+        } else if (diff<0)
+        {
+            return false;
+        } else
+        {
+            pos=enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    c->data=value;
+    c->sequence.store(pos+1,std::memory_order_release);
+    return true;
+}
+
+template <typename valuetype>
+bool MPMCQueue<valuetype>::tryDequeue(valuetype & value)
+{
+    size_t pos=dequeuePos.load(std::memory_order_relaxed);
+    cell * c;
+
+    while (true)
+    {
+        c=&buffer[pos&mask];
+
+        size_t seq=c->sequence.load(std::memory_order_acquire);
+        intptr_t diff=(intptr_t) seq-(intptr_t) (pos+1);
+
+        if (diff==0)
+        {
+            if (dequeuePos.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed)) break;
+        } else if (diff<0)
+        {
+            return false;
+        } else
+        {
+            pos=dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    value=c->data;
+    c->sequence.store(pos+mask+1,std::memory_order_release);
+    return true;
+}
+
+/*
+ * Implementation notes: enqueueBatch, dequeueBatch
+ * ------------------------------------------------
+ * A batch first counts how many consecutive cells from the current position are ready, up to count,
+ * and then claims all of them with one compare-and-swap. A cell that was ready cannot be taken back
+ * by anyone else before the claim succeeds, because every other thread would have to claim its
+ * position first; if the claim fails, the scan starts again from the new position.
+ */
+
+template <typename valuetype>
+size_t MPMCQueue<valuetype>::enqueueBatch(const valuetype * values,size_t count)
+{
+    size_t pos=enqueuePos.load(std::memory_order_relaxed);
+    size_t ready;
+
+    while (true)
+    {
+        ready=0;
+        while (ready<count&&ready<=mask
+               &&buffer[(pos+ready)&mask].sequence.load(std::memory_order_acquire)==pos+ready)
+        {
+            ready++;
+        }
+        if (ready==0)
+        {
+            size_t seq=buffer[pos&mask].sequence.load(std::memory_order_acquire);
+
+            if ((intptr_t) seq-(intptr_t) pos<0) return 0;
+            pos=enqueuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (enqueuePos.compare_exchange_weak(pos,pos+ready,std::memory_order_relaxed)) break;
+    }
+    for (size_t i=0;i<ready;i++)
+    {
+        cell & c=buffer[(pos+i)&mask];
+
+        c.data=values[i];
+        c.sequence.store(pos+i+1,std::memory_order_release);
+    }
+    return ready;
+}
+
+template <typename valuetype>
+size_t MPMCQueue<valuetype>::dequeueBatch(valuetype * values,size_t count)
+{
+    size_t pos=dequeuePos.load(std::memory_order_relaxed);
+    size_t ready;
+
+    while (true)
+    {
+        ready=0;
+        while (ready<count&&ready<=mask
+               &&buffer[(pos+ready)&mask].sequence.load(std::memory_order_acquire)==pos+ready+1)
+        {
+            ready++;
+        }
+        if (ready==0)
+        {
+            size_t seq=buffer[pos&mask].sequence.load(std::memory_order_acquire);
+
+            if ((intptr_t) seq-(intptr_t) (pos+1)<0) return 0;
+            pos=dequeuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (dequeuePos.compare_exchange_weak(pos,pos+ready,std::memory_order_relaxed)) break;
+    }
+    for (size_t i=0;i<ready;i++)
+    {
+        cell & c=buffer[(pos+i)&mask];
+
+        values[i]=c.data;
+        c.sequence.store(pos+i+mask+1,std::memory_order_release);
+    }
+    return ready;
+}
+
+template <typename valuetype>
+void MPMCQueue<valuetype>::enqueue(const valuetype & value)
+{
+    while (!tryEnqueue(value))
+    {
+        std::this_thread::yield();
+    }
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * File: neighborhood.cpp
+ * ----------------------
+ * This file implements the neighborhood.h interface.
+ */
+
+#include <algorithm>
+#include "error.h"
+#include "neighborhood.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: kHopNeighborhood
+ * --------------------------------------
+ * The search runs level by level on result.nodes itself, which serves as the queue. The visited set
+ * is a per-thread array of stamps, as in reachability.cpp: a node has been collected if its stamp
+ * equals the epoch of the current search, so starting a new search costs nothing, and local holds
+ * the position of every collected node in result.nodes. The arrays are sized for the whole graph
+ * once per thread; the per-search work is proportional to the arcs of the collected nodes, except
+ * that the last level is not expanded. The induced subgraph keeps the arcs whose target carries the
+ * current stamp, renumbered through local; the rows are sorted afterwards because renumbering does
+ * not preserve their order.
+ */
+
+void kHopNeighborhood(const CSRGraph & graph,uint32_t seed,Neighborhood & result,
+                      const NeighborhoodOptions & options,SearchBudget * budget)
+{
+    TRACE_SCOPE("kHopNeighborhood");
+    BudgetMeter meter(budget);
+    thread_local std::vector<uint32_t> stamp;
+    thread_local std::vector<uint32_t> local;
+    thread_local uint32_t epoch=0;
+    size_t cap=(options.maxNodes==0) ? SIZE_MAX : options.maxNodes;
+
+    if (seed>=graph.nodeCount) error("kHopNeighborhood: seed out of range");
+    if (options.hops<0) error("kHopNeighborhood: hops must not be negative");
+    if (stamp.size()<graph.nodeCount)
+    {
+        stamp.resize(graph.nodeCount,0);
+        local.resize(graph.nodeCount);
+    }
+    if (++epoch==0)
+    {
+        std::fill(stamp.begin(),stamp.end(),0);
+        epoch=1;
+    }
+    result=Neighborhood();
+    result.seed=seed;
+    result.levels.push_back(0);
+    result.nodes.push_back(seed);
+    stamp[seed]=epoch;
+    local[seed]=0;
+    if (budget!=NULL&&budget->isExhausted()) result.truncated=true;
+    for (int level=0;level<options.hops&&!result.truncated;level++)
+    {
+        size_t first=result.levels.back();
+        size_t last=result.nodes.size();
+
+        if (first==last) break;
+        result.levels.push_back(last);
+        for (size_t k=first;k<last&&!result.truncated;k++)
+        {
+            uint32_t v=result.nodes[k];
+
+            for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+            {
+                uint32_t t=graph.targets[i];
+
+                if (stamp[t]==epoch) continue;
+                if (result.nodes.size()>=cap)
+                {
+                    result.truncated=true;
+                    break;
+                }
+                stamp[t]=epoch;
+                local[t]=(uint32_t) result.nodes.size();
+                result.nodes.push_back(t);
+            }
+            if (!meter.tick(1+graph.degree(v))) result.truncated=true;
+        }
+    }
+    if (result.levels.back()<result.nodes.size()) result.levels.push_back(result.nodes.size());
+    if (!options.induced) return;
+
+    CSRGraph & sub=result.subgraph;
+    size_t n=result.nodes.size();
+
+    sub.nodeCount=n;
+    sub.offsets.assign(n+1,0);
+    for (size_t k=0;k<n;k++)
+    {
+        uint32_t v=result.nodes[k];
+
+        for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+        {
+            uint32_t t=graph.targets[i];
+
+            if (stamp[t]!=epoch) continue;
+            sub.targets.push_back(local[t]);
+            sub.costs.push_back(graph.costs[i]);
+        }
+        sub.offsets[k+1]=sub.targets.size();
+    }
+    sortArcs(sub,0,n);
+}
+
+/*
+ * Implementation notes: kHopNeighborhoods
+ * ---------------------------------------
+ * Every seed is an independent search, so the batch is simply spread over the pool with a grain of
+ * one seed; work stealing balances seeds whose neighborhoods differ wildly in size. Each search keeps
+ * its own meter, and once the shared budget is exhausted the remaining seeds return just themselves,
+ * marked as truncated.
+ */
+
+void kHopNeighborhoods(const CSRGraph & graph,const std::vector<uint32_t> & seeds,
+                       std::vector<Neighborhood> & results,const NeighborhoodOptions & options,
+                       SearchBudget * budget)
+{
+    TRACE_SCOPE_VALUE("kHopNeighborhoods",seeds.size());
+
+    results.resize(seeds.size());
+    parallelFor(0,seeds.size(),[&](size_t first,size_t last)
+    {
+        for (size_t k=first;k<last;k++)
+        {
+            kHopNeighborhood(graph,seeds[k],results[k],options,budget);
+        }
+    },1);
+}
@@ -0,0 +1,85 @@
+/*
+ * File: neighborhood.h
+ * --------------------
+ * This interface exports the extraction of k-hop neighborhoods: the nodes within a given number of
+ * arcs of a seed, grouped by distance, optionally together with the subgraph they induce. Unlike a
+ * full breadth-first search, the work is proportional to the size of the neighborhood, not of the
+ * graph.
+ */
+
+#ifndef _neighborhood_h
+#define _neighborhood_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "csrgraph.h"
+#include "searchbudget.h"
+
+/*
+ * Type: NeighborhoodOptions
+ * -------------------------
+ * This type collects the settings of kHopNeighborhood. The search follows at most hops arcs from the
+ * seed. A positive maxNodes caps the number of nodes collected, which bounds the memory a seed next
+ * to a hub can take; 0 means no cap. If induced is true, the subgraph induced by the collected nodes
+ * is built as well.
+ */
+
+struct NeighborhoodOptions
+{
+    int hops;                                   /* Depth bound */
+    size_t maxNodes;                            /* Cap on collected nodes, 0 for none */
+    bool induced;                               /* Also build the induced subgraph */
+
+    NeighborhoodOptions() : hops(2),maxNodes(0),induced(false) {}
+};
+
+/*
+ * Type: Neighborhood
+ * ------------------
+ * This type holds one k-hop neighborhood. nodes lists the nodes by distance from the seed, which
+ * comes first; the nodes at distance d occupy positions levels[d] up to levels[d+1], so levels has
+ * one more entry than there are levels. truncated is true if maxNodes or the budget stopped the
+ * search early, in which case the last level is incomplete. If requested, subgraph holds the arcs
+ * between the collected nodes, with node i of the subgraph standing for nodes[i].
+ */
+
+struct Neighborhood
+{
+    uint32_t seed;                              /* Node the search started from */
+    std::vector<uint32_t> nodes;                /* Collected nodes in order of distance */
+    std::vector<size_t> levels;                 /* Start of every level in nodes, plus the end */
+    bool truncated;                             /* Search was cut short */
+    CSRGraph subgraph;                          /* Induced subgraph (optional) */
+
+    Neighborhood() : seed(NO_NODE),truncated(false) {}
+};
+
+/*
+ * Function: kHopNeighborhood
+ * Usage: kHopNeighborhood(csr,seed,result);
+ *        kHopNeighborhood(csr,seed,result,options,budget);
+ * --------------------------------------------------------
+ * Collects the nodes within options.hops arcs of seed into result. The search stops early when
+ * maxNodes nodes have been collected or the budget runs out.
+ */
+
+void kHopNeighborhood(const CSRGraph & graph,uint32_t seed,Neighborhood & result,
+                      const NeighborhoodOptions & options=NeighborhoodOptions(),
+                      SearchBudget * budget=NULL);
+
+/*
+ * Function: kHopNeighborhoods
+ * Usage: kHopNeighborhoods(csr,seeds,results);
+ *        kHopNeighborhoods(csr,seeds,results,options,budget);
+ * -----------------------------------------------------------
+ * Collects the neighborhood of every seed, so that results[i] belongs to seeds[i]. The seeds are
+ * processed in parallel on the current thread pool; the budget covers all of them together.
+ */
+
+void kHopNeighborhoods(const CSRGraph & graph,const std::vector<uint32_t> & seeds,
+                       std::vector<Neighborhood> & results,
+                       const NeighborhoodOptions & options=NeighborhoodOptions(),
+                       SearchBudget * budget=NULL);
+
+#endif
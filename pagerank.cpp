@@ -0,0 +1,265 @@
+/*
+ * File: pagerank.cpp
+ * ------------------
+ * This file implements the pagerank.h interface.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "error.h"
+#include "pagerank.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*
+ * Implementation notes: gatherSum
+ * -------------------------------
+ * Returns the sum of values[index[i]] for i in [first,last), the inner loop of the sparse
+ * matrix-vector product. With AVX2 four entries are gathered per instruction into a vector
+ * accumulator; otherwise four independent scalar sums let the processor overlap the loads. Either
+ * way the additions happen in a different order than a plain loop, which changes the result only
+ * in the last bits.
+ */
+
+static double gatherSum(const uint32_t * index,const double * values,size_t first,size_t last)
+{
+    size_t i=first;
+    double total=0;
+
+#ifdef __AVX2__
+    __m256d acc=_mm256_setzero_pd();
+
+    for (;i+4<=last;i+=4)
+    {
+        __m128i idx=_mm_loadu_si128((const __m128i *) (index+i));
+
+        acc=_mm256_add_pd(acc,_mm256_i32gather_pd(values,idx,8));
+    }
+
+    double lanes[4];
+
+    _mm256_storeu_pd(lanes,acc);
+    total=(lanes[0]+lanes[1])+(lanes[2]+lanes[3]);
+#else
+    double s0=0,s1=0,s2=0,s3=0;
+
+    for (;i+4<=last;i+=4)
+    {
+        s0+=values[index[i]];
+        s1+=values[index[i+1]];
+        s2+=values[index[i+2]];
+        s3+=values[index[i+3]];
+    }
+    total=(s0+s1)+(s2+s3);
+#endif
+    for (;i<last;i++) total+=values[index[i]];
+    return total;
+}
+
+/*
+ * Implementation notes: partitionRows
+ * -----------------------------------
+ * Splits the rows of graph into about pieces ranges of roughly equal cost, counting one unit per
+ * row and one per arc, so that a few rows with huge in-degree do not end up in one piece. The
+ * boundaries are found by binary search on the row offsets.
+ */
+
+static std::vector<size_t> partitionRows(const CSRGraph & graph,size_t pieces)
+{
+    size_t n=graph.nodeCount;
+    size_t total=n+graph.arcCount();
+    std::vector<size_t> bounds(1,0);
+
+    for (size_t k=1;k<pieces;k++)
+    {
+        size_t goal=total*k/pieces;
+        size_t lo=bounds.back(),hi=n;
+
+        while (lo<hi)
+        {
+            size_t mid=(lo+hi)/2;
+
+            if (mid+graph.offsets[mid]<goal) lo=mid+1;
+            else hi=mid;
+        }
+        if (lo>bounds.back()) bounds.push_back(lo);
+    }
+    if (bounds.back()<n||n==0) bounds.push_back(n);
+    return bounds;
+}
+
+/*
+ * Implementation notes: pageRank
+ * ------------------------------
+ * The iteration pulls: every node sums the contributions rank/outdegree of the nodes with arcs to
+ * it, which are its neighbors in the reverse graph. Each node's new rank is written by one thread
+ * only, so no synchronization is needed inside an iteration. The probability held by nodes without
+ * outgoing arcs is added to every node as part of the jump term. Every piece reports its share of
+ * the change and of the dangling probability in its own slot, and the slots are summed afterwards.
+ */
+
+int pageRank(const CSRGraph & graph,std::vector<double> & rank,const PageRankOptions & options)
+{
+    TRACE_SCOPE("pageRank");
+    ThreadPool & pool=ThreadPool::current();
+    size_t n=graph.nodeCount;
+    CSRGraph reverse;
+    std::vector<double> contribution(n),next(n);
+    int iterations=0;
+
+    rank.assign(n,n>0 ? 1.0/n : 0.0);
+    if (n==0) return 0;
+    reverseCSR(graph,reverse);
+
+    std::vector<size_t> bounds=partitionRows(reverse,8*(size_t) pool.size());
+    size_t pieces=bounds.size()-1;
+    std::vector<double> change(pieces),dangling(pieces);
+
+    while (iterations<options.maxIterations)
+    {
+        TRACE_SCOPE_VALUE("pagerank.iteration",iterations);
+
+        pool.parallelFor(0,pieces,[&](size_t first,size_t last)
+        {
+            for (size_t p=first;p<last;p++)
+            {
+                double lost=0;
+
+                for (size_t v=bounds[p];v<bounds[p+1];v++)
+                {
+                    size_t degree=graph.degree(v);
+
+                    if (degree==0) lost+=rank[v];
+                    contribution[v]=(degree==0) ? 0 : rank[v]/degree;
+                }
+                dangling[p]=lost;
+            }
+        },1);
+
+        double lost=0;
+
+        for (double x:dangling) lost+=x;
+
+        double base=(1-options.damping)/n+options.damping*lost/n;
+
+        pool.parallelFor(0,pieces,[&](size_t first,size_t last)
+        {
+            for (size_t p=first;p<last;p++)
+            {
+                double delta=0;
+
+                for (size_t v=bounds[p];v<bounds[p+1];v++)
+                {
+                    double sum=gatherSum(reverse.targets.data(),contribution.data(),
+                                         reverse.offsets[v],reverse.offsets[v+1]);
+
+                    next[v]=base+options.damping*sum;
+                    delta+=std::fabs(next[v]-rank[v]);
+                }
+                change[p]=delta;
+            }
+        },1);
+        rank.swap(next);
+        iterations++;
+
+        double total=0;
+
+        for (double x:change) total+=x;
+        if (total<options.tolerance) break;
+    }
+    return iterations;
+}
+
+int pageRank(const SimpleGraph & graph,std::unordered_map<Node *,double> & ranks,
+             const PageRankOptions & options)
+{
+    CSRGraph csr;
+    std::vector<double> rank;
+
+    buildCSR(graph,csr);
+
+    int iterations=pageRank(csr,rank,options);
+
+    ranks.clear();
+    for (size_t v=0;v<csr.nodeCount;v++)
+    {
+        ranks[csr.nodes[v]]=rank[v];
+    }
+    return iterations;
+}
+
+/*
+ * Implementation notes: personalizedPageRank
+ * ------------------------------------------
+ * This is the push algorithm of Andersen, Chung and Lang. estimate holds probability that has
+ * settled and residual probability still to be spread. Pushing a node moves the jump share
+ * 1-damping of its residual into its estimate and divides the rest among its out-neighbors; a node
+ * without arcs returns the rest to source, where the surfer jumps. The nodes whose residual exceeds
+ * the threshold wait in a FIFO queue. Both maps hold only the nodes the search touches, so the cost
+ * does not depend on the size of the graph.
+ */
+
+void personalizedPageRank(const CSRGraph & graph,uint32_t source,
+                          std::vector<std::pair<uint32_t,double> > & scores,
+                          const PageRankOptions & options)
+{
+    TRACE_SCOPE("personalizedPageRank");
+    std::unordered_map<uint32_t,double> estimate;
+    std::unordered_map<uint32_t,double> residual;
+    std::vector<uint32_t> queue;
+    double jump=1-options.damping;
+
+    if (source>=graph.nodeCount) error("personalizedPageRank: source out of range");
+    if (options.tolerance<=0) error("personalizedPageRank: tolerance must be positive");
+    residual[source]=1;
+    queue.push_back(source);
+    for (size_t head=0;head<queue.size();head++)
+    {
+        uint32_t u=queue[head];
+        size_t degree=graph.degree(u);
+        double r=residual[u];
+
+        if (r<options.tolerance*std::max<size_t>(degree,1)) continue;
+        residual[u]=0;
+        estimate[u]+=jump*r;
+        if (degree==0)
+        {
+            double & target=residual[source];
+            double threshold=options.tolerance*std::max<size_t>(graph.degree(source),1);
+            bool waiting=(target>=threshold);
+
+            target+=options.damping*r;
+            if (!waiting&&target>=threshold) queue.push_back(source);
+            continue;
+        }
+
+        double share=options.damping*r/degree;
+
+        for (size_t i=graph.offsets[u];i<graph.offsets[u+1];i++)
+        {
+            uint32_t v=graph.targets[i];
+            double & target=residual[v];
+            double threshold=options.tolerance*std::max<size_t>(graph.degree(v),1);
+            bool waiting=(target>=threshold);
+
+            target+=share;
+            if (!waiting&&target>=threshold) queue.push_back(v);
+        }
+        if (head>=4096&&2*head>=queue.size())
+        {
+            queue.erase(queue.begin(),queue.begin()+head+1);
+            head=(size_t) -1;
+        }
+    }
+    scores.assign(estimate.begin(),estimate.end());
+    std::sort(scores.begin(),scores.end(),[](const std::pair<uint32_t,double> & a,
+                                             const std::pair<uint32_t,double> & b)
+    {
+        if (a.second!=b.second) return a.second>b.second;
+        return a.first<b.first;
+    });
+}
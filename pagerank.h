@@ -0,0 +1,67 @@
+/*
+ * File: pagerank.h
+ * ----------------
+ * This interface exports PageRank for graphs in CSR form, together with a local algorithm for
+ * personalized PageRank with respect to a single node.
+ */
+
+#ifndef _pagerank_h
+#define _pagerank_h
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: PageRankOptions
+ * ---------------------
+ * This type collects the settings of pageRank and personalizedPageRank. The damping factor is the
+ * probability that the random surfer follows an arc rather than jumping. pageRank stops when the
+ * sum of the absolute changes of all ranks in one iteration falls below tolerance, or after
+ * maxIterations; personalizedPageRank stops when no node holds more than tolerance times its degree
+ * of unpropagated probability.
+ */
+
+struct PageRankOptions
+{
+    double damping;                             /* Probability of following an arc */
+    double tolerance;                           /* Convergence threshold */
+    int maxIterations;                          /* Limit on pageRank iterations */
+
+    PageRankOptions() : damping(0.85),tolerance(1e-9),maxIterations(100) {}
+};
+
+/*
+ * Function: pageRank
+ * Usage: int iterations=pageRank(csr,rank);
+ *        int iterations=pageRank(graph,ranks,options);
+ * ----------------------------------------------------
+ * Computes the PageRank of every node and returns the number of iterations performed. The ranks sum
+ * to one; the rank of nodes without outgoing arcs is spread evenly over all nodes. Parallel arcs
+ * count separately and arc costs are ignored. The CSR form runs on the current thread pool; the
+ * SimpleGraph form converts the graph and reports the ranks by node.
+ */
+
+int pageRank(const CSRGraph & graph,std::vector<double> & rank,
+             const PageRankOptions & options=PageRankOptions());
+int pageRank(const SimpleGraph & graph,std::unordered_map<Node *,double> & ranks,
+             const PageRankOptions & options=PageRankOptions());
+
+/*
+ * Function: personalizedPageRank
+ * Usage: personalizedPageRank(csr,source,scores);
+ * -----------------------------------------------
+ * Approximates the PageRank of every node for a surfer who always jumps back to source, touching only
+ * the part of the graph near source. On return scores lists the nodes with a positive estimate and
+ * their estimates, in decreasing order of score. The estimates never exceed the true values, and the
+ * probability left unpropagated at any node is below tolerance times its degree.
+ */
+
+void personalizedPageRank(const CSRGraph & graph,uint32_t source,
+                          std::vector<std::pair<uint32_t,double> > & scores,
+                          const PageRankOptions & options=PageRankOptions());
+
+#endif
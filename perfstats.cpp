@@ -0,0 +1,139 @@
+/*
+ * File: perfstats.cpp
+ * -------------------
+ * This file implements the perfstats.h interface.
+ */
+
+#include <cstring>
+#include "perfstats.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Implementation notes: CounterGroup
+ * ----------------------------------
+ * Each thread owns one perf event group whose leader counts cycles and whose members count
+ * instructions, cache misses and branch misses. The group is opened on first use, counts user-mode
+ * events of the calling thread only and is read in one system call with PERF_FORMAT_GROUP. If the
+ * kernel refuses any event, the whole group is abandoned and the thread never tries again.
+ */
+
+namespace
+{
+
+const int EVENT_COUNT=4;
+
+struct CounterGroup
+{
+    int fds[EVENT_COUNT];
+    bool tried;
+    bool open;
+
+    CounterGroup() : tried(false),open(false)
+    {
+        for (int i=0;i<EVENT_COUNT;i++) fds[i]=-1;
+    }
+
+    ~CounterGroup()
+    {
+        close();
+    }
+
+    void close()
+    {
+#ifdef __linux__
+        for (int i=EVENT_COUNT-1;i>=0;i--)
+        {
+            if (fds[i]>=0) ::close(fds[i]);
+            fds[i]=-1;
+        }
+#endif
+        open=false;
+    }
+
+    bool ensureOpen()
+    {
+        if (tried) return open;
+        tried=true;
+#ifdef __linux__
+        static const uint64_t CONFIGS[EVENT_COUNT]=
+        {
+            PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        for (int i=0;i<EVENT_COUNT;i++)
+        {
+            struct perf_event_attr attr;
+
+            std::memset(&attr,0,sizeof attr);
+            attr.size=sizeof attr;
+            attr.type=PERF_TYPE_HARDWARE;
+            attr.config=CONFIGS[i];
+            attr.read_format=PERF_FORMAT_GROUP;
+            attr.exclude_kernel=1;
+            attr.exclude_hv=1;
+            fds[i]=(int) syscall(__NR_perf_event_open,&attr,0,-1,(i==0) ? -1 : fds[0],0);
+            if (fds[i]<0)
+            {
+                close();
+                return false;
+            }
+        }
+        open=true;
+#endif
+        return open;
+    }
+
+    bool read(uint64_t values[EVENT_COUNT])
+    {
+#ifdef __linux__
+        uint64_t buffer[1+EVENT_COUNT];
+
+        if (!ensureOpen()) return false;
+        if (::read(fds[0],buffer,sizeof buffer)!=(ssize_t) sizeof buffer) return false;
+        for (int i=0;i<EVENT_COUNT;i++) values[i]=buffer[1+i];
+        return true;
+#else
+        (void) values;
+        return false;
+#endif
+    }
+};
+
+thread_local CounterGroup counters;
+
+}
+
+PerfScope::PerfScope(PerfStats * stats) : stats(stats),active(false)
+{
+    if (stats!=NULL) active=counters.read(start);
+}
+
+PerfScope::~PerfScope()
+{
+    uint64_t end[EVENT_COUNT];
+
+    if (!active||!counters.read(end)) return;
+    stats->hardware=true;
+    stats->cycles+=end[0]-start[0];
+    stats->instructions+=end[1]-start[1];
+    stats->cacheMisses+=end[2]-start[2];
+    stats->branchMisses+=end[3]-start[3];
+}
+
+std::ostream & operator<<(std::ostream & os,const PerfStats & stats)
+{
+    os<<"{\"hardware\":"<<(stats.hardware ? "true" : "false")
+      <<",\"cycles\":"<<stats.cycles<<",\"instructions\":"<<stats.instructions
+      <<",\"cache_misses\":"<<stats.cacheMisses<<",\"branch_misses\":"<<stats.branchMisses
+      <<",\"nodes_visited\":"<<stats.nodesVisited<<",\"arcs_scanned\":"<<stats.arcsScanned
+      <<",\"visited_probes\":"<<stats.visitedProbes<<",\"sift_steps\":"<<stats.siftSteps
+      <<",\"comparisons\":"<<stats.comparisons<<"}";
+    return os;
+}
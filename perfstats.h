@@ -0,0 +1,99 @@
+/*
+ * File: perfstats.h
+ * -----------------
+ * This interface exports an optional instrumentation layer for the traversal and priority queue hot
+ * paths. When the program is compiled with GRAPH_INSTRUMENT defined, the instrumented functions read
+ * the hardware performance counters through perf_event_open and count their own work in a PerfStats
+ * structure supplied by the caller. Without GRAPH_INSTRUMENT the macros below expand to nothing and
+ * the instrumented code is identical to the uninstrumented code.
+ */
+
+#ifndef _perfstats_h
+#define _perfstats_h
+
+#include <cstdint>
+#include <iostream>
+
+/*
+ * Type: PerfStats
+ * ---------------
+ * This type accumulates the counters of one or more instrumented calls. The hardware fields stay
+ * zero, and hardware is false, when the counters cannot be opened (for example inside a container
+ * that forbids perf_event_open).
+ */
+
+struct PerfStats
+{
+    bool hardware;                              /* True if the hardware fields are valid */
+    uint64_t cycles;                            /* CPU cycles spent in user mode */
+    uint64_t instructions;                      /* Instructions retired */
+    uint64_t cacheMisses;                       /* Last-level cache misses */
+    uint64_t branchMisses;                      /* Mispredicted branches */
+    uint64_t nodesVisited;                      /* Nodes removed from a queue or stack */
+    uint64_t arcsScanned;                       /* Arcs examined */
+    uint64_t visitedProbes;                     /* Lookups and insertions in the visited set */
+    uint64_t siftSteps;                         /* Heap swaps or list cells walked */
+    uint64_t comparisons;                       /* Priority comparisons */
+
+    PerfStats()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        hardware=false;
+        cycles=instructions=cacheMisses=branchMisses=0;
+        nodesVisited=arcsScanned=visitedProbes=siftSteps=comparisons=0;
+    }
+};
+
+/*
+ * Class: PerfScope
+ * ----------------
+ * Reads the hardware counters of the calling thread when it is constructed and adds the difference
+ * to stats when it is destroyed. The counters are opened once per thread and left running, so a
+ * scope costs two reads; scopes may be nested. A scope with a NULL stats pointer does nothing.
+ */
+
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfStats * stats);
+    ~PerfScope();
+
+private:
+    PerfStats * stats;
+    uint64_t start[4];
+    bool active;
+
+    PerfScope(const PerfScope &);
+    PerfScope & operator=(const PerfScope &);
+};
+
+/*
+ * Operator: <<
+ * Usage: cout<<stats;
+ * -------------------
+ * Writes the counters as a JSON object.
+ */
+
+std::ostream & operator<<(std::ostream & os,const PerfStats & stats);
+
+/*
+ * Macros: PERF_SCOPE, PERF_COUNT
+ * ------------------------------
+ * PERF_SCOPE(stats) measures the hardware counters from this point to the end of the enclosing block,
+ * and PERF_COUNT(stats,field,n) adds n to a software counter. Both take a PerfStats pointer that may be
+ * NULL and compile to nothing unless GRAPH_INSTRUMENT is defined.
+ */
+
+#ifdef GRAPH_INSTRUMENT
+#define PERF_SCOPE(stats) PerfScope perfScope_((stats))
+#define PERF_COUNT(stats,field,n) do { if (stats) (stats)->field+=(n); } while (0)
+#else
+#define PERF_SCOPE(stats) ((void) (stats))
+#define PERF_COUNT(stats,field,n) ((void) 0)
+#endif
+
+#endif
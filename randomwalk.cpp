@@ -0,0 +1,253 @@
+/*
+ * File: randomwalk.cpp
+ * --------------------
+ * This file implements the randomwalk.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include "error.h"
+#include "randomwalk.h"
+#include "splitmix.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: WalkRandom
+ * --------------------------------
+ * Every walk gets its own SplitMix64 stream, derived from the seed and the walk number in the same
+ * way as the edge streams of graphgen.cpp, so no generator is shared between threads.
+ */
+
+class WalkRandom
+{
+public:
+    WalkRandom(uint64_t seed,uint64_t number)
+    {
+        state=mix64(seed+mix64(number*0x9E3779B97F4A7C15ULL));
+    }
+
+    uint64_t next()
+    {
+        state+=0x9E3779B97F4A7C15ULL;
+        return mix64(state);
+    }
+
+    double uniform()
+    {
+        return (next()>>11)*(1.0/9007199254740992.0);
+    }
+
+    uint64_t below(uint64_t n)
+    {
+        return next()%n;
+    }
+
+private:
+    uint64_t state;
+};
+
+RandomWalker::RandomWalker(const CSRGraph & graph,const WalkOptions & options)
+    : graph(graph),options(options)
+{
+    if (options.p<=0||options.q<=0) error("RandomWalker: p and q must be positive");
+    if (options.weighted) buildAliasTables();
+}
+
+/*
+ * Implementation notes: buildAliasTables
+ * --------------------------------------
+ * The tables are built row by row with Vose's algorithm. The costs of a row are scaled so that
+ * they average 1; columns below 1 are paired with columns above 1, which give up the missing share
+ * and become their alias, until every column is full. Rounding leaves the last columns of either
+ * kind at probability 1. A row whose costs are all 0 is treated as uniform.
+ */
+
+void RandomWalker::buildAliasTables()
+{
+    TRACE_SCOPE("RandomWalker.alias");
+    size_t m=graph.arcCount();
+
+    for (double cost:graph.costs)
+    {
+        if (cost<0) error("RandomWalker: negative arc cost");
+    }
+    probability.resize(m);
+    alias.resize(m);
+    parallelFor(0,graph.nodeCount,[&](size_t first,size_t last)
+    {
+        std::vector<uint32_t> small,large;
+
+        for (size_t v=first;v<last;v++)
+        {
+            size_t base=graph.offsets[v];
+            size_t degree=graph.degree(v);
+            double total=0;
+
+            for (size_t i=0;i<degree;i++) total+=graph.costs[base+i];
+            small.clear();
+            large.clear();
+            for (size_t i=0;i<degree;i++)
+            {
+                double scaled=(total>0) ? graph.costs[base+i]*degree/total : 1.0;
+
+                probability[base+i]=scaled;
+                alias[base+i]=(uint32_t) i;
+                if (scaled<1) small.push_back((uint32_t) i);
+                else large.push_back((uint32_t) i);
+            }
+            while (!small.empty()&&!large.empty())
+            {
+                uint32_t s=small.back();
+                uint32_t l=large.back();
+
+                small.pop_back();
+                alias[base+s]=l;
+                probability[base+l]-=1-probability[base+s];
+                if (probability[base+l]<1)
+                {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+            for (uint32_t i:small) probability[base+i]=1;
+            for (uint32_t i:large) probability[base+i]=1;
+        }
+    },1024);
+}
+
+/*
+ * Implementation notes: walk
+ * --------------------------
+ * A first-order step draws an arc of the current node, uniformly or from its alias table. The
+ * node2vec bias is applied by rejection: a candidate is accepted with probability equal to its
+ * bias divided by the largest of 1/p, 1 and 1/q, which yields the second-order distribution without
+ * storing a table per arc. Whether a candidate is adjacent to the previous node is decided by binary
+ * search in the sorted row of that node.
+ */
+
+static size_t chooseArc(const CSRGraph & graph,const std::vector<double> & probability,
+                        const std::vector<uint32_t> & alias,uint32_t v,WalkRandom & rng)
+{
+    size_t base=graph.offsets[v];
+    size_t column=(size_t) rng.below(graph.degree(v));
+
+    if (probability.empty()||rng.uniform()<probability[base+column]) return base+column;
+    return base+alias[base+column];
+}
+
+static bool hasArc(const CSRGraph & graph,uint32_t from,uint32_t to)
+{
+    std::vector<uint32_t>::const_iterator first=graph.targets.begin()+graph.offsets[from];
+    std::vector<uint32_t>::const_iterator last=graph.targets.begin()+graph.offsets[from+1];
+
+    return std::binary_search(first,last,to);
+}
+
+void RandomWalker::walk(uint32_t start,uint64_t number,std::vector<uint32_t> & path) const
+{
+    if (start>=graph.nodeCount) error("RandomWalker: start node out of range");
+
+    WalkRandom rng(options.seed,number);
+    bool biased=(options.p!=1||options.q!=1);
+    double most=std::max(1.0,std::max(1/options.p,1/options.q));
+    uint32_t previous=NO_NODE;
+    uint32_t current=start;
+
+    path.clear();
+    path.push_back(start);
+    while (path.size()<options.length&&graph.degree(current)>0)
+    {
+        uint32_t next=graph.targets[chooseArc(graph,probability,alias,current,rng)];
+
+        if (biased&&previous!=NO_NODE)
+        {
+            while (true)
+            {
+                double bias=(next==previous) ? 1/options.p
+                          : hasArc(graph,previous,next) ? 1.0 : 1/options.q;
+
+                if (rng.uniform()*most<bias) break;
+                next=graph.targets[chooseArc(graph,probability,alias,current,rng)];
+            }
+        }
+        path.push_back(next);
+        previous=current;
+        current=next;
+    }
+}
+
+size_t RandomWalker::generate(const std::function<void(const std::vector<uint32_t> &)> & visit)
+    const
+{
+    TRACE_SCOPE("RandomWalker.generate");
+    size_t n=graph.nodeCount;
+    std::atomic<size_t> steps(0);
+
+    parallelFor(0,n*options.walksPerNode,[&](size_t first,size_t last)
+    {
+        std::vector<uint32_t> path;
+        size_t count=0;
+
+        for (size_t k=first;k<last;k++)
+        {
+            walk((uint32_t) (k%n),k,path);
+            count+=path.size()-1;
+            visit(path);
+        }
+        steps.fetch_add(count,std::memory_order_relaxed);
+    },64);
+    return steps.load(std::memory_order_relaxed);
+}
+
+/*
+ * Implementation notes: generate
+ * ------------------------------
+ * Each piece formats its walks into a private buffer and appends the buffer to the file under a
+ * lock whenever it grows past WALK_BUFFER bytes and once more when the piece ends, so the threads
+ * rarely wait for each other.
+ */
+
+const size_t WALK_BUFFER=1<<20;
+
+size_t RandomWalker::generate(const std::string & filename) const
+{
+    TRACE_SCOPE("RandomWalker.generate");
+    size_t n=graph.nodeCount;
+    std::ofstream out(filename.c_str());
+    std::mutex lock;
+    std::atomic<size_t> steps(0);
+
+    if (!out) error("RandomWalker: can't open " + filename);
+    parallelFor(0,n*options.walksPerNode,[&](size_t first,size_t last)
+    {
+        std::vector<uint32_t> path;
+        std::string buffer;
+        size_t count=0;
+
+        for (size_t k=first;k<last;k++)
+        {
+            walk((uint32_t) (k%n),k,path);
+            count+=path.size()-1;
+            for (size_t i=0;i<path.size();i++)
+            {
+                if (i>0) buffer+=' ';
+                buffer+=std::to_string(path[i]);
+            }
+            buffer+='\n';
+            if (buffer.size()>=WALK_BUFFER||k+1==last)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                out << buffer;
+                buffer.clear();
+            }
+        }
+        steps.fetch_add(count,std::memory_order_relaxed);
+    },64);
+    out.close();
+    if (!out) error("RandomWalker: can't write " + filename);
+    return steps.load(std::memory_order_relaxed);
+}
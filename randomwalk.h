@@ -0,0 +1,115 @@
+/*
+ * File: randomwalk.h
+ * ------------------
+ * This interface exports the RandomWalker class, which generates random walks over a graph in CSR
+ * form for embedding methods such as DeepWalk and node2vec. Walks may be uniform, weighted by arc
+ * cost, or biased by the node2vec return and in-out parameters.
+ */
+
+#ifndef _randomwalk_h
+#define _randomwalk_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: WalkOptions
+ * -----------------
+ * This type collects the settings of a RandomWalker. Every node starts walksPerNode walks of up to
+ * length nodes each. If weighted is true, a walk leaves a node along an arc with probability
+ * proportional to its cost, which must not be negative; otherwise all arcs are equally likely. The
+ * node2vec parameters p and q scale the chance of stepping back to the previous node by 1/p and of
+ * moving to a node not adjacent to the previous one by 1/q; with both 1 the walk is first-order.
+ */
+
+struct WalkOptions
+{
+    size_t length;                              /* Nodes per walk, including the start */
+    size_t walksPerNode;                        /* Walks started at every node */
+    bool weighted;                              /* Choose arcs in proportion to their cost */
+    double p;                                   /* node2vec return parameter */
+    double q;                                   /* node2vec in-out parameter */
+    unsigned long long seed;                    /* Seed from which every walk is derived */
+
+    WalkOptions() : length(80),walksPerNode(10),weighted(false),p(1),q(1),seed(1) {}
+};
+
+/*
+ * Class: RandomWalker
+ * -------------------
+ * This class samples walks from a graph, which must stay unchanged while the walker exists. Each
+ * walk draws its random numbers from its own stream, derived from the seed and the walk number, so
+ * the walks do not depend on the number of threads or the order in which they run.
+ */
+
+class RandomWalker
+{
+public:
+
+/*
+ * Constructor: RandomWalker
+ * Usage: RandomWalker walker(csr);
+ *        RandomWalker walker(csr,options);
+ * ----------------------------------------
+ * Prepares a walker for graph. Weighted walkers build an alias table for every node, in time and
+ * space linear in the number of arcs. The constructor signals an error if p or q is not positive
+ * or a weighted walker finds a negative cost.
+ */
+
+    explicit RandomWalker(const CSRGraph & graph,const WalkOptions & options=WalkOptions());
+
+/*
+ * Method: walk
+ * Usage: walker.walk(start,number,path);
+ * --------------------------------------
+ * Fills path with walk number number from start. The walk ends early at a node without outgoing
+ * arcs. The same start and number always produce the same walk.
+ */
+
+    void walk(uint32_t start,uint64_t number,std::vector<uint32_t> & path) const;
+
+/*
+ * Method: generate
+ * Usage: size_t steps=walker.generate(visit);
+ *        size_t steps=walker.generate(filename);
+ * ----------------------------------------------
+ * Generates walksPerNode walks from every node on the current thread pool and returns the total
+ * number of steps taken. The first form passes every walk to visit, which is called from several
+ * threads at once. The second form writes the walks to a text file, one per line with the node
+ * indices separated by spaces, and signals an error if the file cannot be written. In both forms
+ * the walks arrive in no particular order.
+ */
+
+    size_t generate(const std::function<void(const std::vector<uint32_t> &)> & visit) const;
+    size_t generate(const std::string & filename) const;
+
+private:
+
+/*
+ * Implementation notes: data structure
+ * ------------------------------------
+ * Weighted walks use Walker's alias method. For the arc at position i of its row, probability[i]
+ * is the chance of keeping that arc when its column is drawn, and alias[i] is the column taken
+ * otherwise, so a step costs one uniform column and one coin regardless of degree. Both arrays are
+ * parallel to graph.targets and stay empty for unweighted walkers.
+ */
+
+/* Instance variables */
+
+    const CSRGraph & graph;
+    WalkOptions options;
+    std::vector<double> probability;
+    std::vector<uint32_t> alias;
+
+/* Private method prototypes */
+
+    void buildAliasTables();
+    RandomWalker(const RandomWalker &);
+    RandomWalker & operator=(const RandomWalker &);
+};
+
+#endif
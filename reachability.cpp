@@ -0,0 +1,331 @@
+/*
+ * File: reachability.cpp
+ * ----------------------
+ * This file implements the reachability.h interface.
+ */
+
+#include <algorithm>
+#include <random>
+#include "error.h"
+#include "reachability.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: stronglyConnectedComponents
+ * -------------------------------------------------
+ * This is Tarjan's algorithm with the recursion replaced by an explicit stack of frames, each holding
+ * a node and the position of the next arc to examine, so that long paths cannot overflow the call
+ * stack. order[v] is the discovery number of v and low[v] the smallest discovery number reachable
+ * from the subtree of v through nodes still on the component stack. A node whose low equals its own
+ * number is the root of a component, which consists of the nodes above it on the component stack.
+ */
+
+size_t stronglyConnectedComponents(const CSRGraph & graph,std::vector<uint32_t> & component)
+{
+    TRACE_SCOPE("stronglyConnectedComponents");
+    size_t n=graph.nodeCount;
+    std::vector<uint32_t> order(n,NO_NODE);
+    std::vector<uint32_t> low(n);
+    std::vector<bool> onStack(n,false);
+    std::vector<uint32_t> members;
+    std::vector<std::pair<uint32_t,size_t> > frames;
+    uint32_t counter=0;
+    uint32_t count=0;
+
+    component.assign(n,NO_NODE);
+    for (uint32_t start=0;start<n;start++)
+    {
+        if (order[start]!=NO_NODE) continue;
+        order[start]=low[start]=counter++;
+        onStack[start]=true;
+        members.push_back(start);
+        frames.push_back(std::make_pair(start,graph.offsets[start]));
+        while (!frames.empty())
+        {
+            uint32_t v=frames.back().first;
+            size_t & next=frames.back().second;
+
+            if (next<graph.offsets[v+1])
+            {
+                uint32_t w=graph.targets[next++];
+
+                if (order[w]==NO_NODE)
+                {
+                    order[w]=low[w]=counter++;
+                    onStack[w]=true;
+                    members.push_back(w);
+                    frames.push_back(std::make_pair(w,graph.offsets[w]));
+                } else if (onStack[w])
+                {
+                    low[v]=std::min(low[v],order[w]);
+                }
+                continue;
+            }
+            frames.pop_back();
+            if (low[v]==order[v])
+            {
+                uint32_t w;
+
+                do
+                {
+                    w=members.back();
+                    members.pop_back();
+                    onStack[w]=false;
+                    component[w]=count;
+                } while (w!=v);
+                count++;
+            }
+            if (!frames.empty())
+            {
+                uint32_t u=frames.back().first;
+
+                low[u]=std::min(low[u],low[v]);
+            }
+        }
+    }
+    return count;
+}
+
+ReachabilityIndex::ReachabilityIndex(const CSRGraph & graph,int labels,unsigned long long seed)
+{
+    build(graph,labels,seed);
+}
+
+ReachabilityIndex::ReachabilityIndex(const SimpleGraph & graph,int labels,unsigned long long seed)
+{
+    CSRGraph csr;
+
+    buildCSR(graph,csr);
+    build(csr,labels,seed);
+    index.swap(csr.index);
+}
+
+void ReachabilityIndex::build(const CSRGraph & graph,int labels,unsigned long long seed)
+{
+    TRACE_SCOPE("ReachabilityIndex::build");
+
+    if (labels<1) error("ReachabilityIndex: at least one label is required");
+    k=labels;
+
+    size_t count=stronglyConnectedComponents(graph,component);
+
+    condense(graph,count);
+    label(seed);
+}
+
+/*
+ * Implementation notes: condense
+ * ------------------------------
+ * The nodes are bucketed by component with a counting sort, and the arcs of each component are then
+ * collected in one pass. mark remembers the last component that added an arc to each target, which
+ * removes duplicate arcs without sorting, so the whole step takes linear time.
+ */
+
+void ReachabilityIndex::condense(const CSRGraph & graph,size_t count)
+{
+    TRACE_SCOPE("ReachabilityIndex::condense");
+    std::vector<size_t> start(count+1,0);
+    std::vector<uint32_t> members(graph.nodeCount);
+    std::vector<uint32_t> mark(count,NO_NODE);
+
+    for (uint32_t c:component) start[c+1]++;
+    for (size_t c=0;c<count;c++) start[c+1]+=start[c];
+    {
+        std::vector<size_t> fill(start.begin(),start.end()-1);
+
+        for (uint32_t v=0;v<graph.nodeCount;v++) members[fill[component[v]]++]=v;
+    }
+    dag=CSRGraph();
+    dag.nodeCount=count;
+    dag.offsets.assign(count+1,0);
+    for (uint32_t c=0;c<count;c++)
+    {
+        for (size_t m=start[c];m<start[c+1];m++)
+        {
+            uint32_t v=members[m];
+
+            for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+            {
+                uint32_t d=component[graph.targets[i]];
+
+                if (d!=c&&mark[d]!=c)
+                {
+                    mark[d]=c;
+                    dag.targets.push_back(d);
+                }
+            }
+        }
+        dag.offsets[c+1]=dag.targets.size();
+    }
+    dag.costs.assign(dag.targets.size(),1.0);
+    sortArcs(dag,0,count);
+}
+
+/*
+ * Implementation notes: label
+ * ---------------------------
+ * Every traversal starts from the components without incoming arcs, taken in a random order, and
+ * visits the children of each component starting at a random arc and wrapping around, which
+ * randomizes the order at no cost. Because the graph is acyclic, a child that was already visited
+ * is finished, and its low number can be used at once.
+ */
+
+void ReachabilityIndex::label(unsigned long long seed)
+{
+    TRACE_SCOPE("ReachabilityIndex::label");
+    size_t n=dag.nodeCount;
+    std::vector<bool> hasParent(n,false);
+    std::vector<uint32_t> roots;
+    std::vector<bool> visited;
+    std::vector<uint32_t> low(n);
+    std::vector<size_t> frameStart,frameStep;
+    std::vector<uint32_t> frameNode;
+
+    labels.resize(n*k);
+    for (uint32_t target:dag.targets) hasParent[target]=true;
+    for (uint32_t c=0;c<n;c++)
+    {
+        if (!hasParent[c]) roots.push_back(c);
+    }
+    for (int t=0;t<k;t++)
+    {
+        std::mt19937_64 rng(seed+t);
+        uint32_t post=0;
+
+        std::shuffle(roots.begin(),roots.end(),rng);
+        visited.assign(n,false);
+        for (uint32_t root:roots)
+        {
+            visited[root]=true;
+            low[root]=NO_NODE;
+            frameNode.push_back(root);
+            frameStart.push_back(dag.degree(root)>0 ? rng()%dag.degree(root) : 0);
+            frameStep.push_back(0);
+            while (!frameNode.empty())
+            {
+                uint32_t c=frameNode.back();
+                size_t degree=dag.degree(c);
+
+                if (frameStep.back()<degree)
+                {
+                    size_t offset=(frameStart.back()+frameStep.back()++)%degree;
+                    uint32_t child=dag.targets[dag.offsets[c]+offset];
+
+                    if (visited[child])
+                    {
+                        low[c]=std::min(low[c],low[child]);
+                        continue;
+                    }
+                    visited[child]=true;
+                    low[child]=NO_NODE;
+                    frameNode.push_back(child);
+                    frameStart.push_back(dag.degree(child)>0 ? rng()%dag.degree(child) : 0);
+                    frameStep.push_back(0);
+                    continue;
+                }
+                frameNode.pop_back();
+                frameStart.pop_back();
+                frameStep.pop_back();
+                low[c]=std::min(low[c],post);
+                labels[c*k+t].low=low[c];
+                labels[c*k+t].post=post++;
+                if (!frameNode.empty())
+                {
+                    uint32_t parent=frameNode.back();
+
+                    low[parent]=std::min(low[parent],low[c]);
+                }
+            }
+        }
+    }
+}
+
+bool ReachabilityIndex::contains(uint32_t outer,uint32_t inner) const
+{
+    const interval * a=&labels[(size_t) outer*k];
+    const interval * b=&labels[(size_t) inner*k];
+
+    for (int t=0;t<k;t++)
+    {
+        if (b[t].low<a[t].low||b[t].post>a[t].post) return false;
+    }
+    return true;
+}
+
+/*
+ * Implementation notes: canReach
+ * ------------------------------
+ * Queries that the component numbers and labels cannot decide fall back to a depth-first search of
+ * the condensed graph that enters only components whose labels contain those of the target. The
+ * visited marks of the search live in thread-local storage and are stamped with a per-thread query
+ * number, so a query neither allocates nor clears anything after the first one on its thread.
+ */
+
+bool ReachabilityIndex::canReach(uint32_t from,uint32_t to) const
+{
+    if (from>=component.size()||to>=component.size())
+    {
+        error("ReachabilityIndex: node out of range");
+    }
+
+    uint32_t source=component[from];
+    uint32_t target=component[to];
+
+    if (source==target) return true;
+    if (source<target||!contains(source,target)) return false;
+
+    thread_local std::vector<uint32_t> stamp;
+    thread_local std::vector<uint32_t> stack;
+    thread_local uint32_t epoch=0;
+
+    if (stamp.size()<dag.nodeCount) stamp.resize(dag.nodeCount,0);
+    if (++epoch==0)
+    {
+        std::fill(stamp.begin(),stamp.end(),0);
+        epoch=1;
+    }
+    stack.clear();
+    stack.push_back(source);
+    stamp[source]=epoch;
+    while (!stack.empty())
+    {
+        uint32_t c=stack.back();
+
+        stack.pop_back();
+        for (size_t i=dag.offsets[c];i<dag.offsets[c+1];i++)
+        {
+            uint32_t child=dag.targets[i];
+
+            if (child==target) return true;
+            if (stamp[child]==epoch||child<target||!contains(child,target)) continue;
+            stamp[child]=epoch;
+            stack.push_back(child);
+        }
+    }
+    return false;
+}
+
+bool ReachabilityIndex::canReach(Node * from,Node * to) const
+{
+    std::unordered_map<Node *,uint32_t>::const_iterator a=index.find(from);
+    std::unordered_map<Node *,uint32_t>::const_iterator b=index.find(to);
+
+    if (a==index.end()||b==index.end()) error("ReachabilityIndex: node not in graph");
+    return canReach(a->second,b->second);
+}
+
+size_t ReachabilityIndex::nodeCount() const
+{
+    return component.size();
+}
+
+size_t ReachabilityIndex::componentCount() const
+{
+    return dag.nodeCount;
+}
+
+uint32_t ReachabilityIndex::componentOf(uint32_t v) const
+{
+    if (v>=component.size()) error("ReachabilityIndex: node out of range");
+    return component[v];
+}
@@ -0,0 +1,113 @@
+/*
+ * File: reachability.h
+ * --------------------
+ * This interface exports strongly connected components and the ReachabilityIndex class, which
+ * answers "can X reach Y?" without searching the graph in most cases.
+ */
+
+#ifndef _reachability_h
+#define _reachability_h
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Function: stronglyConnectedComponents
+ * Usage: size_t count=stronglyConnectedComponents(csr,component);
+ * ---------------------------------------------------------------
+ * Labels every node with its strongly connected component and returns the number of components.
+ * The components are numbered in reverse topological order: if an arc leads from component a to
+ * another component b, then a>b.
+ */
+
+size_t stronglyConnectedComponents(const CSRGraph & graph,std::vector<uint32_t> & component);
+
+/*
+ * Class: ReachabilityIndex
+ * ------------------------
+ * This class answers reachability queries on a fixed graph. It condenses every strongly connected
+ * component into a single node and labels the resulting acyclic graph so that most queries whose
+ * answer is "no" are settled by comparing labels, and the rest by a search that the labels prune.
+ * Queries may be made from several threads at once. The index does not see later changes to the
+ * graph.
+ */
+
+class ReachabilityIndex
+{
+public:
+
+/*
+ * Constructor: ReachabilityIndex
+ * Usage: ReachabilityIndex index(csr);
+ *        ReachabilityIndex index(graph,labels,seed);
+ * --------------------------------------------------
+ * Builds the index in time proportional to labels times the size of the graph. More labels answer
+ * more negative queries without a search; five is a good default. The seed makes the labels
+ * reproducible.
+ */
+
+    explicit ReachabilityIndex(const CSRGraph & graph,int labels=5,unsigned long long seed=1);
+    explicit ReachabilityIndex(const SimpleGraph & graph,int labels=5,unsigned long long seed=1);
+
+/*
+ * Method: canReach
+ * Usage: if (index.canReach(from,to)) . . .
+ * -----------------------------------------
+ * Returns true if there is a path from from to to. Every node reaches itself. The Node form
+ * requires an index built from a SimpleGraph and signals an error for nodes not in it.
+ */
+
+    bool canReach(uint32_t from,uint32_t to) const;
+    bool canReach(Node * from,Node * to) const;
+
+/*
+ * Methods: nodeCount, componentCount, componentOf
+ * Usage: uint32_t c=index.componentOf(v);
+ * ---------------------------------------
+ * Return the number of nodes, the number of strongly connected components, and the component of v.
+ */
+
+    size_t nodeCount() const;
+    size_t componentCount() const;
+    uint32_t componentOf(uint32_t v) const;
+
+private:
+
+/*
+ * Implementation notes: data structure
+ * ------------------------------------
+ * The index follows GRAIL (Yildirim, Chaoji and Zaki). Each of k randomized depth-first traversals
+ * of the condensed graph numbers the components in postorder and gives component c the interval
+ * [low,post], where post is its own number and low the smallest number among its descendants. If a
+ * reaches b, every interval of b lies within the corresponding interval of a, so a single interval
+ * that does not nest proves that b is unreachable. The intervals of one component are stored
+ * together, so a query reads two short runs of memory. Component numbers add a second free test:
+ * they are a reverse topological order, so a can only reach components with smaller numbers.
+ */
+
+    struct interval
+    {
+        uint32_t low;
+        uint32_t post;
+    };
+
+/* Instance variables */
+
+    int k;                                      /* Intervals per component */
+    std::vector<uint32_t> component;            /* Component of every node */
+    CSRGraph dag;                               /* Condensed graph, one node per component */
+    std::vector<interval> labels;               /* k intervals per component */
+    std::unordered_map<Node *,uint32_t> index;  /* Node numbers when built from a SimpleGraph */
+
+/* Private method prototypes */
+
+    void build(const CSRGraph & graph,int labels,unsigned long long seed);
+    void condense(const CSRGraph & graph,size_t count);
+    void label(unsigned long long seed);
+    bool contains(uint32_t outer,uint32_t inner) const;
+};
+
+#endif
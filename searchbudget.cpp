@@ -0,0 +1,108 @@
+/*
+ * File: searchbudget.cpp
+ * ----------------------
+ * This file implements the searchbudget.h interface.
+ */
+
+#include <algorithm>
+#include "searchbudget.h"
+
+const char * statusName(SearchStatus status)
+{
+    switch (status)
+    {
+    case SEARCH_COMPLETE:
+        return "complete";
+    case SEARCH_CANCELLED:
+        return "cancelled";
+    case SEARCH_DEADLINE:
+        return "deadline";
+    case SEARCH_WORK_LIMIT:
+        return "work_limit";
+    default:
+        return "unknown";
+    }
+}
+
+SearchBudget::SearchBudget() : token(NULL),hasDeadline(false),workLimit(0),interval(4096),work(0),
+    state(SEARCH_COMPLETE)
+{}
+
+SearchBudget::SearchBudget(const SearchBudget & other) : token(other.token),
+    hasDeadline(other.hasDeadline),deadline(other.deadline),workLimit(other.workLimit),
+    interval(other.interval),work(other.work.load()),state(other.state.load())
+{}
+
+SearchBudget & SearchBudget::operator=(const SearchBudget & other)
+{
+    token=other.token;
+    hasDeadline=other.hasDeadline;
+    deadline=other.deadline;
+    workLimit=other.workLimit;
+    interval=other.interval;
+    work.store(other.work.load());
+    state.store(other.state.load());
+    return *this;
+}
+
+void SearchBudget::setToken(CancellationToken * token)
+{
+    this->token=token;
+}
+
+void SearchBudget::setDeadline(Clock::time_point deadline)
+{
+    this->deadline=deadline;
+    hasDeadline=true;
+}
+
+void SearchBudget::setTimeLimit(Clock::duration limit)
+{
+    setDeadline(Clock::now()+limit);
+}
+
+void SearchBudget::setWorkLimit(size_t limit)
+{
+    workLimit=limit;
+}
+
+void SearchBudget::setCheckInterval(size_t interval)
+{
+    this->interval=std::max<size_t>(1,interval);
+}
+
+/*
+ * Implementation notes: charge
+ * ----------------------------
+ * The limits are tested from cheapest to dearest, so the clock is read only when the token and the
+ * work limit allow the search to go on. The first thread to find a limit exceeded records it; later
+ * reasons do not overwrite it.
+ */
+
+bool SearchBudget::charge(size_t amount)
+{
+    size_t total=work.fetch_add(amount,std::memory_order_relaxed)+amount;
+    int reason=SEARCH_COMPLETE;
+
+    if (state.load(std::memory_order_relaxed)!=SEARCH_COMPLETE) return false;
+    if (token!=NULL&&token->isCancelled()) reason=SEARCH_CANCELLED;
+    else if (workLimit>0&&total>workLimit) reason=SEARCH_WORK_LIMIT;
+    else if (hasDeadline&&Clock::now()>=deadline) reason=SEARCH_DEADLINE;
+    if (reason==SEARCH_COMPLETE) return true;
+
+    int expected=SEARCH_COMPLETE;
+
+    state.compare_exchange_strong(expected,reason,std::memory_order_relaxed);
+    return false;
+}
+
+void SearchBudget::record(size_t amount)
+{
+    work.fetch_add(amount,std::memory_order_relaxed);
+}
+
+void SearchBudget::reset()
+{
+    work.store(0,std::memory_order_relaxed);
+    state.store(SEARCH_COMPLETE,std::memory_order_relaxed);
+}
@@ -0,0 +1,211 @@
+/*
+ * File: searchbudget.h
+ * --------------------
+ * This interface exports the types that let a caller bound the cost of a traversal or shortest-path
+ * search. A SearchBudget combines an optional cancellation token, deadline and work limit, where work
+ * is measured in nodes plus arcs examined. Engines do not consult the budget on every step: they
+ * accumulate work in a BudgetMeter and report it once checkInterval units have built up, so an
+ * unlimited or generous budget costs almost nothing. When the budget runs out the engine stops and returns what
+ * it has found so far, and status tells the caller why the search ended.
+ */
+
+#ifndef _searchbudget_h
+#define _searchbudget_h
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/*
+ * Type: SearchStatus
+ * ------------------
+ * The reason a search ended. SEARCH_COMPLETE means the engine finished normally; the other values
+ * mean the result is partial.
+ */
+
+enum SearchStatus { SEARCH_COMPLETE, SEARCH_CANCELLED, SEARCH_DEADLINE, SEARCH_WORK_LIMIT };
+
+/*
+ * Function: statusName
+ * Usage: string name=statusName(status);
+ * --------------------------------------
+ * Returns a lower-case name for status, such as "deadline".
+ */
+
+const char * statusName(SearchStatus status);
+
+/*
+ * Class: CancellationToken
+ * ------------------------
+ * A flag that one thread raises to ask searches running on other threads to stop. The same token
+ * may be shared by any number of budgets.
+ */
+
+class CancellationToken
+{
+public:
+    CancellationToken() : cancelled(false) {}
+
+    void cancel() { cancelled.store(true,std::memory_order_relaxed); }
+    void reset() { cancelled.store(false,std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled;
+
+    CancellationToken(const CancellationToken &);
+    CancellationToken & operator=(const CancellationToken &);
+};
+
+/*
+ * Class: SearchBudget
+ * -------------------
+ * This class holds the limits of one search and the work charged against them. A new budget is
+ * unlimited. Work may be charged from several threads at once. Copying a budget copies its limits and
+ * its token pointer together with the work spent so far; reset starts the count again.
+ */
+
+class SearchBudget
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    SearchBudget();
+    SearchBudget(const SearchBudget & other);
+    SearchBudget & operator=(const SearchBudget & other);
+
+/*
+ * Methods: setToken, setDeadline, setTimeLimit, setWorkLimit, setCheckInterval
+ * Usage: budget.setToken(&token);
+ *        budget.setDeadline(when);
+ *        budget.setTimeLimit(std::chrono::milliseconds(5));
+ *        budget.setWorkLimit(1000000);
+ *        budget.setCheckInterval(256);
+ * -------------------------------------------------------------
+ * Set the limits. setTimeLimit sets the deadline relative to now. A search may spend exactly its
+ * work limit; only more work exhausts the budget. A work limit of 0 means no limit.
+ * The check interval is the amount of work an engine does between checks; the default of 4096 keeps
+ * the cost of reading the clock negligible while reacting within microseconds.
+ */
+
+    void setToken(CancellationToken * token);
+    void setDeadline(Clock::time_point deadline);
+    void setTimeLimit(Clock::duration limit);
+    void setWorkLimit(size_t limit);
+    void setCheckInterval(size_t interval);
+
+/*
+ * Method: charge
+ * Usage: if (!budget.charge(work)) . . .
+ * --------------------------------------
+ * Adds work to the amount spent and checks every limit. Returns false, and records the reason, if the
+ * search must stop. Once a budget is exhausted it stays exhausted until reset.
+ */
+
+    bool charge(size_t work);
+
+/*
+ * Method: record
+ * Usage: budget.record(work);
+ * ---------------------------
+ * Adds work to the amount spent without checking the limits. Engines use it to account for work done
+ * after the last check of a search that has already finished.
+ */
+
+    void record(size_t work);
+
+/*
+ * Methods: isExhausted, status, spent, checkInterval
+ * Usage: if (budget.isExhausted()) . . .
+ * --------------------------------------
+ * Report the state of the budget: whether a limit was hit, which one (SEARCH_COMPLETE if none), the
+ * work charged so far and the check interval.
+ */
+
+    bool isExhausted() const { return state.load(std::memory_order_relaxed)!=SEARCH_COMPLETE; }
+    SearchStatus status() const { return (SearchStatus) state.load(std::memory_order_relaxed); }
+    size_t spent() const { return work.load(std::memory_order_relaxed); }
+    size_t checkInterval() const { return interval; }
+
+/*
+ * Method: reset
+ * Usage: budget.reset();
+ * ----------------------
+ * Clears the work spent and the status, keeping the limits.
+ */
+
+    void reset();
+
+private:
+    CancellationToken * token;
+    bool hasDeadline;
+    Clock::time_point deadline;
+    size_t workLimit;
+    size_t interval;
+    std::atomic<size_t> work;
+    std::atomic<int> state;
+};
+
+/*
+ * Class: BudgetMeter
+ * ------------------
+ * This class is the engine side of a budget. An engine calls tick once per node with the work done
+ * on that node; the meter charges the budget only when checkInterval units of work have built up, so
+ * a search overshoots its work limit by at most one interval plus the degree of one node. A meter
+ * for a NULL budget never stops the search. Each thread of a parallel engine uses its own meter.
+ */
+
+class BudgetMeter
+{
+public:
+    explicit BudgetMeter(SearchBudget * budget) : budget(budget),pending(0),
+        interval((budget!=NULL) ? budget->checkInterval() : 0)
+    {}
+
+    ~BudgetMeter()
+    {
+        if (budget!=NULL&&pending>0) budget->record(pending);
+    }
+
+/*
+ * Method: tick
+ * Usage: if (!meter.tick(work)) break;
+ * ------------------------------------
+ * Records the work of one node. Returns false if the search must stop.
+ */
+
+    bool tick(size_t work)
+    {
+        if (budget==NULL) return true;
+        pending+=work;
+        if (pending<interval) return true;
+        return flush();
+    }
+
+/*
+ * Method: flush
+ * Usage: if (!meter.flush()) break;
+ * ---------------------------------
+ * Charges the work recorded so far and returns false if the search must stop.
+ */
+
+    bool flush()
+    {
+        if (budget==NULL) return true;
+
+        bool more=budget->charge(pending);
+
+        pending=0;
+        return more;
+    }
+
+private:
+    SearchBudget * budget;
+    size_t pending;
+    size_t interval;
+
+    BudgetMeter(const BudgetMeter &);
+    BudgetMeter & operator=(const BudgetMeter &);
+};
+
+#endif
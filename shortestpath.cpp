@@ -0,0 +1,154 @@
+/*
+ * File: shortestpath.cpp
+ * ----------------------
+ * This file implements the shortestpath.h interface.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include "error.h"
+#include "shortestpath.h"
+#include "threadpool.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: dijkstra
+ * ------------------------------
+ * The search keeps (distance, node) pairs in a binary heap from the standard library rather than the
+ * assignment's PriorityQueue, whose enqueue reads the process CPU clock to stamp every entry. Because
+ * the heap has no decrease-key operation, a node is pushed again whenever its distance improves,
+ * and stale entries are recognized on removal by the settled flag. If finish is not NO_NODE, the
+ * search stops when finish is settled. If the budget runs out first, the tentative distances of
+ * unsettled nodes are discarded, so distance and parent describe exactly the settled nodes.
+ */
+
+typedef std::pair<double,uint32_t> HeapEntry;
+
+static void dijkstra(const CSRGraph & graph,uint32_t start,uint32_t finish,
+                     std::vector<double> & distance,std::vector<uint32_t> & parent,
+                     SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("shortestPath: start node out of range");
+
+    std::priority_queue<HeapEntry,std::vector<HeapEntry>,std::greater<HeapEntry> > heap;
+    std::vector<bool> settled;
+    BudgetMeter meter(budget);
+    bool stopped=false;
+
+    {
+        TRACE_SCOPE("dijkstra.init");
+        distance.assign(graph.nodeCount,UNREACHABLE);
+        parent.assign(graph.nodeCount,NO_NODE);
+        settled.assign(graph.nodeCount,false);
+    }
+    TRACE_SCOPE("dijkstra.search");
+    distance[start]=0;
+    heap.push(HeapEntry(0,start));
+    while (!heap.empty())
+    {
+        uint32_t city=heap.top().second;
+
+        heap.pop();
+        if (settled[city]) continue;
+        settled[city]=true;
+        if (city==finish) break;
+        for (size_t i=graph.offsets[city];i<graph.offsets[city+1];i++)
+        {
+            uint32_t link=graph.targets[i];
+            double d=distance[city]+graph.costs[i];
+
+            if (!settled[link]&&(distance[link]==UNREACHABLE||d<distance[link]))
+            {
+                distance[link]=d;
+                parent[link]=city;
+                heap.push(HeapEntry(d,link));
+            }
+        }
+        if (!meter.tick(1+graph.degree(city)))
+        {
+            stopped=true;
+            break;
+        }
+    }
+    if (stopped)
+    {
+        for (size_t v=0;v<graph.nodeCount;v++)
+        {
+            if (!settled[v])
+            {
+                distance[v]=UNREACHABLE;
+                parent[v]=NO_NODE;
+            }
+        }
+    }
+}
+
+void shortestPathTree(const CSRGraph & graph,uint32_t start,std::vector<double> & distance,
+                      std::vector<uint32_t> & parent,SearchBudget * budget)
+{
+    TRACE_SCOPE("shortestPathTree");
+    dijkstra(graph,start,NO_NODE,distance,parent,budget);
+}
+
+double findShortestPath(const CSRGraph & graph,uint32_t start,uint32_t finish,
+                        std::vector<uint32_t> * path,SearchBudget * budget)
+{
+    TRACE_SCOPE("findShortestPath");
+    std::vector<double> distance;
+    std::vector<uint32_t> parent;
+
+    if (finish>=graph.nodeCount) error("findShortestPath: finish node out of range");
+    dijkstra(graph,start,finish,distance,parent,budget);
+    if (path!=NULL)
+    {
+        TRACE_SCOPE("dijkstra.path");
+
+        path->clear();
+        if (distance[finish]!=UNREACHABLE)
+        {
+            for (uint32_t v=finish;v!=NO_NODE;v=parent[v])
+            {
+                path->push_back(v);
+            }
+            std::reverse(path->begin(),path->end());
+        }
+    }
+    return distance[finish];
+}
+
+/*
+ * Implementation notes: findShortestPaths
+ * ---------------------------------------
+ * Every query is a separate task, because the cost of a query varies too much to group them. Each
+ * query charges a private copy of limits, so one expensive query cannot starve the others.
+ */
+
+void findShortestPaths(const CSRGraph & graph,const std::vector<uint32_t> & starts,
+                       const std::vector<uint32_t> & finishes,std::vector<double> & costs,
+                       const SearchBudget * limits,std::vector<SearchStatus> * statuses)
+{
+    TRACE_SCOPE_VALUE("findShortestPaths",starts.size());
+
+    if (starts.size()!=finishes.size()) error("findShortestPaths: starts and finishes differ in length");
+    costs.assign(starts.size(),UNREACHABLE);
+    if (statuses!=NULL) statuses->assign(starts.size(),SEARCH_COMPLETE);
+    parallelFor(0,starts.size(),[&](size_t first,size_t last)
+    {
+        for (size_t i=first;i<last;i++)
+        {
+            if (limits==NULL)
+            {
+                costs[i]=findShortestPath(graph,starts[i],finishes[i]);
+                continue;
+            }
+
+            SearchBudget budget(*limits);
+
+            budget.reset();
+            costs[i]=findShortestPath(graph,starts[i],finishes[i],NULL,&budget);
+            if (statuses!=NULL) (*statuses)[i]=budget.status();
+        }
+    },1);
+}
@@ -0,0 +1,63 @@
+/*
+ * File: shortestpath.h
+ * --------------------
+ * This interface exports Dijkstra's shortest-path algorithm for graphs in CSR form.
+ */
+
+#ifndef _shortestpath_h
+#define _shortestpath_h
+
+#include <cstdint>
+#include <vector>
+#include "csrgraph.h"
+#include "searchbudget.h"
+
+/*
+ * Constant: UNREACHABLE
+ * ---------------------
+ * The distance reported for a node that cannot be reached.
+ */
+
+const double UNREACHABLE=-1.0;
+
+/*
+ * Function: shortestPathTree
+ * Usage: shortestPathTree(csr,start,distance,parent);
+ * ---------------------------------------------------
+ * Computes the cost of the cheapest path from start to every node. On return distance[v] holds that
+ * cost (UNREACHABLE if there is none) and parent[v] the node preceding v on the path (NO_NODE if v is
+ * start or unreached). Arc costs must not be negative. If budget is not NULL and runs out, the search
+ * stops and the result covers only the nodes whose distance was final at that point.
+ */
+
+void shortestPathTree(const CSRGraph & graph,uint32_t start,std::vector<double> & distance,
+                      std::vector<uint32_t> & parent,SearchBudget * budget=NULL);
+
+/*
+ * Function: findShortestPath
+ * Usage: double cost=findShortestPath(csr,start,finish,path);
+ * -----------------------------------------------------------
+ * Returns the cost of the cheapest path from start to finish, or UNREACHABLE. The search stops as
+ * soon as finish is settled. If path is not NULL, it receives the nodes of the path from start to
+ * finish (empty if there is none). If the budget runs out before finish is reached, the result is
+ * UNREACHABLE and budget->status() reports why.
+ */
+
+double findShortestPath(const CSRGraph & graph,uint32_t start,uint32_t finish,
+                        std::vector<uint32_t> * path=NULL,SearchBudget * budget=NULL);
+
+/*
+ * Function: findShortestPaths
+ * Usage: findShortestPaths(csr,starts,finishes,costs);
+ *        findShortestPaths(csr,starts,finishes,costs,&limits,&statuses);
+ * ----------------------------------------------------
+ * Answers a batch of queries in parallel on the current thread pool. On return costs[i] holds
+ * findShortestPath(csr,starts[i],finishes[i]). If limits is not NULL, every query runs under a fresh
+ * copy of it, and statuses, if not NULL, receives the status of each query.
+ */
+
+void findShortestPaths(const CSRGraph & graph,const std::vector<uint32_t> & starts,
+                       const std::vector<uint32_t> & finishes,std::vector<double> & costs,
+                       const SearchBudget * limits=NULL,std::vector<SearchStatus> * statuses=NULL);
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * File: splitmix.h
+ * ----------------
+ * This interface exports mix64, the finalizer of the SplitMix64 generator. It turns any 64-bit value
+ * into a well-scrambled one, which is all the parallel algorithms need to derive an independent
+ * random stream or hash from a seed and a node, edge or walk number without sharing a generator
+ * between threads.
+ */
+
+#ifndef _splitmix_h
+#define _splitmix_h
+
+#include <cstdint>
+
+/*
+ * Function: mix64
+ * Usage: uint64_t h=mix64(x);
+ * ---------------------------
+ * Returns a bijective hash of x in which every bit of the result depends on every bit of x.
+ */
+
+inline uint64_t mix64(uint64_t x)
+{
+    x=(x^(x>>30))*0xBF58476D1CE4E5B9ULL;
+    x=(x^(x>>27))*0x94D049BB133111EBULL;
+    return x^(x>>31);
+}
+
+#endif
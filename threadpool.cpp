@@ -0,0 +1,469 @@
+/*
+ * File: threadpool.cpp
+ * --------------------
+ * This file implements the threadpool.h interface.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "error.h"
+#include "threadpool.h"
+
+/*
+ * Type: Task
+ * ----------
+ * A scheduled unit of work and the group that waits for it.
+ */
+
+struct Task
+{
+    std::function<void()> body;
+    TaskGroup * group;
+};
+
+/*
+ * Implementation notes: WorkDeque
+ * -------------------------------
+ * This is the Chase-Lev deque in the formulation of Le, Pop, Cohen and Zappa Nardelli for the C11
+ * memory model. Only the owner calls push and pop, which work at the bottom; any thread may call
+ * steal, which takes from the top. The owner and a thief contend only for the last task, and settle
+ * it with a compare-and-swap on top. When the ring fills up, the owner copies it into one twice as
+ * large; the old ring is kept until the deque is destroyed, because a thief may still be reading it.
+ * Slots are written with release and read with acquire semantics; this costs nothing on x86 and
+ * lets ThreadSanitizer, which ignores fences, see that a stolen task was published.
+ */
+
+class WorkDeque
+{
+public:
+    WorkDeque() : top(0),bottom(0),ring(new Ring(64))
+    {}
+
+    ~WorkDeque()
+    {
+        delete ring.load(std::memory_order_relaxed);
+        for (Ring * old:retired) delete old;
+    }
+
+    void push(Task * task)
+    {
+        int64_t b=bottom.load(std::memory_order_relaxed);
+        int64_t t=top.load(std::memory_order_acquire);
+        Ring * r=ring.load(std::memory_order_relaxed);
+
+        if (b-t>r->capacity-1)
+        {
+            retired.push_back(r);
+            r=r->grow(t,b);
+            ring.store(r,std::memory_order_release);
+        }
+        r->put(b,task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b+1,std::memory_order_relaxed);
+    }
+
+    Task * pop()
+    {
+        int64_t b=bottom.load(std::memory_order_relaxed)-1;
+        Ring * r=ring.load(std::memory_order_relaxed);
+
+        bottom.store(b,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int64_t t=top.load(std::memory_order_relaxed);
+        Task * task=NULL;
+
+        if (t<=b)
+        {
+            task=r->get(b);
+            if (t==b)
+            {
+                if (!top.compare_exchange_strong(t,t+1,std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed))
+                {
+                    task=NULL;
+                }
+                bottom.store(b+1,std::memory_order_relaxed);
+            }
+        } else
+        {
+            bottom.store(b+1,std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task * steal()
+    {
+        int64_t t=top.load(std::memory_order_acquire);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int64_t b=bottom.load(std::memory_order_acquire);
+
+        if (t>=b) return NULL;
+
+        Ring * r=ring.load(std::memory_order_acquire);
+        Task * task=r->get(t);
+
+        if (!top.compare_exchange_strong(t,t+1,std::memory_order_seq_cst,std::memory_order_relaxed))
+        {
+            return NULL;
+        }
+        return task;
+    }
+
+    bool empty() const
+    {
+        return bottom.load(std::memory_order_relaxed)<=top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Ring
+    {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<Task *>[]> slots;
+
+        explicit Ring(int64_t capacity) : capacity(capacity),slots(new std::atomic<Task *>[capacity])
+        {}
+
+        Task * get(int64_t i) const
+        {
+            return slots[i&(capacity-1)].load(std::memory_order_acquire);
+        }
+
+        void put(int64_t i,Task * task)
+        {
+            slots[i&(capacity-1)].store(task,std::memory_order_release);
+        }
+
+        Ring * grow(int64_t t,int64_t b) const
+        {
+            Ring * bigger=new Ring(2*capacity);
+
+            for (int64_t i=t;i<b;i++) bigger->put(i,get(i));
+            return bigger;
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Ring *> ring;
+    std::vector<Ring *> retired;
+};
+
+/* The pool and deque index of the calling thread, if it is a worker */
+
+static thread_local ThreadPool * workerPool=NULL;
+static thread_local int workerIndex=-1;
+
+static std::mutex sharedLock;
+static std::unique_ptr<ThreadPool> sharedPool;
+static int sharedThreads=0;
+
+static int resolveThreads(int threads)
+{
+    return (threads>0) ? threads : std::max(1u,std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(int threads) : threads(resolveThreads(threads)),queued(0),sleepers(0),
+    stopping(false)
+{
+    for (int i=0;i<this->threads-1;i++) deques.push_back(new WorkDeque);
+    for (int i=0;i<this->threads-1;i++) workers.push_back(std::thread(&ThreadPool::workerLoop,this,i));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+
+        stopping.store(true);
+        wakeup.notify_all();
+    }
+    for (std::thread & worker:workers) worker.join();
+    for (WorkDeque * deque:deques) delete deque;
+    for (Task * task:injected) delete task;
+}
+
+int ThreadPool::size() const
+{
+    return threads;
+}
+
+ThreadPool & ThreadPool::shared()
+{
+    std::lock_guard<std::mutex> lock(sharedLock);
+
+    if (!sharedPool) sharedPool.reset(new ThreadPool(sharedThreads));
+    return *sharedPool;
+}
+
+ThreadPool & ThreadPool::current()
+{
+    return (workerPool!=NULL) ? *workerPool : shared();
+}
+
+void ThreadPool::setSharedThreads(int threads)
+{
+    std::lock_guard<std::mutex> lock(sharedLock);
+
+    if (sharedPool&&sharedPool->size()!=resolveThreads(threads))
+    {
+        error("ThreadPool: shared pool already started with another size");
+    }
+    sharedThreads=threads;
+}
+
+/*
+ * Implementation notes: submit and sleeping
+ * -----------------------------------------
+ * A worker pushes onto its own deque; other threads append to the injection queue. queued counts
+ * tasks that have been submitted but not yet taken. An idle worker registers in sleepers and then
+ * rechecks queued under sleepLock before waiting, while a submitter increments queued before it
+ * reads sleepers; with sequentially consistent operations at least one of them sees the other, so
+ * no wake-up is lost.
+ */
+
+void ThreadPool::submit(Task * task)
+{
+    if (workerPool==this)
+    {
+        deques[workerIndex]->push(task);
+    } else
+    {
+        std::lock_guard<std::mutex> lock(injectLock);
+
+        injected.push_back(task);
+    }
+    queued.fetch_add(1);
+    if (sleepers.load()>0)
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+
+        wakeup.notify_one();
+    }
+}
+
+Task * ThreadPool::stealTask(int self)
+{
+    size_t count=deques.size();
+    size_t start=(self>=0) ? self+1 : 0;
+
+    for (size_t i=0;i<count;i++)
+    {
+        size_t victim=(start+i)%count;
+
+        if ((int) victim==self) continue;
+
+        Task * task=deques[victim]->steal();
+
+        if (task!=NULL) return task;
+    }
+    return NULL;
+}
+
+Task * ThreadPool::findTask(int self)
+{
+    Task * task=(self>=0) ? deques[self]->pop() : NULL;
+
+    if (task==NULL)
+    {
+        std::lock_guard<std::mutex> lock(injectLock);
+
+        if (!injected.empty())
+        {
+            task=injected.front();
+            injected.pop_front();
+        }
+    }
+    if (task==NULL) task=stealTask(self);
+    if (task!=NULL) queued.fetch_sub(1);
+    return task;
+}
+
+void ThreadPool::execute(Task * task)
+{
+    std::exception_ptr failure;
+    TaskGroup * group=task->group;
+
+    try
+    {
+        task->body();
+    } catch (...)
+    {
+        failure=std::current_exception();
+    }
+    delete task;
+    group->finish(failure);
+}
+
+bool ThreadPool::ownDequeEmpty()
+{
+    if (workerPool==this) return deques[workerIndex]->empty();
+
+    std::lock_guard<std::mutex> lock(injectLock);
+
+    return injected.empty();
+}
+
+void ThreadPool::workerLoop(int self)
+{
+    workerPool=this;
+    workerIndex=self;
+    while (!stopping.load())
+    {
+        Task * task=NULL;
+
+        for (int spin=0;spin<64&&task==NULL;spin++)
+        {
+            task=findTask(self);
+            if (task==NULL) std::this_thread::yield();
+        }
+        if (task!=NULL)
+        {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepLock);
+
+        sleepers.fetch_add(1);
+        while (!stopping.load()&&queued.load()==0) wakeup.wait(lock);
+        sleepers.fetch_sub(1);
+    }
+}
+
+/*
+ * Implementation notes: parallelFor
+ * ---------------------------------
+ * This is lazy binary splitting. The thread holding a range runs it grain indices at a time and,
+ * before each piece, splits off the upper half as a new task if its own deque is empty. A full deque
+ * means nobody has needed work since the last split, so balanced loops create only a few tasks per
+ * thread while skewed ones keep splitting where the work is.
+ */
+
+void ThreadPool::parallelFor(size_t begin,size_t end,const std::function<void(size_t,size_t)> & body,
+                             size_t grain)
+{
+    if (begin>=end) return;
+
+    size_t count=end-begin;
+
+    if (grain==0) grain=std::max<size_t>(1,count/(64*threads));
+    if (threads==1||count<=grain)
+    {
+        body(begin,end);
+        return;
+    }
+
+    std::function<void(size_t,size_t)> range;
+    TaskGroup group(*this);
+
+    range=[&](size_t first,size_t last)
+    {
+        while (last-first>grain)
+        {
+            if (ownDequeEmpty())
+            {
+                size_t middle=first+(last-first)/2;
+
+                group.run([&range,middle,last]() { range(middle,last); });
+                last=middle;
+            } else
+            {
+                body(first,first+grain);
+                first+=grain;
+            }
+        }
+        body(first,last);
+    };
+    range(begin,end);
+    group.wait();
+}
+
+TaskGroup::TaskGroup() : pool(ThreadPool::current()),pending(0)
+{}
+
+TaskGroup::TaskGroup(ThreadPool & pool) : pool(pool),pending(0)
+{}
+
+TaskGroup::~TaskGroup()
+{
+    join();
+}
+
+void TaskGroup::run(const std::function<void()> & task)
+{
+    pending.fetch_add(1,std::memory_order_relaxed);
+    pool.submit(new Task{task,this});
+}
+
+/*
+ * Implementation notes: finish and join
+ * -------------------------------------
+ * The last task to finish decrements pending while holding doneLock, and join takes doneLock once
+ * more before returning, so a group is never destroyed while a finishing task still touches it.
+ * A worker that joins runs other tasks, its own first, until the group is done; any other thread
+ * does the same but sleeps briefly when no task can be found.
+ */
+
+void TaskGroup::finish(std::exception_ptr failure)
+{
+    if (failure)
+    {
+        std::lock_guard<std::mutex> lock(errorLock);
+
+        if (!firstError) firstError=failure;
+    }
+
+    std::lock_guard<std::mutex> lock(doneLock);
+
+    if (pending.fetch_sub(1,std::memory_order_acq_rel)==1) done.notify_all();
+}
+
+void TaskGroup::join()
+{
+    int self=(workerPool==&pool) ? workerIndex : -1;
+
+    while (pending.load(std::memory_order_acquire)>0)
+    {
+        Task * task=pool.findTask(self);
+
+        if (task!=NULL)
+        {
+            pool.execute(task);
+        } else if (self>=0)
+        {
+            std::this_thread::yield();
+        } else
+        {
+            std::unique_lock<std::mutex> lock(doneLock);
+
+            done.wait_for(lock,std::chrono::microseconds(50),
+                          [this]() { return pending.load(std::memory_order_acquire)==0; });
+        }
+    }
+    std::lock_guard<std::mutex> lock(doneLock);
+}
+
+void TaskGroup::wait()
+{
+    std::exception_ptr failure;
+
+    join();
+    {
+        std::lock_guard<std::mutex> lock(errorLock);
+
+        failure=firstError;
+        firstError=NULL;
+    }
+    if (failure) std::rethrow_exception(failure);
+}
+
+void parallelFor(size_t begin,size_t end,const std::function<void(size_t,size_t)> & body,
+                 size_t grain)
+{
+    ThreadPool::current().parallelFor(begin,end,body,grain);
+}
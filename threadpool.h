@@ -0,0 +1,201 @@
+/*
+ * File: threadpool.h
+ * ------------------
+ * This interface exports a work-stealing thread pool shared by the parallel graph algorithms. Each
+ * worker owns a Chase-Lev deque: it pushes and pops tasks at one end while idle workers steal from
+ * the other, so load balances itself without a central queue. Waiting for a group of tasks never
+ * blocks a worker; the waiting thread runs other tasks until the group is done. Because nested
+ * parallel calls run on the pool of the calling worker, parallel algorithms compose without
+ * starting more threads than there are cores.
+ */
+
+#ifndef _threadpool_h
+#define _threadpool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+class WorkDeque;
+struct Task;
+
+/*
+ * Class: ThreadPool
+ * -----------------
+ * This class represents a set of worker threads. A pool of n threads starts n-1 workers, because
+ * the thread that waits for a TaskGroup works as well; a pool of one thread therefore runs
+ * everything on the caller.
+ */
+
+class ThreadPool
+{
+public:
+
+/*
+ * Constructor: ThreadPool
+ * Usage: ThreadPool pool(threads);
+ * --------------------------------
+ * Creates a pool with the given parallelism; 0 uses every hardware thread.
+ */
+
+    explicit ThreadPool(int threads=0);
+
+/*
+ * Destructor: ~ThreadPool
+ * Usage: (usually implicit)
+ * -------------------------
+ * Stops the workers. All task groups must have been waited for.
+ */
+
+    ~ThreadPool();
+
+/*
+ * Method: size
+ * Usage: int n=pool.size();
+ * -------------------------
+ * Returns the parallelism of the pool, counting the waiting thread.
+ */
+
+    int size() const;
+
+/*
+ * Method: parallelFor
+ * Usage: pool.parallelFor(begin,end,body);
+ *        pool.parallelFor(begin,end,body,grain);
+ * ----------------------------------------------
+ * Calls body(first,last) on disjoint subranges that together cover [begin,end) and returns when all
+ * calls have finished. Ranges are split lazily: a worker splits off half of its remaining range
+ * only while its own deque is empty, which means another worker has stolen from it, so the number
+ * of tasks adapts to the actual imbalance. Ranges are never split below grain indices; the default
+ * grain aims at about 64 pieces per thread.
+ */
+
+    void parallelFor(size_t begin,size_t end,const std::function<void(size_t,size_t)> & body,
+                     size_t grain=0);
+
+/*
+ * Static methods: shared, current, setSharedThreads
+ * Usage: ThreadPool & pool=ThreadPool::shared();
+ *        ThreadPool & pool=ThreadPool::current();
+ *        ThreadPool::setSharedThreads(threads);
+ * ----------------------------------------------
+ * shared returns the process-wide pool, which is created on first use. current returns the pool of
+ * the calling worker, or the shared pool if the caller is not a worker. setSharedThreads chooses
+ * the size of the shared pool and signals an error if the pool already exists with another size.
+ */
+
+    static ThreadPool & shared();
+    static ThreadPool & current();
+    static void setSharedThreads(int threads);
+
+private:
+    friend class TaskGroup;
+
+    int threads;
+    std::vector<WorkDeque *> deques;            /* One per worker */
+    std::vector<std::thread> workers;
+    std::mutex injectLock;
+    std::deque<Task *> injected;                /* Tasks submitted from outside the pool */
+    std::atomic<size_t> queued;                 /* Tasks pushed but not yet taken */
+    std::atomic<int> sleepers;
+    std::mutex sleepLock;
+    std::condition_variable wakeup;
+    std::atomic<bool> stopping;
+
+    void submit(Task * task);
+    Task * findTask(int self);
+    Task * stealTask(int self);
+    void execute(Task * task);
+    void workerLoop(int self);
+    bool ownDequeEmpty();
+
+    ThreadPool(const ThreadPool &);
+    ThreadPool & operator=(const ThreadPool &);
+};
+
+/*
+ * Class: TaskGroup
+ * ----------------
+ * This class implements fork/join parallelism. run starts a task on the pool; wait returns when every
+ * task of the group has finished, running other tasks in the meantime. If a task throws, wait
+ * rethrows the first exception after all tasks have finished.
+ */
+
+class TaskGroup
+{
+public:
+
+/*
+ * Constructor: TaskGroup
+ * Usage: TaskGroup group;
+ *        TaskGroup group(pool);
+ * -----------------------------
+ * Creates an empty group whose tasks run on pool, by default ThreadPool::current().
+ */
+
+    TaskGroup();
+    explicit TaskGroup(ThreadPool & pool);
+
+/*
+ * Destructor: ~TaskGroup
+ * Usage: (usually implicit)
+ * -------------------------
+ * Waits for the remaining tasks, discarding any exception.
+ */
+
+    ~TaskGroup();
+
+/*
+ * Method: run
+ * Usage: group.run(task);
+ * -----------------------
+ * Schedules task to run on the pool.
+ */
+
+    void run(const std::function<void()> & task);
+
+/*
+ * Method: wait
+ * Usage: group.wait();
+ * --------------------
+ * Returns when every task started with run, including tasks they started, has finished.
+ */
+
+    void wait();
+
+private:
+    friend class ThreadPool;
+
+    ThreadPool & pool;
+    std::atomic<size_t> pending;
+    std::mutex errorLock;
+    std::exception_ptr firstError;
+    std::mutex doneLock;
+    std::condition_variable done;
+
+    void finish(std::exception_ptr failure);
+    void join();
+
+    TaskGroup(const TaskGroup &);
+    TaskGroup & operator=(const TaskGroup &);
+};
+
+/*
+ * Function: parallelFor
+ * Usage: parallelFor(begin,end,body);
+ *        parallelFor(begin,end,body,grain);
+ * -----------------------------------------
+ * Runs ThreadPool::current().parallelFor(begin,end,body,grain).
+ */
+
+void parallelFor(size_t begin,size_t end,const std::function<void(size_t,size_t)> & body,
+                 size_t grain=0);
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ * File: tracing.cpp
+ * -----------------
+ * This file implements the tracing.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "error.h"
+#include "tracing.h"
+
+/*
+ * Implementation notes: ring buffers
+ * ----------------------------------
+ * Every thread appends spans to its own TraceBuffer, so recording a span costs two clock reads and a
+ * few relaxed stores with no lock and no shared cache line. The owning thread is the only writer: it
+ * fills the slot at position head and then publishes head+1 with a release store. An exporter reads
+ * head, copies the live slots and reads head again; any slot that the writer may have reused in the
+ * meantime, including the one it may be filling right now, is dropped. The slot fields are atomics
+ * so that this overlap is well defined. The mutex in the registry is taken only when a thread
+ * records its first span and when exporting.
+ */
+
+namespace
+{
+
+struct TraceSlot
+{
+    std::atomic<const char *> name;
+    std::atomic<int64_t> value;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> duration;
+};
+
+struct TraceBuffer
+{
+    std::unique_ptr<TraceSlot[]> slots;
+    size_t mask;
+    std::atomic<uint64_t> head;
+    int thread;
+
+    TraceBuffer(size_t capacity,int thread) : slots(new TraceSlot[capacity]),mask(capacity-1),
+        head(0),thread(thread) {}
+};
+
+struct TraceRegistry
+{
+    std::mutex lock;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    size_t capacity=65536;
+    int nextThread=1;
+};
+
+std::atomic<bool> enabled(false);
+
+TraceRegistry & registry()
+{
+    static TraceRegistry instance;
+
+    return instance;
+}
+
+thread_local std::shared_ptr<TraceBuffer> localBuffer;
+
+uint64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceBuffer & threadBuffer()
+{
+    if (!localBuffer)
+    {
+        TraceRegistry & reg=registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+
+        localBuffer=std::make_shared<TraceBuffer>(reg.capacity,reg.nextThread++);
+        reg.buffers.push_back(localBuffer);
+    }
+    return *localBuffer;
+}
+
+void writeMicroseconds(std::ostream & os,uint64_t ns)
+{
+    char fraction[4];
+
+    fraction[0]=(char) ('0'+ns/100%10);
+    fraction[1]=(char) ('0'+ns/10%10);
+    fraction[2]=(char) ('0'+ns%10);
+    fraction[3]='\0';
+    os<<ns/1000<<"."<<fraction;
+}
+
+void writeString(std::ostream & os,const char * str)
+{
+    os<<'"';
+    for (const char * cp=str;*cp!='\0';cp++)
+    {
+        if (*cp=='"'||*cp=='\\') os<<'\\';
+        os<<*cp;
+    }
+    os<<'"';
+}
+
+}
+
+void setTracingEnabled(bool on)
+{
+    enabled.store(on,std::memory_order_relaxed);
+}
+
+bool isTracingEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void setTraceBufferCapacity(size_t capacity)
+{
+    TraceRegistry & reg=registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    size_t rounded=1;
+
+    while (rounded<capacity) rounded*=2;
+    reg.capacity=rounded;
+}
+
+void clearTrace()
+{
+    TraceRegistry & reg=registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+
+    for (const std::shared_ptr<TraceBuffer> & buffer:reg.buffers)
+    {
+        buffer->head.store(0,std::memory_order_release);
+    }
+}
+
+TraceSpan::TraceSpan(const char * name,int64_t value) : name(name),value(value),start(0)
+{
+    if (enabled.load(std::memory_order_relaxed)) start=now();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (start==0) return;
+
+    uint64_t end=now();
+    TraceBuffer & buffer=threadBuffer();
+    uint64_t head=buffer.head.load(std::memory_order_relaxed);
+    TraceSlot & slot=buffer.slots[head&buffer.mask];
+
+    slot.name.store(name,std::memory_order_relaxed);
+    slot.value.store(value,std::memory_order_relaxed);
+    slot.start.store(start,std::memory_order_relaxed);
+    slot.duration.store(end-start,std::memory_order_relaxed);
+    buffer.head.store(head+1,std::memory_order_release);
+}
+
+/*
+ * Implementation notes: writeChromeTrace
+ * --------------------------------------
+ * Timestamps in the Chrome format are microseconds, so the nanosecond clock readings are written
+ * with three decimals. Times are made relative to the earliest exported span.
+ */
+
+void writeChromeTrace(std::ostream & os)
+{
+    struct Span
+    {
+        const char * name;
+        int64_t value;
+        uint64_t start;
+        uint64_t duration;
+        int thread;
+    };
+
+    TraceRegistry & reg=registry();
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    std::vector<Span> spans;
+    uint64_t origin=UINT64_MAX;
+
+    {
+        std::lock_guard<std::mutex> guard(reg.lock);
+
+        buffers=reg.buffers;
+    }
+    for (const std::shared_ptr<TraceBuffer> & buffer:buffers)
+    {
+        uint64_t capacity=buffer->mask+1;
+        uint64_t head=buffer->head.load(std::memory_order_acquire);
+        uint64_t first=(head>capacity) ? head-capacity : 0;
+        size_t mark=spans.size();
+
+        for (uint64_t i=first;i<head;i++)
+        {
+            TraceSlot & slot=buffer->slots[i&buffer->mask];
+            Span span;
+
+            span.name=slot.name.load(std::memory_order_relaxed);
+            span.value=slot.value.load(std::memory_order_relaxed);
+            span.start=slot.start.load(std::memory_order_relaxed);
+            span.duration=slot.duration.load(std::memory_order_relaxed);
+            span.thread=buffer->thread;
+            spans.push_back(span);
+        }
+
+        uint64_t after=buffer->head.load(std::memory_order_acquire);
+        uint64_t overwritten=(after+1>capacity) ? after+1-capacity : 0;
+
+        if (overwritten>first)
+        {
+            size_t drop=std::min<uint64_t>(overwritten-first,head-first);
+
+            spans.erase(spans.begin()+mark,spans.begin()+mark+drop);
+        }
+    }
+    for (const Span & span:spans)
+    {
+        if (span.start<origin) origin=span.start;
+    }
+    os<<"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (size_t i=0;i<buffers.size();i++)
+    {
+        if (i>0) os<<",";
+        os<<"\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"<<buffers[i]->thread
+          <<",\"args\":{\"name\":\"thread "<<buffers[i]->thread<<"\"}}";
+    }
+    for (const Span & span:spans)
+    {
+        os<<",\n{\"name\":";
+        writeString(os,span.name);
+        os<<",\"ph\":\"X\",\"pid\":1,\"tid\":"<<span.thread<<",\"ts\":";
+        writeMicroseconds(os,span.start-origin);
+        os<<",\"dur\":";
+        writeMicroseconds(os,span.duration);
+        if (span.value>=0) os<<",\"args\":{\"value\":"<<span.value<<"}";
+        os<<"}";
+    }
+    os<<"\n]}"<<std::endl;
+}
+
+void saveChromeTrace(const std::string & filename)
+{
+    std::ofstream out(filename.c_str());
+
+    if (!out) error("saveChromeTrace: can't open " + filename);
+    writeChromeTrace(out);
+    if (!out) error("saveChromeTrace: write failed for " + filename);
+}
@@ -0,0 +1,111 @@
+/*
+ * File: tracing.h
+ * ---------------
+ * This interface exports lightweight scoped tracing spans for the graph engines. Each thread records
+ * its spans in its own fixed-size ring buffer without locking, and the collected spans can be written
+ * on demand in the Chrome trace event format, which chrome://tracing and Perfetto display as a
+ * timeline. Spans are compiled in only when GRAPH_TRACING is defined, and recorded only while tracing
+ * is enabled at run time.
+ */
+
+#ifndef _tracing_h
+#define _tracing_h
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/*
+ * Function: setTracingEnabled
+ * Usage: setTracingEnabled(true);
+ * -------------------------------
+ * Starts or stops the recording of spans. Tracing is initially disabled.
+ */
+
+void setTracingEnabled(bool enabled);
+
+/*
+ * Function: isTracingEnabled
+ * Usage: if (isTracingEnabled()) . . .
+ * ------------------------------------
+ * Returns true if spans are currently being recorded.
+ */
+
+bool isTracingEnabled();
+
+/*
+ * Function: setTraceBufferCapacity
+ * Usage: setTraceBufferCapacity(capacity);
+ * ----------------------------------------
+ * Sets the number of spans kept per thread, rounded up to a power of two. When a buffer is full, the
+ * oldest spans are overwritten. The capacity applies to threads that record their first span after
+ * the call; the default is 65536.
+ */
+
+void setTraceBufferCapacity(size_t capacity);
+
+/*
+ * Function: clearTrace
+ * Usage: clearTrace();
+ * --------------------
+ * Discards all recorded spans. It should be called while no thread is recording.
+ */
+
+void clearTrace();
+
+/*
+ * Function: writeChromeTrace
+ * Usage: writeChromeTrace(os);
+ *        saveChromeTrace(filename);
+ * -----------------------------------
+ * Writes every recorded span as a complete ("X") event of the Chrome trace JSON format, together with
+ * one thread name record per recording thread. Spans that are overwritten while the export runs are
+ * left out. saveChromeTrace signals an error if the file cannot be written.
+ */
+
+void writeChromeTrace(std::ostream & os);
+void saveChromeTrace(const std::string & filename);
+
+/*
+ * Class: TraceSpan
+ * ----------------
+ * Records one span from its construction to its destruction. The name must be a string literal or
+ * otherwise outlive the export, and value is an optional number shown with the span (for example the
+ * size of a BFS frontier). Clients normally use the TRACE_SCOPE macros instead.
+ */
+
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char * name,int64_t value=-1);
+    ~TraceSpan();
+
+private:
+    const char * name;
+    int64_t value;
+    uint64_t start;
+
+    TraceSpan(const TraceSpan &);
+    TraceSpan & operator=(const TraceSpan &);
+};
+
+/*
+ * Macros: TRACE_SCOPE, TRACE_SCOPE_VALUE
+ * --------------------------------------
+ * TRACE_SCOPE(name) traces the rest of the enclosing block, and TRACE_SCOPE_VALUE(name,value) also
+ * attaches a number to the span. Both compile to nothing unless GRAPH_TRACING is defined.
+ */
+
+#define TRACE_CONCAT_(a,b) a##b
+#define TRACE_NAME_(line) TRACE_CONCAT_(traceSpan_,line)
+
+#ifdef GRAPH_TRACING
+#define TRACE_SCOPE(name) TraceSpan TRACE_NAME_(__LINE__)((name))
+#define TRACE_SCOPE_VALUE(name,value) TraceSpan TRACE_NAME_(__LINE__)((name),(int64_t) (value))
+#else
+#define TRACE_SCOPE(name) ((void) 0)
+#define TRACE_SCOPE_VALUE(name,value) ((void) 0)
+#endif
+
+#endif
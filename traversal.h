@@ -0,0 +1,103 @@
+/*
+ * File: traversal.h
+ * -----------------
+ * This interface exports the graph traversal functions implemented in QueueBFS.cpp and StackDFS.cpp.
+ */
+
+#ifndef _traversal_h
+#define _traversal_h
+
+#include <vector>
+#include "graphtypes.h"
+#include "csrgraph.h"
+#include "perfstats.h"
+#include "searchbudget.h"
+
+/*
+ * Function: breadthFirstSearch
+ * Usage: breadthFirstSearch(start);
+ *        size_t arcs=breadthFirstSearch(csr,start,parent);
+ * --------------------------------------------------------
+ * Visits every node reachable from start in breadth-first order. The first form prints the name of
+ * each node as it is visited. The second form works on a CSRGraph, fills parent with the node from
+ * which each node was discovered (NO_NODE if unreached, start for start itself) and returns the
+ * number of arcs examined. If stats is not NULL and the program is compiled with GRAPH_INSTRUMENT,
+ * the counters of the call are added to it. If budget is not NULL, the search stops early when the
+ * budget runs out; budget->status() then tells why, and the result covers the nodes reached so far.
+ */
+
+void breadthFirstSearch(Node * start,PerfStats * stats=NULL,SearchBudget * budget=NULL);
+size_t breadthFirstSearch(const CSRGraph & graph,uint32_t start,std::vector<uint32_t> & parent,
+                          PerfStats * stats=NULL,SearchBudget * budget=NULL);
+
+/*
+ * Function: parallelBreadthFirstSearch
+ * Usage: size_t arcs=parallelBreadthFirstSearch(csr,start,parent);
+ * ----------------------------------------------------------------
+ * Works like the CSR form of breadthFirstSearch but expands each level on the threads of the current
+ * thread pool. The parent array describes a breadth-first tree, though not necessarily the one the
+ * sequential search finds. Hardware counters in stats cover only the calling thread.
+ */
+
+size_t parallelBreadthFirstSearch(const CSRGraph & graph,uint32_t start,
+                                  std::vector<uint32_t> & parent,PerfStats * stats=NULL,
+                                  SearchBudget * budget=NULL);
+
+/*
+ * Function: pipelinedBreadthFirstSearch
+ * Usage: size_t arcs=pipelinedBreadthFirstSearch(csr,start,parent);
+ * -----------------------------------------------------------------
+ * Works like parallelBreadthFirstSearch, but the threads exchange frontier nodes through lock-free
+ * MPMCQueues in batches instead of partitioning an array.
+ */
+
+size_t pipelinedBreadthFirstSearch(const CSRGraph & graph,uint32_t start,
+                                   std::vector<uint32_t> & parent,PerfStats * stats=NULL,
+                                   SearchBudget * budget=NULL);
+
+/*
+ * Function: multiSourceBFS
+ * Usage: multiSourceBFS(csr,sources,targets,hops);
+ *        multiSourceBFS(csr,sources,targets,hops,&budget,&statuses);
+ * ------------------------------------------------------------------
+ * Answers a batch of hop-distance queries with shared breadth-first searches. On return hops[i] is
+ * the number of arcs on the shortest path from sources[i] to targets[i], or -1 if there is none.
+ * If the budget runs out, the queries not yet answered are left at -1, and statuses, if not NULL,
+ * tells them apart from unreachable targets: it receives SEARCH_COMPLETE for every query that was
+ * answered and the budget status for those that were not.
+ */
+
+void multiSourceBFS(const CSRGraph & graph,const std::vector<uint32_t> & sources,
+                    const std::vector<uint32_t> & targets,std::vector<int> & hops,
+                    SearchBudget * budget=NULL,std::vector<SearchStatus> * statuses=NULL);
+
+/*
+ * Function: breadthFirstLevels
+ * Usage: uint32_t eccentricity=breadthFirstLevels(csr,start,distance,order,levels);
+ * --------------------------------------------------------------------------------
+ * Runs a level-synchronous breadth-first search from start and returns the distance of the farthest
+ * node reached. On return distance[v] is the number of arcs from start to v, or NO_NODE if v was
+ * not reached; order lists the reached nodes by distance, and the nodes at distance d occupy
+ * positions levels[d] up to levels[d+1] of order. The arrays may be reused from call to call. The
+ * stats and budget parameters work as for breadthFirstSearch; a search stopped early returns the
+ * distance of the farthest node it reached, and its deepest level may be incomplete.
+ */
+
+uint32_t breadthFirstLevels(const CSRGraph & graph,uint32_t start,std::vector<uint32_t> & distance,
+                            std::vector<uint32_t> & order,std::vector<size_t> & levels,
+                            PerfStats * stats=NULL,SearchBudget * budget=NULL);
+
+/*
+ * Function: depthFirstSearch
+ * Usage: depthFirstSearch(start);
+ *        size_t arcs=depthFirstSearch(csr,start,parent);
+ * ------------------------------------------------------
+ * Visits every node reachable from start using an explicit stack. The two forms mirror those of
+ * breadthFirstSearch.
+ */
+
+void depthFirstSearch(Node * start,PerfStats * stats=NULL,SearchBudget * budget=NULL);
+size_t depthFirstSearch(const CSRGraph & graph,uint32_t start,std::vector<uint32_t> & parent,
+                        PerfStats * stats=NULL,SearchBudget * budget=NULL);
+
+#endif
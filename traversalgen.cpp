@@ -0,0 +1,268 @@
+/*
+ * File: traversalgen.cpp
+ * ----------------------
+ * This file implements the traversalgen.h interface.
+ */
+
+#include <algorithm>
+#include <new>
+#include <utility>
+#include "error.h"
+#include "traversalgen.h"
+
+TraversalState::TraversalState() : epoch(0)
+{}
+
+void TraversalState::reset(size_t nodeCount)
+{
+    pending.clear();
+    if (stamp.size()<nodeCount) stamp.resize(nodeCount,0);
+    if (++epoch==0)
+    {
+        std::fill(stamp.begin(),stamp.end(),0);
+        epoch=1;
+    }
+}
+
+TraversalStatePool::TraversalStatePool(size_t capacity) : capacity(capacity)
+{}
+
+TraversalStatePool::~TraversalStatePool()
+{
+    for (TraversalState * state:idle) delete state;
+}
+
+TraversalState * TraversalStatePool::acquire()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (idle.empty()) return new TraversalState;
+
+    TraversalState * state=idle.back();
+
+    idle.pop_back();
+    return state;
+}
+
+void TraversalStatePool::release(TraversalState * state)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (idle.size()<capacity) idle.push_back(state);
+    else delete state;
+}
+
+TraversalStatePool & TraversalStatePool::shared()
+{
+    static TraversalStatePool pool;
+
+    return pool;
+}
+
+/*
+ * Implementation notes: coroutine frames
+ * --------------------------------------
+ * The compiler allocates the frame of each traversal coroutine through promise_type. Frames of all
+ * traversals have one of two sizes, so each thread keeps a short list of freed frames per size and
+ * hands them out again, which makes starting a traversal free of heap allocation in the steady state.
+ */
+
+class FrameCache
+{
+public:
+    ~FrameCache()
+    {
+        for (Entry & entry:entries) ::operator delete(entry.frame);
+    }
+
+    void * allocate(size_t size)
+    {
+        for (size_t i=entries.size();i-->0;)
+        {
+            if (entries[i].size==size)
+            {
+                void * frame=entries[i].frame;
+
+                entries[i]=entries.back();
+                entries.pop_back();
+                return frame;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void free(void * frame,size_t size)
+    {
+        if (entries.size()<MAX_ENTRIES) entries.push_back(Entry{frame,size});
+        else ::operator delete(frame);
+    }
+
+private:
+    static const size_t MAX_ENTRIES=16;
+
+    struct Entry
+    {
+        void * frame;
+        size_t size;
+    };
+
+    std::vector<Entry> entries;
+};
+
+static thread_local FrameCache frameCache;
+
+void * TraversalGenerator::promise_type::operator new(size_t size)
+{
+    return frameCache.allocate(size);
+}
+
+void TraversalGenerator::promise_type::operator delete(void * frame,size_t size)
+{
+    frameCache.free(frame,size);
+}
+
+TraversalGenerator::TraversalGenerator(TraversalGenerator && other) noexcept : handle(other.handle)
+{
+    other.handle=NULL;
+}
+
+TraversalGenerator & TraversalGenerator::operator=(TraversalGenerator && other) noexcept
+{
+    if (this!=&other)
+    {
+        if (handle) handle.destroy();
+        handle=other.handle;
+        other.handle=NULL;
+    }
+    return *this;
+}
+
+TraversalGenerator::~TraversalGenerator()
+{
+    if (handle) handle.destroy();
+}
+
+bool TraversalGenerator::next()
+{
+    if (!handle||handle.done()) return false;
+    handle.resume();
+    return !handle.done();
+}
+
+const TraversalStep & TraversalGenerator::current() const
+{
+    return handle.promise().step;
+}
+
+TraversalGenerator::iterator TraversalGenerator::begin()
+{
+    return iterator(next() ? this : NULL);
+}
+
+TraversalGenerator::iterator TraversalGenerator::end()
+{
+    return iterator(NULL);
+}
+
+/*
+ * Class: StateLease
+ * -----------------
+ * Borrows a TraversalState for the lifetime of a coroutine body. Because the lease is a local of the
+ * coroutine, destroying a suspended generator returns the state to its pool as well.
+ */
+
+class StateLease
+{
+public:
+    StateLease(TraversalStatePool & pool,size_t nodeCount) : pool(pool),state(pool.acquire())
+    {
+        state->reset(nodeCount);
+    }
+
+    ~StateLease()
+    {
+        pool.release(state);
+    }
+
+    TraversalState & operator*() const
+    {
+        return *state;
+    }
+
+private:
+    TraversalStatePool & pool;
+    TraversalState * state;
+
+    StateLease(const StateLease &);
+    StateLease & operator=(const StateLease &);
+};
+
+/*
+ * Implementation notes: breadthFirstTraversal and depthFirstTraversal
+ * -------------------------------------------------------------------
+ * Both coroutines mark a node when it is discovered and yield it when it leaves the pending list,
+ * exactly as the CSR searches in QueueBFS.cpp and StackDFS.cpp do. The breadth-first version reads
+ * the list as a queue from a moving head; the depth-first version uses it as a stack. A budget
+ * that runs out ends the sequence after the node just produced.
+ */
+
+TraversalGenerator breadthFirstTraversal(const CSRGraph & graph,uint32_t start,
+                                         TraversalStatePool & pool,SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("breadthFirstTraversal: start node out of range");
+
+    StateLease lease(pool,graph.nodeCount);
+    TraversalState & state=*lease;
+    BudgetMeter meter(budget);
+
+    state.markVisited(start);
+    state.pending.push_back(TraversalStep{start,0,NO_NODE});
+    for (size_t head=0;head<state.pending.size();head++)
+    {
+        TraversalStep step=state.pending[head];
+
+        for (size_t i=graph.offsets[step.node];i<graph.offsets[step.node+1];i++)
+        {
+            uint32_t link=graph.targets[i];
+
+            if (!state.isVisited(link))
+            {
+                state.markVisited(link);
+                state.pending.push_back(TraversalStep{link,step.depth+1,step.node});
+            }
+        }
+        co_yield step;
+        if (!meter.tick(1+graph.degree(step.node))) break;
+    }
+}
+
+TraversalGenerator depthFirstTraversal(const CSRGraph & graph,uint32_t start,
+                                       TraversalStatePool & pool,SearchBudget * budget)
+{
+    if (start>=graph.nodeCount) error("depthFirstTraversal: start node out of range");
+
+    StateLease lease(pool,graph.nodeCount);
+    TraversalState & state=*lease;
+    BudgetMeter meter(budget);
+
+    state.markVisited(start);
+    state.pending.push_back(TraversalStep{start,0,NO_NODE});
+    while (!state.pending.empty())
+    {
+        TraversalStep step=state.pending.back();
+
+        state.pending.pop_back();
+        for (size_t i=graph.offsets[step.node];i<graph.offsets[step.node+1];i++)
+        {
+            uint32_t link=graph.targets[i];
+
+            if (!state.isVisited(link))
+            {
+                state.markVisited(link);
+                state.pending.push_back(TraversalStep{link,step.depth+1,step.node});
+            }
+        }
+        co_yield step;
+        if (!meter.tick(1+graph.degree(step.node))) break;
+    }
+}
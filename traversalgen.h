@@ -0,0 +1,248 @@
+/*
+ * File: traversalgen.h
+ * --------------------
+ * This interface exports incremental versions of breadth-first and depth-first search, written as
+ * C++20 coroutines. Instead of running to completion, a traversal produces one node each time the
+ * caller asks for it, so the caller can interleave the search with other work, stop after a number
+ * of nodes, or abandon the search altogether simply by destroying the generator. The queue or stack
+ * and the visited marks live in a TraversalState borrowed from a pool and returned when the search
+ * ends, so starting many short searches does not allocate. This header must be compiled as C++20.
+ *
+ * Usage: for (const TraversalStep & step:breadthFirstTraversal(csr,start)) . . .
+ */
+
+#ifndef _traversalgen_h
+#define _traversalgen_h
+
+#if !defined(__cpp_impl_coroutine)
+#error "traversalgen.h requires C++20 coroutine support"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "csrgraph.h"
+#include "searchbudget.h"
+
+/*
+ * Type: TraversalStep
+ * -------------------
+ * One visited node, the number of arcs on the path by which the search reached it, and the node that
+ * path came from (NO_NODE for the start node).
+ */
+
+struct TraversalStep
+{
+    uint32_t node;
+    uint32_t depth;
+    uint32_t parent;
+};
+
+/*
+ * Class: TraversalState
+ * ---------------------
+ * This class holds the working storage of one traversal: the pending steps and the visited marks.
+ * Marks are stamped with the number of the current search rather than cleared, so a state can be
+ * reused for a new search in time proportional to the nodes that search visits.
+ */
+
+class TraversalState
+{
+public:
+    TraversalState();
+
+/*
+ * Method: reset
+ * Usage: state.reset(nodeCount);
+ * ------------------------------
+ * Prepares the state for a new search of a graph with nodeCount nodes.
+ */
+
+    void reset(size_t nodeCount);
+
+/*
+ * Methods: isVisited, markVisited
+ * Usage: if (!state.isVisited(v)) state.markVisited(v);
+ * -----------------------------------------------------
+ * Test and set the visited mark of node v in the current search.
+ */
+
+    bool isVisited(uint32_t v) const
+    {
+        return stamp[v]==epoch;
+    }
+
+    void markVisited(uint32_t v)
+    {
+        stamp[v]=epoch;
+    }
+
+    std::vector<TraversalStep> pending;         /* Queue or stack of discovered nodes */
+
+private:
+    std::vector<uint32_t> stamp;
+    uint32_t epoch;
+};
+
+/*
+ * Class: TraversalStatePool
+ * -------------------------
+ * This class keeps idle TraversalStates for reuse. It is safe to use from several threads.
+ */
+
+class TraversalStatePool
+{
+public:
+
+/*
+ * Constructor: TraversalStatePool
+ * Usage: TraversalStatePool pool(capacity);
+ * -----------------------------------------
+ * Creates an empty pool that keeps at most capacity idle states; more are freed on release.
+ */
+
+    explicit TraversalStatePool(size_t capacity=16);
+    ~TraversalStatePool();
+
+/*
+ * Methods: acquire, release
+ * Usage: TraversalState * state=pool.acquire();
+ *        pool.release(state);
+ * ---------------------------------------------
+ * acquire hands out an idle state, or a new one if none is idle; release gives it back.
+ */
+
+    TraversalState * acquire();
+    void release(TraversalState * state);
+
+/*
+ * Static method: shared
+ * Usage: TraversalStatePool & pool=TraversalStatePool::shared();
+ * --------------------------------------------------------------
+ * Returns the pool used when a traversal is started without one.
+ */
+
+    static TraversalStatePool & shared();
+
+private:
+    size_t capacity;
+    std::mutex lock;
+    std::vector<TraversalState *> idle;
+
+    TraversalStatePool(const TraversalStatePool &);
+    TraversalStatePool & operator=(const TraversalStatePool &);
+};
+
+/*
+ * Class: TraversalGenerator
+ * -------------------------
+ * This class is the handle of a running traversal. Each call of next resumes the search until it
+ * reaches another node; current then describes that node. The generator can also be used in a
+ * range-based for loop. Destroying the generator stops the search and returns its state to the pool.
+ * A generator may be moved but not copied, and must not outlive the graph it traverses.
+ */
+
+class TraversalGenerator
+{
+public:
+    struct promise_type
+    {
+        TraversalStep step;
+
+        TraversalGenerator get_return_object()
+        {
+            return TraversalGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+        std::suspend_always final_suspend() noexcept { return std::suspend_always(); }
+
+        std::suspend_always yield_value(const TraversalStep & value)
+        {
+            step=value;
+            return std::suspend_always();
+        }
+
+        void return_void() {}
+        void unhandled_exception() { throw; }
+
+        static void * operator new(size_t size);
+        static void operator delete(void * frame,size_t size);
+    };
+
+    class iterator
+    {
+    public:
+        explicit iterator(TraversalGenerator * generator) : generator(generator) {}
+
+        const TraversalStep & operator*() const { return generator->current(); }
+        const TraversalStep * operator->() const { return &generator->current(); }
+
+        iterator & operator++()
+        {
+            if (!generator->next()) generator=NULL;
+            return *this;
+        }
+
+        bool operator==(const iterator & other) const { return generator==other.generator; }
+        bool operator!=(const iterator & other) const { return generator!=other.generator; }
+
+    private:
+        TraversalGenerator * generator;
+    };
+
+    TraversalGenerator(TraversalGenerator && other) noexcept;
+    TraversalGenerator & operator=(TraversalGenerator && other) noexcept;
+    ~TraversalGenerator();
+
+/*
+ * Method: next
+ * Usage: while (search.next()) . . .
+ * ----------------------------------
+ * Advances the search to the next node and returns true, or returns false if the search is over.
+ */
+
+    bool next();
+
+/*
+ * Method: current
+ * Usage: const TraversalStep & step=search.current();
+ * ---------------------------------------------------
+ * Returns the node reached by the last successful call of next.
+ */
+
+    const TraversalStep & current() const;
+
+    iterator begin();
+    iterator end();
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit TraversalGenerator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    TraversalGenerator(const TraversalGenerator &) = delete;
+    TraversalGenerator & operator=(const TraversalGenerator &) = delete;
+};
+
+/*
+ * Functions: breadthFirstTraversal, depthFirstTraversal
+ * Usage: TraversalGenerator search=breadthFirstTraversal(csr,start);
+ *        TraversalGenerator search=depthFirstTraversal(csr,start,pool);
+ * ------------------------------------------------------------------
+ * Return generators that visit every node reachable from start in the same order as the CSR forms
+ * of breadthFirstSearch and depthFirstSearch. No work is done until the first call of next, which
+ * also signals the error if start is out of range. If budget is not NULL, the sequence ends early
+ * when the budget runs out.
+ */
+
+TraversalGenerator breadthFirstTraversal(const CSRGraph & graph,uint32_t start,
+                                         TraversalStatePool & pool=TraversalStatePool::shared(),
+                                         SearchBudget * budget=NULL);
+TraversalGenerator depthFirstTraversal(const CSRGraph & graph,uint32_t start,
+                                       TraversalStatePool & pool=TraversalStatePool::shared(),
+                                       SearchBudget * budget=NULL);
+
+#endif
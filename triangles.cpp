@@ -0,0 +1,258 @@
+/*
+ * File: triangles.cpp
+ * -------------------
+ * This file implements the triangles.h interface.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "blockmatch.h"
+#include "threadpool.h"
+#include "tracing.h"
+#include "triangles.h"
+
+/*
+ * Constant: HUB_DEGREE
+ * --------------------
+ * Nodes with at least this many oriented neighbors are intersected through a marker array instead
+ * of by merging, since their list would otherwise be scanned once for every neighbor.
+ */
+
+const size_t HUB_DEGREE=64;
+
+typedef std::atomic<uint64_t> Counter;
+
+/*
+ * Implementation notes: orientation
+ * ---------------------------------
+ * Every triangle is counted once, at its lowest node in the order that ranks nodes by degree and
+ * breaks ties by index. Keeping only the arcs that lead up in this order leaves each node with at
+ * most about sqrt(2m) neighbors, so even the hubs of a skewed graph have short lists. The oriented
+ * rows keep the order of the original rows and therefore stay sorted by index. upperNeighbors
+ * counts the arcs of v that are kept, and also writes them if into is not NULL; self-loops and
+ * repeated targets are skipped.
+ */
+
+static bool precedes(const std::vector<uint32_t> & degree,uint32_t u,uint32_t v)
+{
+    return degree[u]<degree[v]||(degree[u]==degree[v]&&u<v);
+}
+
+static size_t upperNeighbors(const CSRGraph & graph,const std::vector<uint32_t> & degree,uint32_t v,
+                             uint32_t * into)
+{
+    size_t count=0;
+    uint32_t last=NO_NODE;
+
+    for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+    {
+        uint32_t t=graph.targets[i];
+
+        if (t==last||t==v) continue;
+        last=t;
+        if (!precedes(degree,v,t)) continue;
+        if (into!=NULL) into[count]=t;
+        count++;
+    }
+    return count;
+}
+
+static void orient(ThreadPool & pool,const CSRGraph & graph,std::vector<uint32_t> & degree,
+                   CSRGraph & oriented)
+{
+    TRACE_SCOPE("triangles.orient");
+    size_t n=graph.nodeCount;
+
+    degree.assign(n,0);
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            uint32_t previous=NO_NODE;
+
+            for (size_t i=graph.offsets[v];i<graph.offsets[v+1];i++)
+            {
+                uint32_t t=graph.targets[i];
+
+                if (t!=previous&&t!=v) degree[v]++;
+                previous=t;
+            }
+        }
+    },4096);
+    oriented=CSRGraph();
+    oriented.nodeCount=n;
+    oriented.offsets.assign(n+1,0);
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            oriented.offsets[v+1]=upperNeighbors(graph,degree,(uint32_t) v,NULL);
+        }
+    },4096);
+    for (size_t v=0;v<n;v++)
+    {
+        oriented.offsets[v+1]+=oriented.offsets[v];
+    }
+    oriented.targets.resize(oriented.offsets[n]);
+    pool.parallelFor(0,n,[&](size_t first,size_t last)
+    {
+        for (size_t v=first;v<last;v++)
+        {
+            upperNeighbors(graph,degree,(uint32_t) v,oriented.targets.data()+oriented.offsets[v]);
+        }
+    },4096);
+}
+
+/*
+ * Implementation notes: intersect
+ * -------------------------------
+ * Returns the number of entries the sorted lists x and y have in common and credits a triangle to
+ * each of them. The SSE2 version compares blocks of four with matchBlocks, whose mask tells which
+ * entries of x have a partner in the block of y. The block with the smaller last entry is replaced,
+ * or both if the last entries are equal. Fewer than four remaining entries in either list are
+ * finished by the ordinary merge, which is also the whole algorithm on other processors.
+ */
+
+static size_t intersect(const uint32_t * x,size_t nx,const uint32_t * y,size_t ny,Counter * count)
+{
+    size_t i=0,j=0;
+    size_t common=0;
+
+#ifdef __SSE2__
+    while (i+4<=nx&&j+4<=ny)
+    {
+        int mask=matchBlocks(x+i,y+j);
+
+        for (int k=0;k<4;k++)
+        {
+            if (mask&(1<<k))
+            {
+                count[x[i+k]].fetch_add(1,std::memory_order_relaxed);
+                common++;
+            }
+        }
+
+        uint32_t lastX=x[i+3];
+        uint32_t lastY=y[j+3];
+
+        if (lastX<=lastY) i+=4;
+        if (lastY<=lastX) j+=4;
+    }
+#endif
+    while (i<nx&&j<ny)
+    {
+        if (x[i]==y[j])
+        {
+            count[x[i]].fetch_add(1,std::memory_order_relaxed);
+            common++;
+            i++;
+            j++;
+        } else if (x[i]<y[j])
+        {
+            i++;
+        } else
+        {
+            j++;
+        }
+    }
+    return common;
+}
+
+/*
+ * Implementation notes: countTriangles
+ * ------------------------------------
+ * Each node u looks for the triangles it is lowest in by intersecting its oriented list with that
+ * of every neighbor v. A triangle u,v,w is credited to u in one local sum, to v once per arc and to
+ * w per match, the last two with relaxed atomic additions. If u is a hub, its list is marked once in
+ * a per-thread stamp array, which acts as a hash set with one slot per node, and every neighbor's
+ * list is then checked against the marks, so u's long list is read only once.
+ */
+
+void countTriangles(const CSRGraph & graph,TriangleCounts & counts,bool symmetric)
+{
+    TRACE_SCOPE("countTriangles");
+    ThreadPool & pool=ThreadPool::current();
+    size_t n=graph.nodeCount;
+    CSRGraph undirected;
+    CSRGraph oriented;
+    std::vector<uint32_t> degree;
+    std::unique_ptr<Counter[]> count(new Counter[n]);
+
+    if (!symmetric) symmetrizeCSR(graph,undirected);
+    orient(pool,symmetric ? graph : undirected,degree,oriented);
+    for (size_t v=0;v<n;v++)
+    {
+        count[v].store(0,std::memory_order_relaxed);
+    }
+    {
+        TRACE_SCOPE_VALUE("triangles.count",oriented.arcCount());
+        pool.parallelFor(0,n,[&](size_t first,size_t last)
+        {
+            thread_local std::vector<uint32_t> stamp;
+            thread_local uint32_t epoch=0;
+
+            for (size_t u=first;u<last;u++)
+            {
+                const uint32_t * a=oriented.targets.data()+oriented.offsets[u];
+                size_t na=oriented.degree(u);
+                uint64_t own=0;
+
+                if (na>=HUB_DEGREE)
+                {
+                    if (stamp.size()<n) stamp.resize(n,0);
+                    if (++epoch==0)
+                    {
+                        std::fill(stamp.begin(),stamp.end(),0);
+                        epoch=1;
+                    }
+                    for (size_t k=0;k<na;k++) stamp[a[k]]=epoch;
+                }
+                for (size_t k=0;k<na;k++)
+                {
+                    uint32_t v=a[k];
+                    const uint32_t * b=oriented.targets.data()+oriented.offsets[v];
+                    size_t nb=oriented.degree(v);
+                    size_t common=0;
+
+                    if (na>=HUB_DEGREE)
+                    {
+                        for (size_t l=0;l<nb;l++)
+                        {
+                            if (stamp[b[l]]!=epoch) continue;
+                            count[b[l]].fetch_add(1,std::memory_order_relaxed);
+                            common++;
+                        }
+                    } else
+                    {
+                        common=intersect(a,na,b,nb,count.get());
+                    }
+                    if (common>0) count[v].fetch_add(common,std::memory_order_relaxed);
+                    own+=common;
+                }
+                if (own>0) count[u].fetch_add(own,std::memory_order_relaxed);
+            }
+        },256);
+    }
+
+    uint64_t total=0;
+    double wedges=0;
+    double sum=0;
+
+    counts.perNode.resize(n);
+    counts.local.resize(n);
+    for (size_t v=0;v<n;v++)
+    {
+        double d=degree[v];
+        double pairs=d*(d-1)/2;
+
+        counts.perNode[v]=count[v].load(std::memory_order_relaxed);
+        counts.local[v]=(degree[v]<2) ? 0 : counts.perNode[v]/pairs;
+        total+=counts.perNode[v];
+        wedges+=pairs;
+        sum+=counts.local[v];
+    }
+    counts.total=total/3;
+    counts.global=(wedges>0) ? 3*counts.total/wedges : 0;
+    counts.average=(n>0) ? sum/n : 0;
+}
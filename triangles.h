@@ -0,0 +1,49 @@
+/*
+ * File: triangles.h
+ * -----------------
+ * This interface exports a parallel triangle counter for graphs in CSR form, together with the
+ * clustering coefficients derived from the counts. Arcs are treated as undirected edges.
+ */
+
+#ifndef _triangles_h
+#define _triangles_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "csrgraph.h"
+
+/*
+ * Type: TriangleCounts
+ * --------------------
+ * This type holds the result of countTriangles. The global coefficient (transitivity) is three
+ * times the number of triangles divided by the number of paths of length two; the local coefficient
+ * of a node is the fraction of pairs of its neighbors that are adjacent, and 0 for nodes with fewer
+ * than two neighbors. The average is taken over all nodes.
+ */
+
+struct TriangleCounts
+{
+    uint64_t total;                             /* Number of triangles in the graph */
+    std::vector<uint64_t> perNode;              /* Triangles containing each node */
+    std::vector<double> local;                  /* Local clustering coefficient of each node */
+    double global;                              /* Global clustering coefficient */
+    double average;                             /* Mean of the local coefficients */
+
+    TriangleCounts() : total(0),global(0),average(0) {}
+};
+
+/*
+ * Function: countTriangles
+ * Usage: countTriangles(csr,counts);
+ *        countTriangles(csr,counts,true);
+ * ---------------------------------------
+ * Counts the triangles of the simple undirected graph underlying csr, in total and per node, and
+ * fills in the clustering coefficients. Self-loops and parallel arcs are ignored. If symmetric is
+ * true, the caller promises that every arc u->v is matched by an arc v->u, which saves building the
+ * undirected graph. The work runs on the current thread pool.
+ */
+
+void countTriangles(const CSRGraph & graph,TriangleCounts & counts,bool symmetric=false);
+
+#endif